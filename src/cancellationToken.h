@@ -0,0 +1,45 @@
+/**
+* \file cancellationToken.h
+* Priznak zruseni vypoctu sdileny mezi vlakny.
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef CANCELLATIONTOKEN_H_INCLUDED
+#define CANCELLATIONTOKEN_H_INCLUDED
+
+#include <QAtomicInt>
+
+/**
+ * Priznak zruseni vypoctu. Nastavuje jej ridici vlakno (GUI), vlakna vypoctu se na nej
+ * dotazuji bez zamku, a to i uvnitr dlouho bezicich operatoru, ktere se pak predcasne ukonci.
+ * Dotaz je jedine atomicke cteni, takze jej lze volat i ve vnitrnich smyckach.
+ */
+class CancellationToken
+{
+    private:
+    QAtomicInt cancelled;   ///< Nenulova hodnota znamena pozadavek na zruseni.
+
+    public:
+    /**
+    * Konstruktor.
+    */
+    CancellationToken() : cancelled(0) {}
+
+    /**
+     * Vyzada zruseni vypoctu (lze volat z libovolneho vlakna, nikdy neceka).
+     */
+    void Cancel() { cancelled.fetchAndStoreRelease(1); }
+
+    /**
+     * Zrusi pozadavek na zruseni (pred spustenim noveho vypoctu).
+     */
+    void Reset() { cancelled.fetchAndStoreRelease(0); }
+
+    /**
+     * Overi, zda-li bylo vyzadano zruseni vypoctu.
+     * @return True, pokud bylo vyzadano zruseni.
+     */
+    bool IsCancelled() const { return (int)cancelled != 0; }
+};
+
+#endif // CANCELLATIONTOKEN_H_INCLUDED
@@ -0,0 +1,144 @@
+#include <float.h>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include "chartWidget.h"
+
+/// Maximalni pocet bodu grafu (sude cislo).
+static const int maxPoints = 512;
+
+/// Okraj grafu pro popisky [px].
+static const int chartMargin = 6;
+
+ChartWidget::ChartWidget(QWidget *parent) : QWidget(parent)
+{
+    setAutoFillBackground(true);
+    Clear();
+}
+
+void ChartWidget::Clear()
+{
+    generation.clear();
+    minPrice.clear();
+    avgPrice.clear();
+    maxPrice.clear();
+    stride = 1;
+    bucketSize = 0;
+    changed = true;
+}
+
+void ChartWidget::AddPoint(int actGeneration, double minCurrentPathPrice, double avgCurrentPathPrice, double maxCurrentPathPrice)
+{
+    // Zaznamy se slucuji do rozpracovaneho bodu, dokud jich neni stride
+    if(bucketSize == 0)
+    {
+        bucketGeneration = actGeneration;
+        bucketMin = minCurrentPathPrice;
+        bucketAvgSum = 0;
+        bucketMax = maxCurrentPathPrice;
+    }
+    bucketMin = min(bucketMin, minCurrentPathPrice);
+    bucketAvgSum += avgCurrentPathPrice;
+    bucketMax = max(bucketMax, maxCurrentPathPrice);
+    bucketSize++;
+    changed = true;
+
+    if(bucketSize < stride)
+        return;
+
+    generation.push_back(bucketGeneration);
+    minPrice.push_back(bucketMin);
+    avgPrice.push_back(bucketAvgSum / bucketSize);
+    maxPrice.push_back(bucketMax);
+    bucketSize = 0;
+
+    // Po zaplneni se sousedni body slouci
+    if((int)generation.size() >= maxPoints)
+    {
+        for(int i = 0; i < maxPoints / 2; i++)
+        {
+            generation[i] = generation[2 * i];
+            minPrice[i] = min(minPrice[2 * i], minPrice[2 * i + 1]);
+            avgPrice[i] = (avgPrice[2 * i] + avgPrice[2 * i + 1]) / 2;
+            maxPrice[i] = max(maxPrice[2 * i], maxPrice[2 * i + 1]);
+        }
+        generation.resize(maxPoints / 2);
+        minPrice.resize(maxPoints / 2);
+        avgPrice.resize(maxPoints / 2);
+        maxPrice.resize(maxPoints / 2);
+        stride *= 2;
+    }
+}
+
+void ChartWidget::Refresh()
+{
+    if(changed)
+        update();
+}
+
+void ChartWidget::DrawCurve(QPainter &painter, const vector<double> &values, double lastValue, const QColor &color, double lowPrice, double highPrice)
+{
+    int count = values.size() + ((bucketSize > 0) ? 1 : 0);
+    if(count == 0)
+        return;
+
+    double chartWidth = this->width() - 2 * chartMargin;
+    double chartHeight = this->height() - 2 * chartMargin;
+    double priceRange = (highPrice > lowPrice) ? (highPrice - lowPrice) : 1;
+
+    vector<QPointF> points(count);
+    for(int i = 0; i < count; i++)
+    {
+        double value = (i < (int)values.size()) ? values[i] : lastValue;
+        double x = chartMargin + ((count > 1) ? chartWidth * i / (count - 1) : 0);
+        double y = chartMargin + chartHeight * (highPrice - value) / priceRange;
+        points[i] = QPointF(x, y);
+    }
+
+    painter.setPen(QPen(color, 1));
+    painter.drawPolyline(&points[0], count);
+}
+
+void ChartWidget::paintEvent(QPaintEvent * /* event */)
+{
+    changed = false;
+
+    QPainter painter(this);
+
+    // Vykresleni okraju
+    painter.setPen(Qt::black);
+    painter.setBrush(Qt::white);
+    painter.drawRect(0, 0, (this->width() - 1), (this->height() - 1));
+
+    if(generation.empty() && bucketSize == 0)
+        return;
+
+    // Rozsah cen (vcetne rozpracovaneho bodu)
+    double lowPrice = DBL_MAX, highPrice = -DBL_MAX;
+    for(int i = 0; i < (int)minPrice.size(); i++)
+    {
+        lowPrice = min(lowPrice, minPrice[i]);
+        highPrice = max(highPrice, maxPrice[i]);
+    }
+    if(bucketSize > 0)
+    {
+        lowPrice = min(lowPrice, bucketMin);
+        highPrice = max(highPrice, bucketMax);
+    }
+
+    double bucketAvg = (bucketSize > 0) ? bucketAvgSum / bucketSize : 0;
+    DrawCurve(painter, maxPrice, bucketMax, Qt::darkRed, lowPrice, highPrice);
+    DrawCurve(painter, avgPrice, bucketAvg, Qt::blue, lowPrice, highPrice);
+    DrawCurve(painter, minPrice, bucketMin, Qt::darkGreen, lowPrice, highPrice);
+
+    // Popisky rozsahu cen a posledni generace
+    int lastGeneration = (bucketSize > 0) ? bucketGeneration : generation.back();
+    stringstream highText, lowText, generationText;
+    highText << std::fixed << std::setprecision(0) << highPrice;
+    lowText << std::fixed << std::setprecision(0) << lowPrice;
+    generationText << lastGeneration;
+    painter.setPen(Qt::black);
+    painter.drawText(chartMargin + 2, chartMargin + 10, QString(highText.str().c_str()));
+    painter.drawText(chartMargin + 2, this->height() - chartMargin - 2, QString(lowText.str().c_str()));
+    painter.drawText(QRect(0, this->height() - chartMargin - 12, this->width() - chartMargin, 12), Qt::AlignRight, QString(generationText.str().c_str()));
+}
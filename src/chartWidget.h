@@ -0,0 +1,76 @@
+/**
+* \file chartWidget.h
+* Graf konvergence (nejlepsi, prumerna a nejhorsi cena cesty v populaci).
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef CHARTWIDGET_H_INCLUDED
+#define CHARTWIDGET_H_INCLUDED
+
+#include <QtGui>
+#include <QWidget>
+#include <vector>
+
+using namespace std;
+
+/// Graf konvergence evolucniho vypoctu.
+class ChartWidget : public QWidget
+{
+    Q_OBJECT
+
+    vector<int> generation;       ///< Generace bodu grafu.
+    vector<double> minPrice;      ///< Nejlepsi ceny cesty.
+    vector<double> avgPrice;      ///< Prumerne ceny cesty.
+    vector<double> maxPrice;      ///< Nejhorsi ceny cesty.
+    int stride;                   ///< Pocet zaznamu slucovanych do jednoho bodu grafu.
+    int bucketSize;               ///< Pocet zaznamu v rozpracovanem bodu.
+    int bucketGeneration;         ///< Generace prvniho zaznamu rozpracovaneho bodu.
+    double bucketMin;             ///< Nejlepsi cena v rozpracovanem bodu.
+    double bucketAvgSum;          ///< Soucet prumernych cen v rozpracovanem bodu.
+    double bucketMax;             ///< Nejhorsi cena v rozpracovanem bodu.
+    bool changed;                 ///< Udava, zda-li se graf od posledniho vykresleni zmenil.
+
+    /**
+    * Vykresli jednu krivku grafu.
+    * @param painter Kreslici objekt.
+    * @param values Hodnoty krivky.
+    * @param lastValue Hodnota rozpracovaneho bodu (pouzije se, je-li bucketSize > 0).
+    * @param color Barva krivky.
+    * @param lowPrice Cena na dolnim okraji grafu.
+    * @param highPrice Cena na hornim okraji grafu.
+    */
+    void DrawCurve(QPainter &painter, const vector<double> &values, double lastValue, const QColor &color, double lowPrice, double highPrice);
+
+    protected:
+    void paintEvent(QPaintEvent *event);
+
+    public:
+    /**
+    * Konstruktor.
+    * @param parent Rodicovsky objekt.
+    */
+    ChartWidget(QWidget *parent = 0);
+
+    /**
+    * Smaze vsechny body grafu.
+    */
+    void Clear();
+
+    /**
+    * Prida zaznam do grafu. Pocet bodu grafu je omezen; po jeho dosazeni se vzdy dva sousedni
+    * body slouci do jednoho (nejlepsi z nejlepsich, prumer prumeru, nejhorsi z nejhorsich) a dalsi
+    * zaznamy se slucuji po dvojnasobnem poctu.
+    * @param actGeneration Cislo generace.
+    * @param minCurrentPathPrice Nejlepsi cena cesty v populaci.
+    * @param avgCurrentPathPrice Prumerna cena cesty v populaci.
+    * @param maxCurrentPathPrice Nejhorsi cena cesty v populaci.
+    */
+    void AddPoint(int actGeneration, double minCurrentPathPrice, double avgCurrentPathPrice, double maxCurrentPathPrice);
+
+    /**
+    * Prekresli graf, zmenil-li se od posledniho vykresleni.
+    */
+    void Refresh();
+};
+
+#endif // CHARTWIDGET_H_INCLUDED
@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include <unistd.h>
+#include <iostream>
+#include <algorithm>
+#include <limits.h>
+#include "checkpoint.h"
+
+/// Identifikace souboru s kontrolnim bodem.
+static const char checkpointMagic[4] = { 'T', 'S', 'P', 'C' };
+
+/// Verze formatu kontrolniho bodu.
+static const int checkpointVersion = 6;
+
+/// Nejvetsi pripustna delka pojmenovani problemu.
+static const int maxNameLength = 4096;
+
+/**
+ * Zapise vektor (pocet prvku a jejich hodnoty) do souboru.
+ * @param file Vystupni soubor.
+ * @param data Zapisovany vektor.
+ * @return Urcuje, zda-li se zapis podaril.
+ */
+template<typename T> static bool WriteVector(FILE *file, const vector<T> &data)
+{
+    long long size = data.size();
+    if(fwrite(&size, sizeof(size), 1, file) != 1)
+        return false;
+    return (size == 0) || (fwrite(&data[0], sizeof(T), size, file) == (size_t)size);
+}
+
+/**
+ * Nacte vektor zapsany funkci WriteVector().
+ * @param file Vstupni soubor.
+ * @param data Nacteny vektor.
+ * @param maxSize Nejvetsi pripustny pocet prvku (ochrana proti poskozenemu souboru).
+ * @return Urcuje, zda-li se nacteni podarilo.
+ */
+template<typename T> static bool ReadVector(FILE *file, vector<T> &data, long long maxSize)
+{
+    long long size;
+    if(fread(&size, sizeof(size), 1, file) != 1 || size < 0 || size > maxSize)
+        return false;
+
+    // Poskozena delka nesmi vest k alokaci vetsi, nez kolik dat v souboru zbyva
+    long position = ftell(file);
+    if(position < 0 || fseek(file, 0, SEEK_END) != 0)
+        return false;
+    long end = ftell(file);
+    if(fseek(file, position, SEEK_SET) != 0 || size > (long long)(end - position) / (long long)sizeof(T))
+        return false;
+
+    data.resize(size);
+    return (size == 0) || (fread(&data[0], sizeof(T), size, file) == (size_t)size);
+}
+
+CheckpointWriter::CheckpointWriter() : QThread()
+{
+    pendingFlag = writingFlag = abortFlag = false;
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    mutex.lock();
+    abortFlag = true;
+    condition.wakeAll();
+    mutex.unlock();
+
+    wait();
+}
+
+void CheckpointWriter::Submit(string fileName, tCheckpoint &state)
+{
+    mutex.lock();
+    this->fileName = fileName;
+    std::swap(pending, state);   // volajici dostane zpet predchozi buffery (recyklace alokaci)
+    pendingFlag = true;
+    abortFlag = false;
+    condition.wakeAll();
+    mutex.unlock();
+
+    if(!isRunning())
+        start();
+}
+
+void CheckpointWriter::Flush()
+{
+    mutex.lock();
+    while(pendingFlag || writingFlag)
+        condition.wait(&mutex);
+    mutex.unlock();
+}
+
+void CheckpointWriter::run()
+{
+    tCheckpoint state;
+    string actFileName;
+
+    mutex.lock();
+    while(true)
+    {
+        if(!pendingFlag)
+        {
+            if(abortFlag)
+                break;
+            condition.wait(&mutex);
+            continue;
+        }
+
+        // Prevzeti cekajiciho bodu; zapis probiha bez drzeni zamku
+        std::swap(state, pending);
+        actFileName = fileName;
+        pendingFlag = false;
+        writingFlag = true;
+        mutex.unlock();
+
+        if(!Save(actFileName, state))
+            cerr << "Chyba! Kontrolni bod nelze zapsat do souboru " << actFileName << "." << endl;
+
+        mutex.lock();
+        writingFlag = false;
+        condition.wakeAll();
+    }
+    mutex.unlock();
+}
+
+bool CheckpointWriter::Save(string fileName, const tCheckpoint &state)
+{
+    string tempFileName = fileName + ".tmp";
+    FILE *file = fopen(tempFileName.c_str(), "wb");
+    if(file == NULL)
+        return false;
+
+    bool ok = true;
+    ok = ok && fwrite(checkpointMagic, 1, 4, file) == 4;
+    ok = ok && fwrite(&checkpointVersion, sizeof(checkpointVersion), 1, file) == 1;
+    ok = ok && WriteVector(file, vector<char>(state.name.begin(), state.name.end()));
+    ok = ok && fwrite(&state.edgeWeightType, sizeof(state.edgeWeightType), 1, file) == 1;
+    ok = ok && fwrite(&state.integerDistances, sizeof(state.integerDistances), 1, file) == 1;
+    ok = ok && fwrite(&state.fingerprint, sizeof(state.fingerprint), 1, file) == 1;
+    ok = ok && fwrite(&state.dimension, sizeof(state.dimension), 1, file) == 1;
+    ok = ok && fwrite(&state.sPopulation, sizeof(state.sPopulation), 1, file) == 1;
+    ok = ok && fwrite(&state.actGeneration, sizeof(state.actGeneration), 1, file) == 1;
+    ok = ok && fwrite(&state.rngState, sizeof(state.rngState), 1, file) == 1;
+    ok = ok && fwrite(&state.crossoverCount, sizeof(state.crossoverCount), 1, file) == 1;
+    ok = ok && fwrite(&state.mutationCount, sizeof(state.mutationCount), 1, file) == 1;
+    ok = ok && fwrite(&state.genomeEvaluationCount, sizeof(state.genomeEvaluationCount), 1, file) == 1;
+    ok = ok && fwrite(&state.elapsedTime, sizeof(state.elapsedTime), 1, file) == 1;
+    ok = ok && fwrite(state.prices, sizeof(state.prices), 1, file) == 1;
+    ok = ok && WriteVector(file, state.genomes);
+    ok = ok && WriteVector(file, state.genomePrices);
+    ok = ok && WriteVector(file, state.resultGenome);
+    ok = ok && fwrite(&state.resultPrice, sizeof(state.resultPrice), 1, file) == 1;
+    ok = ok && WriteVector(file, state.historyMin);
+    ok = ok && WriteVector(file, state.historyAvg);
+    ok = ok && WriteVector(file, state.historyMax);
+    ok = ok && fwrite(&state.historyStride, sizeof(state.historyStride), 1, file) == 1;
+    ok = ok && fwrite(&state.historyCount, sizeof(state.historyCount), 1, file) == 1;
+    ok = ok && fwrite(&state.restartCount, sizeof(state.restartCount), 1, file) == 1;
+    ok = ok && fwrite(&state.mutationRate, sizeof(state.mutationRate), 1, file) == 1;
+    ok = ok && fwrite(&state.tournamentLevel, sizeof(state.tournamentLevel), 1, file) == 1;
+    ok = ok && fwrite(&state.convergedGenerations, sizeof(state.convergedGenerations), 1, file) == 1;
+    ok = ok && WriteVector(file, state.archivePrices);
+    ok = ok && WriteVector(file, state.archiveGenomes);
+
+    // Data musi byt na disku drive, nez prejmenovanim nahradi predchozi kontrolni bod
+    ok = ok && fflush(file) == 0;
+    ok = ok && fsync(fileno(file)) == 0;
+    ok = (fclose(file) == 0) && ok;
+
+    if(!ok || rename(tempFileName.c_str(), fileName.c_str()) != 0)
+    {
+        remove(tempFileName.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool CheckpointWriter::Load(string fileName, tCheckpoint &state, int maxHistorySize, int maxArchiveSize)
+{
+    FILE *file = fopen(fileName.c_str(), "rb");
+    if(file == NULL)
+        return false;
+
+    char magic[4];
+    int version;
+    vector<char> name;
+    bool ok = true;
+    ok = ok && fread(magic, 1, 4, file) == 4 && equal(magic, magic + 4, checkpointMagic);
+    ok = ok && fread(&version, sizeof(version), 1, file) == 1 && version == checkpointVersion;
+    ok = ok && ReadVector(file, name, maxNameLength);
+    state.name.assign(name.begin(), name.end());
+    ok = ok && fread(&state.edgeWeightType, sizeof(state.edgeWeightType), 1, file) == 1;
+    ok = ok && fread(&state.integerDistances, sizeof(state.integerDistances), 1, file) == 1;
+    ok = ok && fread(&state.fingerprint, sizeof(state.fingerprint), 1, file) == 1;
+    ok = ok && fread(&state.dimension, sizeof(state.dimension), 1, file) == 1 && state.dimension > 0;
+    ok = ok && fread(&state.sPopulation, sizeof(state.sPopulation), 1, file) == 1 && state.sPopulation > 0;
+    ok = ok && fread(&state.actGeneration, sizeof(state.actGeneration), 1, file) == 1;
+    ok = ok && fread(&state.rngState, sizeof(state.rngState), 1, file) == 1;
+    ok = ok && fread(&state.crossoverCount, sizeof(state.crossoverCount), 1, file) == 1;
+    ok = ok && fread(&state.mutationCount, sizeof(state.mutationCount), 1, file) == 1;
+    ok = ok && fread(&state.genomeEvaluationCount, sizeof(state.genomeEvaluationCount), 1, file) == 1;
+    ok = ok && fread(&state.elapsedTime, sizeof(state.elapsedTime), 1, file) == 1;
+    ok = ok && fread(state.prices, sizeof(state.prices), 1, file) == 1;
+
+    long long genomeSize = ok ? ((long long)state.dimension * state.sPopulation) : 0;
+    ok = ok && ReadVector(file, state.genomes, genomeSize) && (long long)state.genomes.size() == genomeSize;
+    ok = ok && ReadVector(file, state.genomePrices, state.sPopulation) && (int)state.genomePrices.size() == state.sPopulation;
+    ok = ok && ReadVector(file, state.resultGenome, state.dimension);
+    ok = ok && fread(&state.resultPrice, sizeof(state.resultPrice), 1, file) == 1;
+    ok = ok && ReadVector(file, state.historyMin, maxHistorySize);
+    ok = ok && ReadVector(file, state.historyAvg, maxHistorySize);
+    ok = ok && ReadVector(file, state.historyMax, maxHistorySize);
+    ok = ok && fread(&state.historyStride, sizeof(state.historyStride), 1, file) == 1 && state.historyStride > 0;
+    ok = ok && fread(&state.historyCount, sizeof(state.historyCount), 1, file) == 1;
+    ok = ok && fread(&state.restartCount, sizeof(state.restartCount), 1, file) == 1;
+    ok = ok && fread(&state.mutationRate, sizeof(state.mutationRate), 1, file) == 1;
+    ok = ok && fread(&state.tournamentLevel, sizeof(state.tournamentLevel), 1, file) == 1 && state.tournamentLevel >= 1;
+    ok = ok && fread(&state.convergedGenerations, sizeof(state.convergedGenerations), 1, file) == 1;
+    ok = ok && ReadVector(file, state.archivePrices, maxArchiveSize);
+    long long archiveSize = ok ? ((long long)state.dimension * state.archivePrices.size()) : 0;
+    ok = ok && ReadVector(file, state.archiveGenomes, archiveSize) && (long long)state.archiveGenomes.size() == archiveSize;
+
+    fclose(file);
+
+    return ok;
+}
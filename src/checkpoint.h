@@ -0,0 +1,116 @@
+/**
+* \file checkpoint.h
+* Ukladani a obnova kontrolnich bodu behu evoluce.
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef CHECKPOINT_H_INCLUDED
+#define CHECKPOINT_H_INCLUDED
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/// Stav behu evoluce ulozeny v kontrolnim bodu.
+typedef struct
+{
+    string name;                     ///< Pojmenovani reseneho problemu.
+    int edgeWeightType;              ///< Zpusob vypoctu vzdalenosti mest (E_EDGE_WEIGHT).
+    int integerDistances;            ///< Udava, zda-li se pouzivaly celociselne vzdalenosti.
+    double fingerprint;              ///< Otisk vzdalenosti (delka cesty pres mesta v poradi souboru).
+    int dimension;                   ///< Pocet mest.
+    int sPopulation;                 ///< Velikost populace.
+    int actGeneration;               ///< Cislo aktualni generace.
+    unsigned long long rngState;     ///< Stav generatoru pseudonahodnych cisel.
+    long long crossoverCount;        ///< Pocet aplikaci operatoru krizeni.
+    long long mutationCount;         ///< Pocet aplikaci operatoru mutace.
+    long long genomeEvaluationCount; ///< Pocet ohodnoceni genomu.
+    double elapsedTime;              ///< Doba behu vypoctu do okamziku ulozeni [s].
+    double prices[9];                ///< Cenove statistiky (min / max / prumer od inicializace, v pocatecni a v aktualni populaci).
+    vector<int> genomes;             ///< Genomy populace rodicu ulozene za sebou (sPopulation * dimension indexu).
+    vector<double> genomePrices;     ///< Ceny cest jedincu populace rodicu.
+    vector<int> resultGenome;        ///< Genom nejlepsiho nalezeneho reseni.
+    double resultPrice;              ///< Cena nejlepsiho nalezeneho reseni.
+    vector<double> historyMin;       ///< Historie nejlepsich cen (po intervalech logovani).
+    vector<double> historyAvg;       ///< Historie prumernych cen.
+    vector<double> historyMax;       ///< Historie nejhorsich cen.
+    int historyStride;               ///< Pocet intervalu logovani mezi body historie.
+    int historyCount;                ///< Pocet vsech zaznamenanych intervalu logovani.
+    int restartCount;                ///< Pocet restartu populace.
+    double mutationRate;             ///< Efektivni pravdepodobnost mutace.
+    double tournamentLevel;          ///< Spojita hodnota velikosti turnaje.
+    int convergedGenerations;        ///< Pocet generaci se zkonvergovanou populaci od posledniho zlepseni.
+    vector<int> archiveGenomes;      ///< Genomy archivu nejlepsich cest ulozene za sebou.
+    vector<double> archivePrices;    ///< Ceny cest archivu.
+} tCheckpoint;
+
+/**
+ * Zapisovac kontrolnich bodu bezici ve vlastnim vlakne.
+ * Vypocet pouze preda kopii stavu a pokracuje; pokud zapis predchoziho bodu jeste probiha,
+ * cekajici bod se nahradi novejsim. Soubor se zapisuje atomicky (docasny soubor a prejmenovani).
+ */
+class CheckpointWriter : public QThread
+{
+    private:
+    string fileName;          ///< Cesta k souboru s kontrolnim bodem.
+    tCheckpoint pending;      ///< Kontrolni bod cekajici na zapis.
+    bool pendingFlag;         ///< Udava, zda-li ceka kontrolni bod na zapis.
+    bool writingFlag;         ///< Udava, zda-li prave probiha zapis.
+    bool abortFlag;           ///< Priznak ukonceni vlakna.
+
+    QMutex mutex;
+    QWaitCondition condition;
+
+    /**
+    * Smycka zapisu kontrolnich bodu.
+    */
+    void run();
+
+    public:
+    /**
+    * Konstruktor.
+    */
+    CheckpointWriter();
+
+    /**
+     * Destruktor (zapise pripadny cekajici kontrolni bod).
+     */
+    ~CheckpointWriter();
+
+    /**
+     * Preda kontrolni bod k zapisu (obsah predaneho stavu je prevzat vymenou, nikoliv kopirovan;
+     * volajici obdrzi buffery nektereho z predchozich bodu k opetovnemu pouziti).
+     * @param fileName Cesta k souboru s kontrolnim bodem.
+     * @param state Stav behu evoluce.
+     */
+    void Submit(string fileName, tCheckpoint &state);
+
+    /**
+     * Pocka na dokonceni vsech zapisu.
+     */
+    void Flush();
+
+    /**
+     * Zapise kontrolni bod do souboru (docasny soubor a atomicke prejmenovani).
+     * @param fileName Cesta k souboru s kontrolnim bodem.
+     * @param state Stav behu evoluce.
+     * @return Urcuje, zda-li se zapis podaril.
+     */
+    static bool Save(string fileName, const tCheckpoint &state);
+
+    /**
+     * Nacte kontrolni bod ze souboru.
+     * @param fileName Cesta k souboru s kontrolnim bodem.
+     * @param state Nacteny stav behu evoluce.
+     * @param maxHistorySize Nejvetsi pripustny pocet bodu historie cen.
+     * @param maxArchiveSize Nejvetsi pripustna velikost archivu nejlepsich cest.
+     * @return Urcuje, zda-li se nacteni podarilo.
+     */
+    static bool Load(string fileName, tCheckpoint &state, int maxHistorySize, int maxArchiveSize);
+};
+
+#endif // CHECKPOINT_H_INCLUDED
@@ -0,0 +1,151 @@
+#include <sys/mman.h>
+#include <unistd.h>
+#include <string.h>
+#include <limits.h>
+#include <algorithm>
+#include "cityMatrix.h"
+
+MatrixStorage::~MatrixStorage()
+{
+    if(mapAddress != NULL)
+        munmap(mapAddress, mapLength);
+}
+
+CityMatrix::CityMatrix()
+{
+    dimension = 0;
+    type = MATRIX_FLOAT;
+    data = NULL;
+}
+
+void *CityMatrix::AllocateData(int dimension, E_MATRIX_TYPE type)
+{
+    QSharedPointer<MatrixStorage> newStorage(new MatrixStorage);
+    size_t length = (size_t)dimension * dimension * ((type == MATRIX_UINT16) ? sizeof(unsigned short) : sizeof(float));
+    void *newData;
+
+    // Anonymni mapovani je nulovano az pri prvnim zapisu do stranky, velka matice se tak
+    // nenuluje jednim vlaknem predem (a stranky si rozdeli vlakna, ktera matici plni)
+    void *address = (length > 0) ? mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) : MAP_FAILED;
+    if(address != MAP_FAILED)
+    {
+        newStorage->mapAddress = address;
+        newStorage->mapLength = length;
+        newData = address;
+    }
+    else
+    {
+        newStorage->buffer.assign(max(length, sizeof(float)), 0);
+        newData = &newStorage->buffer[0];
+    }
+
+    this->dimension = dimension;
+    this->type = type;
+    this->storage = newStorage;
+    this->cache.clear();
+    data = newData;
+
+    return newData;
+}
+
+void CityMatrix::Narrow()
+{
+    // Zuzit lze jen vlastni pamet (ne matici namapovanou ze souboru)
+    if(type != MATRIX_UINT32 || storage.isNull() ||
+       (data != storage->mapAddress && (storage->buffer.empty() || data != &storage->buffer[0])))
+        return;
+
+    size_t count = (size_t)dimension * dimension;
+    const unsigned int *source = (const unsigned int *)data;
+    unsigned int maxValue = 0;
+    for(size_t k = 0; k < count; k++)
+        maxValue = max(maxValue, source[k]);
+    if(maxValue > USHRT_MAX)
+        return;
+
+    // Prvek k se zapisuje na pozici, ze ktere uz byly vsechny puvodni prvky precteny
+    char *target = (char *)data;
+    for(size_t k = 0; k < count; k++)
+    {
+        unsigned short value = source[k];
+        memcpy(target + k * sizeof(value), &value, sizeof(value));
+    }
+    type = MATRIX_UINT16;
+
+    // Nepotrebny konec anonymniho mapovani se uvolni
+    if(storage->mapAddress == data)
+    {
+        size_t pageSize = sysconf(_SC_PAGESIZE);
+        size_t newLength = (count * sizeof(unsigned short) + pageSize - 1) / pageSize * pageSize;
+        if(newLength < storage->mapLength && munmap(target + newLength, storage->mapLength - newLength) == 0)
+            storage->mapLength = newLength;
+    }
+}
+
+void CityMatrix::Attach(int dimension, E_MATRIX_TYPE type, const void *data, QSharedPointer<MatrixStorage> storage)
+{
+    this->dimension = dimension;
+    this->type = type;
+    this->data = data;
+    this->storage = storage;
+    this->cache.clear();
+}
+
+void CityMatrix::AttachCache(int dimension, QSharedPointer<DistanceRowCache> cache)
+{
+    this->dimension = dimension;
+    this->type = MATRIX_CACHED;
+    this->data = NULL;
+    this->storage.clear();
+    this->cache = cache;
+}
+
+void CityMatrix::Clear()
+{
+    dimension = 0;
+    type = MATRIX_FLOAT;
+    data = NULL;
+    storage.clear();
+    cache.clear();
+}
+
+bool CityMatrix::IsSymmetric() const
+{
+    for(int i = 0; i < dimension; i++)
+    {
+        for(int j = i + 1; j < dimension; j++)
+        {
+            if(Distance(i, j) != Distance(j, i))
+                return false;
+        }
+    }
+    return true;
+}
+
+void MatrixRowSource::FillRow(int row, float *target)
+{
+    int n = cityMatrix.GetDimension();
+    for(int j = 0; j < n; j++)
+        target[j] = cityMatrix.Distance(row, j);
+}
+
+CityNeighbours::CityNeighbours()
+{
+    dimension = count = 0;
+    data = NULL;
+}
+
+void CityNeighbours::Attach(int dimension, int count, const int *data, QSharedPointer<MatrixStorage> storage)
+{
+    this->dimension = dimension;
+    this->count = count;
+    this->data = data;
+    this->storage = storage;
+}
+
+void CityNeighbours::Clear()
+{
+    dimension = count = 0;
+    data = NULL;
+    storage.clear();
+}
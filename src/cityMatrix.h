@@ -0,0 +1,267 @@
+/**
+* \file cityMatrix.h
+* Matice vzdalenosti mest a seznamy nejblizsich sousedu.
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef CITYMATRIX_H_INCLUDED
+#define CITYMATRIX_H_INCLUDED
+
+#include <QSharedPointer>
+#include <vector>
+#include <stddef.h>
+#include "distanceCache.h"
+
+using namespace std;
+
+/**
+ * Pamet, ve ktere jsou ulozena data matice nebo seznamu sousedu.
+ * Bud vlastni alokace, nebo namapovany soubor (uvolni se az se zanikem posledniho drzitele).
+ */
+class MatrixStorage
+{
+    public:
+    vector<char> buffer;   ///< Vlastni pamet (pokud data nejsou namapovana ze souboru).
+    void *mapAddress;      ///< Adresa namapovaneho souboru (NULL, neni-li soubor namapovan).
+    size_t mapLength;      ///< Delka namapovane oblasti.
+
+    /**
+    * Konstruktor.
+    */
+    MatrixStorage() : mapAddress(NULL), mapLength(0) {}
+
+    /**
+     * Destruktor (odmapuje soubor).
+     */
+    ~MatrixStorage();
+};
+
+/// Typ prvku matice vzdalenosti.
+enum E_MATRIX_TYPE
+{
+    MATRIX_FLOAT = 0,    ///< Realne vzdalenosti (float).
+    MATRIX_UINT16 = 1,   ///< Celociselne vzdalenosti do 65535 (unsigned short).
+    MATRIX_UINT32 = 2,   ///< Celociselne vzdalenosti (unsigned int).
+    MATRIX_CACHED = 3    ///< Matice neni v pameti cela, radky poskytuje vyrovnavaci pamet.
+};
+
+/**
+ * Matice vzdalenosti mezi mesty ulozena v souvislem poli po radcich.
+ * Kopie matice sdileji stejna data, kopirovani je proto levne (napr. pri predani vlaknu vypoctu).
+ */
+class CityMatrix
+{
+    private:
+    int dimension;                            ///< Pocet mest.
+    E_MATRIX_TYPE type;                       ///< Typ prvku matice.
+    const void *data;                         ///< Prvni prvek matice.
+    QSharedPointer<MatrixStorage> storage;    ///< Pamet drzici data matice.
+    QSharedPointer<DistanceRowCache> cache;   ///< Vyrovnavaci pamet radku (jen u typu MATRIX_CACHED).
+
+    /**
+     * Alokuje vlastni pamet pro matici.
+     * @param dimension Pocet mest.
+     * @param type Typ prvku matice.
+     * @return Ukazatel na prvni prvek.
+     */
+    void *AllocateData(int dimension, E_MATRIX_TYPE type);
+
+    public:
+    /**
+    * Konstruktor (prazdna matice).
+    */
+    CityMatrix();
+
+    /**
+     * Alokuje vlastni pamet pro matici dane dimenze (prvky jsou nulove, stranky se
+     * skutecne alokuji az pri prvnim zapisu).
+     * @param dimension Pocet mest.
+     * @return Ukazatel na prvni prvek pro naplneni matice.
+     */
+    float *Allocate(int dimension) { return (float *)AllocateData(dimension, MATRIX_FLOAT); }
+
+    /**
+     * Alokuje pamet pro celociselnou matici (32bitove prvky; po naplneni ji lze zuzit metodou Narrow).
+     * @param dimension Pocet mest.
+     * @return Ukazatel na prvni prvek pro naplneni matice.
+     */
+    unsigned int *AllocateInteger(int dimension) { return (unsigned int *)AllocateData(dimension, MATRIX_UINT32); }
+
+    /**
+     * Prevede celociselnou matici na 16bitove prvky, vejdou-li se do nich vsechny vzdalenosti.
+     * Prevod probiha na miste, uvolnena cast pameti se vrati systemu.
+     */
+    void Narrow();
+
+    /**
+     * Pripoji matici k datum ve sdilene pameti (napr. namapovanem souboru).
+     * @param dimension Pocet mest.
+     * @param type Typ prvku matice.
+     * @param data Prvni prvek matice.
+     * @param storage Pamet, ve ktere data lezi.
+     */
+    void Attach(int dimension, E_MATRIX_TYPE type, const void *data, QSharedPointer<MatrixStorage> storage);
+
+    /**
+     * Pripoji matici k vyrovnavaci pameti radku (matice se nedrzi v pameti cela).
+     * @param dimension Pocet mest.
+     * @param cache Vyrovnavaci pamet radku.
+     */
+    void AttachCache(int dimension, QSharedPointer<DistanceRowCache> cache);
+
+    /**
+     * Vrati vyrovnavaci pamet radku.
+     * @return Vyrovnavaci pamet (NULL, neni-li matice typu MATRIX_CACHED).
+     */
+    DistanceRowCache *GetCache() const { return cache.data(); }
+
+    /**
+     * Uvolni matici.
+     */
+    void Clear();
+
+    /**
+     * Vrati pocet mest.
+     * @return Pocet mest.
+     */
+    int GetDimension() const { return dimension; }
+
+    /**
+     * Zjisti, zda-li je matice prazdna.
+     * @return True, neobsahuje-li matice zadna data.
+     */
+    bool IsEmpty() const { return data == NULL && cache.isNull(); }
+
+    /**
+     * Vrati typ prvku matice.
+     * @return Typ prvku.
+     */
+    E_MATRIX_TYPE GetType() const { return type; }
+
+    /**
+     * Zjisti, zda-li matice obsahuje celociselne vzdalenosti.
+     * @return True u celociselne matice.
+     */
+    bool IsInteger() const { return type == MATRIX_UINT16 || type == MATRIX_UINT32; }
+
+    /**
+     * Zjisti, zda-li je matice symetricka (prochazi celou matici, vola se jen pri nacteni ulohy).
+     * @return True, plati-li d(i, j) == d(j, i) pro vsechny dvojice mest.
+     */
+    bool IsSymmetric() const;
+
+    /**
+     * Vrati velikost prvku matice.
+     * @return Velikost prvku v bajtech.
+     */
+    size_t GetElementSize() const { return (type == MATRIX_UINT16) ? sizeof(unsigned short) : sizeof(float); }
+
+    /**
+     * Vrati vzdalenost mezi dvema mesty.
+     * @param i Index prvniho mesta.
+     * @param j Index druheho mesta.
+     * @return Vzdalenost mest.
+     */
+    double Distance(int i, int j) const
+    {
+        size_t index = (size_t)i * dimension + j;
+        switch(type)
+        {
+            case MATRIX_UINT16: return ((const unsigned short *)data)[index];
+            case MATRIX_UINT32: return ((const unsigned int *)data)[index];
+            case MATRIX_CACHED: return cache->Distance(i, j);
+            default:            return ((const float *)data)[index];
+        }
+    }
+
+    /**
+     * Vrati prvky matice (typ musi odpovidat GetType, u MATRIX_CACHED nelze pouzit).
+     * @return Ukazatel na prvni prvek matice.
+     */
+    template <class T> const T *Elements() const { return (const T *)data; }
+
+    /**
+     * Vrati radek matice.
+     * @param i Index mesta.
+     * @return Ukazatel na prvni prvek radku (prvky maji velikost GetElementSize; u MATRIX_CACHED nelze pouzit).
+     */
+    const void *Row(int i) const { return (const char *)data + (size_t)i * dimension * GetElementSize(); }
+};
+
+/**
+ * Zdroj radku pro vyrovnavaci pamet: matice ulozena v pameti (typicky namapovany soubor).
+ */
+class MatrixRowSource : public DistanceRowSource
+{
+    private:
+    CityMatrix cityMatrix;   ///< Zdrojova matice.
+
+    public:
+    /**
+    * Konstruktor.
+    * @param cityMatrix Zdrojova matice (sdili data s originalem).
+    */
+    MatrixRowSource(const CityMatrix &cityMatrix) : cityMatrix(cityMatrix) {}
+
+    /**
+     * Naplni radek matice.
+     * @param row Index radku (mesta).
+     * @param target Cil pro vzdalenosti ke vsem mestum.
+     */
+    void FillRow(int row, float *target);
+
+    /**
+     * Vrati jednu vzdalenost primo ze zdroje.
+     * @param i Index prvniho mesta.
+     * @param j Index druheho mesta.
+     * @return Vzdalenost mest.
+     */
+    float Distance(int i, int j) { return (float)cityMatrix.Distance(i, j); }
+};
+
+/**
+ * Seznamy K nejblizsich sousedu kazdeho mesta (serazene podle vzdalenosti; vypocita je NeighbourBuilder).
+ */
+class CityNeighbours
+{
+    private:
+    int dimension;                            ///< Pocet mest.
+    int count;                                ///< Pocet sousedu kazdeho mesta.
+    const int *data;                          ///< Prvni prvek seznamu (dimension * count indexu).
+    QSharedPointer<MatrixStorage> storage;    ///< Pamet drzici seznamy.
+
+    public:
+    /**
+    * Konstruktor (prazdne seznamy).
+    */
+    CityNeighbours();
+
+    /**
+     * Pripoji seznamy k datum ve sdilene pameti.
+     * @param dimension Pocet mest.
+     * @param count Pocet sousedu kazdeho mesta.
+     * @param data Prvni prvek seznamu.
+     * @param storage Pamet, ve ktere data lezi.
+     */
+    void Attach(int dimension, int count, const int *data, QSharedPointer<MatrixStorage> storage);
+
+    /**
+     * Uvolni seznamy.
+     */
+    void Clear();
+
+    /**
+     * Vrati pocet sousedu kazdeho mesta.
+     * @return Pocet sousedu (0, nejsou-li seznamy k dispozici).
+     */
+    int GetCount() const { return count; }
+
+    /**
+     * Vrati seznam sousedu mesta.
+     * @param i Index mesta.
+     * @return Ukazatel na prvni prvek seznamu (GetCount() indexu).
+     */
+    const int *Of(int i) const { return data + (size_t)i * count; }
+};
+
+#endif // CITYMATRIX_H_INCLUDED
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include "cityTree.h"
+
+/// Nejvetsi pocet mest v listu stromu.
+static const int leafCities = 8;
+
+/// Porovnani mest podle jedne souradnice (pro deleni stromu).
+class AxisCompare
+{
+    const vector<CityPosition> *position;   ///< Pozice mest.
+    int axis;                               ///< Porovnavana souradnice (0 = X, 1 = Y).
+
+    public:
+    AxisCompare(const vector<CityPosition> &position, int axis) : position(&position), axis(axis) {}
+    bool operator()(int a, int b) const { return (axis == 0) ? (*position)[a].x < (*position)[b].x : (*position)[a].y < (*position)[b].y; }
+};
+
+CityTree::CityTree()
+{
+    cityPosition = NULL;
+}
+
+void CityTree::Build(const vector<CityPosition> &cityPosition)
+{
+    this->cityPosition = &cityPosition;
+    int dimension = cityPosition.size();
+    nodes.clear();
+    order.resize(dimension);
+    for(int i = 0; i < dimension; i++)
+        order[i] = i;
+    cityLeaf.resize(dimension);
+    if(dimension > 0)
+        BuildNode(0, dimension, -1);
+}
+
+void CityTree::Clear()
+{
+    cityPosition = NULL;
+    nodes.clear();
+    order.clear();
+    cityLeaf.clear();
+}
+
+int CityTree::BuildNode(int first, int last, int parent)
+{
+    int node = nodes.size();
+    tNode leaf = { first, last, -1, -1, parent, 0, 0 };
+    nodes.push_back(leaf);
+    if(last - first <= leafCities)
+    {
+        for(int i = first; i < last; i++)
+            cityLeaf[order[i]] = node;
+        return node;
+    }
+
+    // Deli se medianem podle delsi strany obalky mest uzlu
+    const vector<CityPosition> &position = *cityPosition;
+    double minX = position[order[first]].x, maxX = minX;
+    double minY = position[order[first]].y, maxY = minY;
+    for(int i = first + 1; i < last; i++)
+    {
+        const CityPosition &p = position[order[i]];
+        minX = min(minX, p.x);
+        maxX = max(maxX, p.x);
+        minY = min(minY, p.y);
+        maxY = max(maxY, p.y);
+    }
+    int axis = (maxX - minX >= maxY - minY) ? 0 : 1;
+    int middle = (first + last) / 2;
+    nth_element(order.begin() + first, order.begin() + middle, order.begin() + last, AxisCompare(position, axis));
+
+    // Delici souradnice se urci pred stavbou podstromu (ty poradi mest dale meni)
+    nodes[node].axis = axis;
+    nodes[node].split = (axis == 0) ? position[order[middle]].x : position[order[middle]].y;
+    int left = BuildNode(first, middle, node);
+    int right = BuildNode(middle, last, node);
+    nodes[node].left = left;
+    nodes[node].right = right;
+    return node;
+}
+
+void CityTree::Nearest(int city, int count, vector<int> &neighbours, vector<pair<double, int> > &heap) const
+{
+    heap.clear();
+    if(count > 0 && !nodes.empty())
+        SearchNearest(0, city, count, heap);
+    sort_heap(heap.begin(), heap.end());
+
+    neighbours.resize(heap.size());
+    for(int i = 0; i < (int)heap.size(); i++)
+        neighbours[i] = heap[i].second;
+}
+
+void CityTree::SearchNearest(int node, int city, int count, vector<pair<double, int> > &heap) const
+{
+    const tNode &current = nodes[node];
+    const CityPosition &p = (*cityPosition)[city];
+
+    if(current.left < 0)
+    {   // List: mesta se porovnaji s nejvzdalenejsim kandidatem
+        for(int i = current.first; i < current.last; i++)
+        {
+            int other = order[i];
+            if(other == city)
+                continue;
+
+            double dX = p.x - (*cityPosition)[other].x;
+            double dY = p.y - (*cityPosition)[other].y;
+            pair<double, int> candidate(dX * dX + dY * dY, other);
+            if((int)heap.size() < count)
+            {
+                heap.push_back(candidate);
+                push_heap(heap.begin(), heap.end());
+            }
+            else if(candidate < heap.front())
+            {
+                pop_heap(heap.begin(), heap.end());
+                heap.back() = candidate;
+                push_heap(heap.begin(), heap.end());
+            }
+        }
+        return;
+    }
+
+    // Nejdrive blizsi vetev; vzdalenejsi jen, muze-li v ni lezet blizsi mesto
+    double difference = ((current.axis == 0) ? p.x : p.y) - current.split;
+    int nearChild = (difference <= 0) ? current.left : current.right;
+    int farChild = (difference <= 0) ? current.right : current.left;
+    SearchNearest(nearChild, city, count, heap);
+    if((int)heap.size() < count || difference * difference < heap.front().first)
+        SearchNearest(farChild, city, count, heap);
+}
+
+void CityTree::ResetState(tRemovalState &state) const
+{
+    state.alive.resize(nodes.size());
+    for(int i = 0; i < (int)nodes.size(); i++)
+        state.alive[i] = nodes[i].last - nodes[i].first;
+    state.removed.assign(order.size(), 0);
+}
+
+void CityTree::Remove(tRemovalState &state, int city) const
+{
+    if(state.removed[city])
+        return;
+
+    state.removed[city] = 1;
+    for(int node = cityLeaf[city]; node >= 0; node = nodes[node].parent)
+        state.alive[node]--;
+}
+
+int CityTree::NearestAlive(const tRemovalState &state, int city) const
+{
+    int best = -1;
+    double bestDistance = 0;
+    if(!nodes.empty())
+        SearchAlive(state, 0, city, best, bestDistance);
+    return best;
+}
+
+void CityTree::SearchAlive(const tRemovalState &state, int node, int city, int &best, double &bestDistance) const
+{
+    // Uzly bez neodebranych mest se preskoci
+    if(state.alive[node] == 0)
+        return;
+
+    const tNode &current = nodes[node];
+    const CityPosition &p = (*cityPosition)[city];
+
+    if(current.left < 0)
+    {
+        for(int i = current.first; i < current.last; i++)
+        {
+            int other = order[i];
+            if(state.removed[other])
+                continue;
+
+            double dX = p.x - (*cityPosition)[other].x;
+            double dY = p.y - (*cityPosition)[other].y;
+            double distance = dX * dX + dY * dY;
+            if(best < 0 || distance < bestDistance)
+            {
+                best = other;
+                bestDistance = distance;
+            }
+        }
+        return;
+    }
+
+    double difference = ((current.axis == 0) ? p.x : p.y) - current.split;
+    int nearChild = (difference <= 0) ? current.left : current.right;
+    int farChild = (difference <= 0) ? current.right : current.left;
+    SearchAlive(state, nearChild, city, best, bestDistance);
+    if(best < 0 || difference * difference < bestDistance)
+        SearchAlive(state, farChild, city, best, bestDistance);
+}
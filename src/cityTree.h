@@ -0,0 +1,140 @@
+/**
+* \file cityTree.h
+* K-d strom nad souradnicemi mest (hledani nejblizsich mest).
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef CITYTREE_H_INCLUDED
+#define CITYTREE_H_INCLUDED
+
+#include <vector>
+#include "tsp_evolution.h"
+
+using namespace std;
+
+/**
+ * K-d strom nad souradnicemi mest. Uzly se deli medianem podle delsi strany obalky mest uzlu,
+ * listy obsahuji nekolik mest. Vetev stromu se prohledava, jen pokud v ni muze lezet mesto blizsi
+ * nez dosud nalezene. Vzdalenost je eukleidovska; u vzdalenosti, ktere s ni rostou (CEIL_2D, ATT),
+ * jsou nalezena mesta take nejblizsi.
+ * Strom se po postaveni nemeni a muze jej soucasne pouzivat vice vlaken. Hledani s odebiranim mest
+ * (napr. nenavstivenych mest pri stavbe cesty) pracuje nad stavem tRemovalState, ktery ma kazde
+ * vlakno vlastni.
+ */
+class CityTree
+{
+    public:
+    /// Stav hledani s odebiranim mest.
+    typedef struct
+    {
+        vector<int> alive;       ///< Pocet neodebranych mest v kazdem uzlu.
+        vector<char> removed;    ///< Priznaky odebranych mest.
+    } tRemovalState;
+
+    private:
+    /// Uzel stromu.
+    typedef struct
+    {
+        int first;      ///< Prvni mesto uzlu v poli order.
+        int last;       ///< Pozice za poslednim mestem uzlu.
+        int left;       ///< Levy potomek (souradnice nejvyse split; -1 u listu).
+        int right;      ///< Pravy potomek (souradnice alespon split; -1 u listu).
+        int parent;     ///< Rodic (-1 u korene).
+        int axis;       ///< Delici osa (0 = X, 1 = Y).
+        double split;   ///< Delici souradnice.
+    } tNode;
+
+    const vector<CityPosition> *cityPosition;   ///< Pozice mest.
+    vector<tNode> nodes;                        ///< Uzly stromu (koren je prvni).
+    vector<int> order;                          ///< Mesta v poradi listu stromu.
+    vector<int> cityLeaf;                       ///< List, ve kterem kazde mesto lezi.
+
+    /**
+     * Postavi podstrom nad mesty order[first] az order[last - 1].
+     * @param first Prvni mesto.
+     * @param last Pozice za poslednim mestem.
+     * @param parent Rodic podstromu.
+     * @return Index korene podstromu.
+     */
+    int BuildNode(int first, int last, int parent);
+
+    /**
+     * Prohleda podstrom a zaradi blizka mesta mezi kandidaty.
+     * @param node Koren podstromu.
+     * @param city Mesto, jehoz sousede se hledaji.
+     * @param count Pocet hledanych sousedu.
+     * @param heap Halda kandidatu (druhe mocniny vzdalenosti a indexy mest, nejvzdalenejsi na vrcholu).
+     */
+    void SearchNearest(int node, int city, int count, vector<pair<double, int> > &heap) const;
+
+    /**
+     * Prohleda podstrom a najde nejblizsi neodebrane mesto.
+     * @param state Stav hledani s odebiranim mest.
+     * @param node Koren podstromu.
+     * @param city Mesto, k nemuz se hleda nejblizsi.
+     * @param best Dosud nejblizsi mesto (-1 = zadne).
+     * @param bestDistance Druha mocnina vzdalenosti dosud nejblizsiho mesta.
+     */
+    void SearchAlive(const tRemovalState &state, int node, int city, int &best, double &bestDistance) const;
+
+    public:
+    /**
+    * Konstruktor.
+    */
+    CityTree();
+
+    /**
+     * Postavi strom nad mesty.
+     * @param cityPosition Pozice mest (musi existovat po celou dobu pouzivani stromu).
+     */
+    void Build(const vector<CityPosition> &cityPosition);
+
+    /**
+     * Uvolni strom.
+     */
+    void Clear();
+
+    /**
+     * Zjisti, zda-li je strom prazdny.
+     * @return True, nebyl-li strom postaven.
+     */
+    bool IsEmpty() const { return nodes.empty(); }
+
+    /**
+     * Vrati mesta v poradi listu stromu (blizka mesta jsou blizko sebe).
+     * @return Mesta v poradi listu.
+     */
+    const vector<int> &GetOrder() const { return order; }
+
+    /**
+     * Najde nejblizsi mesta.
+     * @param city Mesto, jehoz sousede se hledaji (samo se mezi ne nezaradi).
+     * @param count Pocet hledanych sousedu.
+     * @param neighbours Nalezena mesta serazena podle vzdalenosti (nejvyse count).
+     * @param heap Pomocna halda (aby se pri opakovanem hledani nealokovala).
+     */
+    void Nearest(int city, int count, vector<int> &neighbours, vector<pair<double, int> > &heap) const;
+
+    /**
+     * Pripravi stav hledani s odebiranim mest (vsechna mesta jsou neodebrana).
+     * @param state Stav hledani.
+     */
+    void ResetState(tRemovalState &state) const;
+
+    /**
+     * Odebere mesto ze stavu hledani.
+     * @param state Stav hledani.
+     * @param city Odebirane mesto.
+     */
+    void Remove(tRemovalState &state, int city) const;
+
+    /**
+     * Najde nejblizsi neodebrane mesto.
+     * @param state Stav hledani.
+     * @param city Mesto, k nemuz se hleda nejblizsi (samo se vrati jen, neni-li odebrane).
+     * @return Nejblizsi neodebrane mesto (-1, jsou-li odebrana vsechna).
+     */
+    int NearestAlive(const tRemovalState &state, int city) const;
+};
+
+#endif // CITYTREE_H_INCLUDED
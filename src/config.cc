@@ -12,6 +12,36 @@ Config::Config()
     pMutation = 0.1;
     tMutation = OPT_2;
     tCrossover = OX;
+    profiling = false;
+    perfCounters = false;
+    metricsPort = 0;
+    checkpointInterval = 1000;
+    resume = false;
+    integerDistances = false;
+    matrixMemoryLimit = 0;
+    hilbertOrder = false;
+    statisticsInterval = 1;
+    timeLimit = 0;
+    targetPrice = 0;
+    stagnationGenerations = 0;
+    minDiversity = 0;
+    steadyStateChildren = 0;
+    fitnessCacheSize = 0;
+    noDuplicates = false;
+    selfAdaptive = false;
+    adaptiveWindow = 1000;
+    adaptiveExploration = 0.5;
+    restartGenerations = 0;
+    restartThreshold = 0.001;
+    archiveSize = 8;
+    initRandom = 1;
+    initNearest = 0;
+    initGreedy = 0;
+    initCurve = 0;
+    localSearch = 0;
+    localSearchNeighbours = 8;
+    localSearchMethod = LS_2OPT;
+    polishTime = 0;
 }
 
 Config::~Config()
@@ -64,6 +94,10 @@ bool Config::LoadConfiguration(string configFile)
                 tMutation = OPT_3;
             else if(paramValue == "SWAP")
                 tMutation = SWAP;
+            else if(paramValue == "INVERSION")
+                tMutation = INVERSION;
+            else if(paramValue == "ADAPTIVE")
+                tMutation = ADAPTIVE_MUTATION;
         }
         else if(paramName == "T_CROSSOVER")
         {
@@ -75,7 +109,104 @@ bool Config::LoadConfiguration(string configFile)
                 tCrossover = OX;
             else if(paramValue == "CX")
                 tCrossover = CX;
+            else if(paramValue == "ADAPTIVE")
+                tCrossover = ADAPTIVE_CROSSOVER;
         }
+        else if(paramName == "PROFILING")
+            profiling = (atoi(paramValue.c_str()) != 0);
+        else if(paramName == "PERF_COUNTERS")
+            perfCounters = (atoi(paramValue.c_str()) != 0);
+        else if(paramName == "METRICS_PORT")
+            metricsPort = atoi(paramValue.c_str());
+        else if(paramName == "METRICS_SOCKET")
+            metricsSocket = paramValue;
+        else if(paramName == "CHECKPOINT_FILE")
+            checkpointFile = paramValue;
+        else if(paramName == "CHECKPOINT_INTERVAL")
+            checkpointInterval = atoi(paramValue.c_str());
+        else if(paramName == "RESUME")
+            resume = (atoi(paramValue.c_str()) != 0);
+        else if(paramName == "INTEGER_DISTANCES")
+            integerDistances = (atoi(paramValue.c_str()) != 0);
+        else if(paramName == "MATRIX_MEMORY_LIMIT")
+            matrixMemoryLimit = atoi(paramValue.c_str());
+        else if(paramName == "HILBERT_ORDER")
+            hilbertOrder = (atoi(paramValue.c_str()) != 0);
+        else if(paramName == "STATISTICS_FILE")
+            statisticsFile = paramValue;
+        else if(paramName == "STATISTICS_INTERVAL")
+        {
+            statisticsInterval = atoi(paramValue.c_str());
+            if(statisticsInterval < 1)
+                statisticsInterval = 1;
+        }
+        else if(paramName == "TIME_LIMIT")
+            timeLimit = atof(paramValue.c_str());
+        else if(paramName == "TARGET_PRICE")
+            targetPrice = atof(paramValue.c_str());
+        else if(paramName == "STAGNATION_GENERATIONS")
+            stagnationGenerations = atoi(paramValue.c_str());
+        else if(paramName == "MIN_DIVERSITY")
+            minDiversity = atof(paramValue.c_str());
+        else if(paramName == "STEADY_STATE")
+        {
+            steadyStateChildren = atoi(paramValue.c_str());
+            if(steadyStateChildren < 0)
+                steadyStateChildren = 0;
+        }
+        else if(paramName == "FITNESS_CACHE")
+        {
+            fitnessCacheSize = atoi(paramValue.c_str());
+            if(fitnessCacheSize < 0)
+                fitnessCacheSize = 0;
+        }
+        else if(paramName == "NO_DUPLICATES")
+            noDuplicates = (atoi(paramValue.c_str()) != 0);
+        else if(paramName == "SELF_ADAPTIVE")
+            selfAdaptive = (atoi(paramValue.c_str()) != 0);
+        else if(paramName == "ADAPTIVE_WINDOW")
+        {
+            adaptiveWindow = atoi(paramValue.c_str());
+            if(adaptiveWindow < 1)
+                adaptiveWindow = 1;
+        }
+        else if(paramName == "ADAPTIVE_EXPLORATION")
+            adaptiveExploration = atof(paramValue.c_str());
+        else if(paramName == "RESTART_GENERATIONS")
+            restartGenerations = atoi(paramValue.c_str());
+        else if(paramName == "RESTART_THRESHOLD")
+            restartThreshold = atof(paramValue.c_str());
+        else if(paramName == "ARCHIVE_SIZE")
+        {
+            archiveSize = atoi(paramValue.c_str());
+            if(archiveSize < 1)
+                archiveSize = 1;
+        }
+        else if(paramName == "INIT_RANDOM")
+            initRandom = atof(paramValue.c_str());
+        else if(paramName == "INIT_NEAREST")
+            initNearest = atof(paramValue.c_str());
+        else if(paramName == "INIT_GREEDY")
+            initGreedy = atof(paramValue.c_str());
+        else if(paramName == "INIT_CURVE")
+            initCurve = atof(paramValue.c_str());
+        else if(paramName == "LOCAL_SEARCH")
+            localSearch = atof(paramValue.c_str());
+        else if(paramName == "LOCAL_SEARCH_NEIGHBOURS")
+        {
+            localSearchNeighbours = atoi(paramValue.c_str());
+            if(localSearchNeighbours < 1)
+                localSearchNeighbours = 1;
+        }
+        else if(paramName == "LOCAL_SEARCH_METHOD")
+        {
+            if(paramValue == "2OPT")
+                localSearchMethod = LS_2OPT;
+            else if(paramValue == "LK")
+                localSearchMethod = LS_LK;
+        }
+        else if(paramName == "POLISH_TIME")
+            polishTime = atof(paramValue.c_str());
     }
 
     // Osetreni nespravne konfigurace
@@ -19,7 +19,8 @@ enum E_MUTATION
     SWAP = 0,          ///< Modifikace cesty prostou vymennou dvou uzlu.
     OPT_2 = 1,         ///< Modifikace cesty metodou 2-OPT.
     OPT_3 = 2,         ///< Modifikace cesty metodou 3-OPT.
-    INVERSION = 3      ///< Modifikace cesty zamenou useku delsich useku cesty.
+    INVERSION = 3,     ///< Modifikace cesty zamenou useku delsich useku cesty.
+    ADAPTIVE_MUTATION = 4   ///< Adaptivni vyber z predchozich operatoru (zaroven jejich pocet).
 };
 
 /// Typy pouzitych operatoru krizeni.
@@ -28,7 +29,15 @@ enum E_CROSSOVER
     PMX = 0,   ///< Krizeni metodou "Partially matched crossover".
     ERX = 1,   ///< Krizeni metodou "Edge recombination crossover".
     OX = 2,    ///< Krizeni metodou "Order crossover".
-    CX = 3     ///< Krizeni metodou "Cycle crossover".
+    CX = 3,    ///< Krizeni metodou "Cycle crossover".
+    ADAPTIVE_CROSSOVER = 4   ///< Adaptivni vyber z predchozich operatoru (zaroven jejich pocet).
+};
+
+/// Metody lokalniho prohledavani.
+enum E_LOCAL_SEARCH
+{
+    LS_2OPT = 0,   ///< Tahy 2-opt a Or-opt.
+    LS_LK = 1      ///< Tahy Lin-Kernighanova typu s promennou hloubkou a Or-opt.
 };
 
 /// Spravce konfiguracnich udaju.
@@ -56,6 +65,39 @@ class Config
     float pMutation;         ///< Pravdepodobnost mutace.
     E_MUTATION tMutation;    ///< Typ operatoru mutace.
     E_CROSSOVER tCrossover;  ///< Typ operatoru krizeni.
+    bool profiling;          ///< Udava, zda-li se meri doba behu jednotlivych fazi evolucniho kroku.
+    bool perfCounters;       ///< Udava, zda-li se behem fazi snimaji hardwarove citace procesoru.
+    int metricsPort;         ///< TCP port pro export prubeznych metrik (0 = export vypnut).
+    string metricsSocket;    ///< Cesta k Unix socketu pro export prubeznych metrik.
+    string checkpointFile;   ///< Cesta k souboru s kontrolnim bodem (prazdna = kontrolni body se neukladaji).
+    int checkpointInterval;  ///< Pocet generaci mezi ulozenim kontrolnich bodu.
+    bool resume;             ///< Udava, zda-li se ma vypocet obnovit z kontrolniho bodu.
+    bool integerDistances;   ///< Udava, zda-li se maji pouzit celociselne vzdalenosti (nint podle TSPLIB).
+    int matrixMemoryLimit;   ///< Maximalni velikost matice vzdalenosti v MB (0 = neomezeno).
+    bool hilbertOrder;       ///< Udava, zda-li se maji mesta precislovat podel Hilbertovy krivky.
+    string statisticsFile;   ///< Soubor pro prubezny zapis statistik generaci (prazdny = nezapisuji se).
+    int statisticsInterval;  ///< Pocet generaci mezi zaznamy statistik.
+    double timeLimit;        ///< Casovy limit vypoctu v sekundach (0 = neomezeno).
+    double targetPrice;      ///< Cilova cena cesty, po jejimz dosazeni se vypocet ukonci (0 = neomezeno).
+    int stagnationGenerations;  ///< Pocet generaci bez zlepseni, po kterem se vypocet ukonci (0 = neomezeno).
+    int steadyStateChildren; ///< Pocet potomku v davce ustaleneho rezimu (0 = generacni rezim).
+    int fitnessCacheSize;    ///< Pocet polozek vyrovnavaci pameti cen cest (0 = pamet se nepouziva).
+    bool noDuplicates;       ///< Zakaz duplicitnich cest v populaci.
+    bool selfAdaptive;       ///< Samoadaptace pravdepodobnosti mutace a velikosti turnaje (pravidlo 1/5).
+    int adaptiveWindow;      ///< Delka pameti adaptivniho vyberu operatoru (pocet pouziti).
+    double adaptiveExploration;  ///< Vaha pruzkumu pri adaptivnim vyberu operatoru.
+    int restartGenerations;  ///< Pocet generaci se zkonvergovanou populaci bez zlepseni, po kterem se populace restartuje (0 = bez restartu).
+    double restartThreshold; ///< Relativni rozdil prumerne a nejlepsi ceny, pod kterym je populace zkonvergovana.
+    int archiveSize;         ///< Velikost archivu nejlepsich cest pro restarty.
+    double minDiversity;     ///< Minimalni diverzita populace (podil ruznych cen), pod kterou se vypocet ukonci (0 = neomezeno).
+    double initRandom;       ///< Podil nahodnych cest v pocatecni populaci.
+    double initNearest;      ///< Podil cest z randomizovane metody nejblizsiho souseda v pocatecni populaci.
+    double initGreedy;       ///< Podil cest z randomizovaneho hladoveho parovani hran v pocatecni populaci.
+    double initCurve;        ///< Podil cest podel Hilbertovy krivky v pocatecni populaci.
+    double localSearch;      ///< Podil potomku zlepsovanych lokalnim prohledavanim (0 = bez lokalniho prohledavani).
+    int localSearchNeighbours;  ///< Pocet nejblizsich sousedu zkousenych pri lokalnim prohledavani.
+    E_LOCAL_SEARCH localSearchMethod;  ///< Metoda lokalniho prohledavani potomku.
+    double polishTime;       ///< Casovy limit zaverecneho doladeni nejlepsi cesty v sekundach (0 = bez doladeni).
     static Config *configInstance;  ///< Reference na instanci objektu
     /*public:
     int neighbourhood;                      //< Celkovy pocet prvku ovlivnujici nasledujici stav bunky
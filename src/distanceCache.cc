@@ -0,0 +1,168 @@
+#include <QMutexLocker>
+#include <algorithm>
+#include "distanceCache.h"
+
+/// Maximalni pocet sekci vyrovnavaci pameti.
+static const int maxShardCount = 16;
+
+/// Podil ceny nacteni radku (dimenze), ktery musi chyby radku dosahnout, aby se radek nacetl.
+static const int admissionDivisor = 16;
+
+DistanceRowCache::DistanceRowCache(int dimension, long long memoryLimit, DistanceRowSource *source, bool symmetric)
+{
+    this->dimension = dimension;
+    this->source = source;
+    this->symmetric = symmetric;
+    admissionThreshold = max(1, dimension / admissionDivisor);
+
+    // Rozdeleni kapacity (alespon jeden radek v kazde sekci) mezi sekce
+    long long capacity = max(1LL, memoryLimit / ((long long)dimension * (long long)sizeof(float)));
+    capacity = min(capacity, (long long)dimension);
+    shardCount = (int)min((long long)maxShardCount, capacity);
+    slotCount = (int)(capacity / shardCount);
+
+    rowSlot.assign(dimension, -1);
+    rowMisses.assign(dimension, 0);
+    for(int i = 0; i < shardCount; i++)
+    {
+        tShard *shard = new tShard;
+        shard->rows.resize((size_t)slotCount * dimension);
+        shard->slotRow.assign(slotCount, -1);
+        shard->prev.assign(slotCount, -1);
+        shard->next.assign(slotCount, -1);
+        shard->head = shard->tail = -1;
+        shard->used = 0;
+        shard->hits = shard->misses = 0;
+        shards.push_back(shard);
+    }
+}
+
+DistanceRowCache::~DistanceRowCache()
+{
+    for(unsigned int i = 0; i < shards.size(); i++)
+        delete shards[i];
+    delete source;
+}
+
+void DistanceRowCache::Touch(tShard &shard, int slot)
+{
+    if(shard.head == slot)
+        return;
+
+    // Vyjmuti ze seznamu
+    if(shard.prev[slot] >= 0)
+        shard.next[shard.prev[slot]] = shard.next[slot];
+    if(shard.next[slot] >= 0)
+        shard.prev[shard.next[slot]] = shard.prev[slot];
+    if(shard.tail == slot)
+        shard.tail = shard.prev[slot];
+
+    // Vlozeni na zacatek
+    shard.prev[slot] = -1;
+    shard.next[slot] = shard.head;
+    if(shard.head >= 0)
+        shard.prev[shard.head] = slot;
+    shard.head = slot;
+    if(shard.tail < 0)
+        shard.tail = slot;
+}
+
+const float *DistanceRowCache::Find(int row)
+{
+    tShard &shard = *shards[row % shardCount];
+    int slot = rowSlot[row];
+    if(slot < 0)
+        return NULL;
+
+    shard.hits++;
+    Touch(shard, slot);
+    return &shard.rows[(size_t)slot * dimension];
+}
+
+float DistanceRowCache::Distance(int i, int j)
+{
+    tShard &shard = *shards[i % shardCount];
+
+    {   // radek prvniho mesta
+        QMutexLocker locker(&shard.mutex);
+        const float *row = Find(i);
+        if(row != NULL)
+            return row[j];
+    }
+
+    if(symmetric && i != j)
+    {   // radek druheho mesta
+        QMutexLocker locker(&shards[j % shardCount]->mutex);
+        const float *row = Find(j);
+        if(row != NULL)
+            return row[i];
+    }
+
+    QMutexLocker locker(&shard.mutex);
+    const float *row = Find(i);   // radek mohlo mezitim nacist jine vlakno
+    if(row != NULL)
+        return row[j];
+
+    shard.misses++;
+    if(++rowMisses[i] < admissionThreshold)
+        return source->Distance(i, j);
+    rowMisses[i] = 0;
+
+    // Nacteni radku do volneho slotu, pripadne do nejdele nepouziteho
+    int slot;
+    if(shard.used < slotCount)
+    {
+        slot = shard.used++;
+    }
+    else
+    {
+        slot = shard.tail;
+        rowSlot[shard.slotRow[slot]] = -1;
+    }
+
+    float *target = &shard.rows[(size_t)slot * dimension];
+    source->FillRow(i, target);
+    shard.slotRow[slot] = i;
+    rowSlot[i] = slot;
+    Touch(shard, slot);
+
+    return target[j];
+}
+
+void DistanceRowCache::CopyRow(int row, float *target)
+{
+    {
+        QMutexLocker locker(&shards[row % shardCount]->mutex);
+        const float *cached = Find(row);
+        if(cached != NULL)
+        {
+            copy(cached, cached + dimension, target);
+            return;
+        }
+    }
+
+    // Jednorazovy pruchod vsemi radky (napr. vypocet sousedu) nesmi vytlacit ulozene radky
+    source->FillRow(row, target);
+}
+
+long long DistanceRowCache::GetHits()
+{
+    long long hits = 0;
+    for(int i = 0; i < shardCount; i++)
+    {
+        QMutexLocker locker(&shards[i]->mutex);
+        hits += shards[i]->hits;
+    }
+    return hits;
+}
+
+long long DistanceRowCache::GetMisses()
+{
+    long long misses = 0;
+    for(int i = 0; i < shardCount; i++)
+    {
+        QMutexLocker locker(&shards[i]->mutex);
+        misses += shards[i]->misses;
+    }
+    return misses;
+}
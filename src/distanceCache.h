@@ -0,0 +1,142 @@
+/**
+* \file distanceCache.h
+* Omezena vyrovnavaci pamet radku matice vzdalenosti (pro ulohy, jejichz matice se nevejde do pameti).
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef DISTANCECACHE_H_INCLUDED
+#define DISTANCECACHE_H_INCLUDED
+
+#include <QMutex>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Zdroj radku matice vzdalenosti (vypocet ze souradnic, cteni z namapovaneho souboru apod.).
+ */
+class DistanceRowSource
+{
+    public:
+    /**
+     * Destruktor.
+     */
+    virtual ~DistanceRowSource() {}
+
+    /**
+     * Naplni radek matice (vola se soubezne z vice vlaken pro ruzne radky).
+     * @param row Index radku (mesta).
+     * @param target Cil pro vzdalenosti ke vsem mestum.
+     */
+    virtual void FillRow(int row, float *target) = 0;
+
+    /**
+     * Vrati jednu vzdalenost primo ze zdroje (pro radky, ktere nestoji za ulozeni).
+     * @param i Index prvniho mesta.
+     * @param j Index druheho mesta.
+     * @return Vzdalenost mest.
+     */
+    virtual float Distance(int i, int j) = 0;
+};
+
+/**
+ * Vyrovnavaci pamet radku matice vzdalenosti s omezenou velikosti a nahrazovanim LRU.
+ * Radky jsou rozdeleny do sekci podle indexu, kazda sekce ma vlastni zamek a vlastni
+ * seznam LRU, takze soubezne dotazy na ruzne radky na sebe vetsinou necekaji.
+ * U symetricke matice se pri chybe nejdrive zkusi radek druheho mesta.
+ * Radek se do pameti nacte az po urcitem poctu chyb (vyplati-li se cena jeho nacteni),
+ * do te doby se vzdalenost vraci primo ze zdroje; nahodny pristup (napr. ohodnocovani
+ * nahodnych cest) tak nevytlacuje radky, ktere se opakovane pouzivaji.
+ */
+class DistanceRowCache
+{
+    private:
+    /// Sekce vyrovnavaci pameti.
+    typedef struct
+    {
+        QMutex mutex;              ///< Zamek sekce.
+        vector<float> rows;        ///< Ulozene radky (slotCount * dimension vzdalenosti).
+        vector<int> slotRow;       ///< Index radku ulozeneho ve slotu.
+        vector<int> prev;          ///< Predchozi slot v seznamu LRU (-1 = zadny).
+        vector<int> next;          ///< Nasledujici slot v seznamu LRU (-1 = zadny).
+        int head;                  ///< Naposledy pouzity slot.
+        int tail;                  ///< Nejdele nepouzity slot.
+        int used;                  ///< Pocet obsazenych slotu.
+        long long hits;            ///< Pocet zasahu.
+        long long misses;          ///< Pocet chyb (cteni ze zdroje).
+    } tShard;
+
+    int dimension;                 ///< Pocet mest.
+    int shardCount;                ///< Pocet sekci.
+    int slotCount;                 ///< Pocet slotu (radku) v kazde sekci.
+    bool symmetric;                ///< Udava, zda-li je matice symetricka.
+    int admissionThreshold;        ///< Pocet chyb, po kterem se radek nacte do pameti.
+    vector<int> rowSlot;           ///< Slot, ve kterem je radek ulozen (-1 = neni); chranen zamkem sekce radku.
+    vector<int> rowMisses;         ///< Pocet chyb radku od posledniho nacteni; chranen zamkem sekce radku.
+    vector<tShard *> shards;       ///< Sekce.
+    DistanceRowSource *source;     ///< Zdroj radku.
+
+    /**
+     * Presune slot na zacatek seznamu LRU (zamek sekce musi byt drzen).
+     * @param shard Sekce.
+     * @param slot Slot.
+     */
+    void Touch(tShard &shard, int slot);
+
+    /**
+     * Vyhleda radek v jeho sekci (zamek sekce musi byt drzen).
+     * @param row Index radku.
+     * @return Ukazatel na radek, nebo NULL, neni-li radek ulozen.
+     */
+    const float *Find(int row);
+
+    public:
+    /**
+    * Konstruktor.
+    * @param dimension Pocet mest.
+    * @param memoryLimit Maximalni velikost ulozenych radku v bajtech.
+    * @param source Zdroj radku (vyrovnavaci pamet jej uvolni).
+    * @param symmetric Udava, zda-li je matice symetricka.
+    */
+    DistanceRowCache(int dimension, long long memoryLimit, DistanceRowSource *source, bool symmetric);
+
+    /**
+     * Destruktor.
+     */
+    ~DistanceRowCache();
+
+    /**
+     * Vrati vzdalenost mezi dvema mesty (pri chybe ji vezme ze zdroje, pripadne nacte radek prvniho mesta).
+     * @param i Index prvniho mesta.
+     * @param j Index druheho mesta.
+     * @return Vzdalenost mest.
+     */
+    float Distance(int i, int j);
+
+    /**
+     * Zkopiruje cely radek (ulozeny radek pod jednim zamknutim, jinak primo ze zdroje bez ulozeni).
+     * @param row Index radku (mesta).
+     * @param target Cil pro vzdalenosti ke vsem mestum.
+     */
+    void CopyRow(int row, float *target);
+
+    /**
+     * Vrati pocet radku, ktere se vejdou do vyrovnavaci pameti.
+     * @return Kapacita v radcich.
+     */
+    int GetCapacity() const { return shardCount * slotCount; }
+
+    /**
+     * Vrati pocet zasahu od vytvoreni.
+     * @return Pocet zasahu.
+     */
+    long long GetHits();
+
+    /**
+     * Vrati pocet chyb od vytvoreni.
+     * @return Pocet chyb.
+     */
+    long long GetMisses();
+};
+
+#endif // DISTANCECACHE_H_INCLUDED
@@ -0,0 +1,67 @@
+#include "indexedHeap.h"
+
+void IndexedHeap::Swap(int position1, int position2)
+{
+    int index = heap[position1];
+    heap[position1] = heap[position2];
+    heap[position2] = index;
+    position[heap[position1]] = position1;
+    position[heap[position2]] = position2;
+}
+
+void IndexedHeap::SiftUp(int pos)
+{
+    while(pos > 0)
+    {
+        int parent = (pos - 1) / 2;
+        if(key[heap[parent]] >= key[heap[pos]])
+            break;
+        Swap(pos, parent);
+        pos = parent;
+    }
+}
+
+void IndexedHeap::SiftDown(int pos)
+{
+    int size = heap.size();
+    while(true)
+    {
+        int largest = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        if(left < size && key[heap[left]] > key[heap[largest]])
+            largest = left;
+        if(right < size && key[heap[right]] > key[heap[largest]])
+            largest = right;
+        if(largest == pos)
+            break;
+        Swap(pos, largest);
+        pos = largest;
+    }
+}
+
+void IndexedHeap::Build(const vector<double> &keys)
+{
+    int size = keys.size();
+    key = keys;
+    heap.resize(size);
+    position.resize(size);
+    for(int i = 0; i < size; i++)
+    {
+        heap[i] = i;
+        position[i] = i;
+    }
+
+    for(int i = size / 2 - 1; i >= 0; i--)
+        SiftDown(i);
+}
+
+void IndexedHeap::Update(int index, double newKey)
+{
+    double oldKey = key[index];
+    key[index] = newKey;
+    if(newKey > oldKey)
+        SiftUp(position[index]);
+    else
+        SiftDown(position[index]);
+}
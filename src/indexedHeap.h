@@ -0,0 +1,72 @@
+/**
+* \file indexedHeap.h
+* Indexovana halda (nejvyssi klic na vrcholu) se zmenou klice libovolne polozky.
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef INDEXEDHEAP_H_INCLUDED
+#define INDEXEDHEAP_H_INCLUDED
+
+#include <vector>
+
+using namespace std;
+
+/**
+ * Binarni halda nad indexy 0 .. n-1 s klici typu double, na vrcholu je index s nejvyssim klicem.
+ * Halda si pamatuje pozici kazdeho indexu, takze klic libovolne polozky lze zmenit v case
+ * O(log n) (pouziva se pro nahrazovani nejhorsiho jedince populace, klicem je cena cesty).
+ */
+class IndexedHeap
+{
+    private:
+    vector<double> key;     ///< Klice indexu.
+    vector<int> heap;       ///< Indexy v poradi haldy.
+    vector<int> position;   ///< Pozice indexu v halde.
+
+    /**
+     * Prohodi dve pozice haldy.
+     * @param position1 Prvni pozice.
+     * @param position2 Druha pozice.
+     */
+    void Swap(int position1, int position2);
+
+    /**
+     * Presune polozku smerem k vrcholu, dokud ma vyssi klic nez jeji rodic.
+     * @param pos Pozice polozky.
+     */
+    void SiftUp(int pos);
+
+    /**
+     * Presune polozku smerem od vrcholu, dokud ma nizsi klic nez nektery jeji potomek.
+     * @param pos Pozice polozky.
+     */
+    void SiftDown(int pos);
+
+    public:
+    /**
+     * Sestavi haldu z klicu (v case O(n)).
+     * @param keys Klice indexu 0 .. keys.size()-1.
+     */
+    void Build(const vector<double> &keys);
+
+    /**
+     * Vrati pocet polozek.
+     * @return Pocet polozek.
+     */
+    int Size() const { return heap.size(); }
+
+    /**
+     * Vrati index s nejvyssim klicem (halda nesmi byt prazdna).
+     * @return Index na vrcholu haldy.
+     */
+    int Top() const { return heap[0]; }
+
+    /**
+     * Zmeni klic indexu a obnovi usporadani haldy (v case O(log n)).
+     * @param index Index polozky.
+     * @param newKey Novy klic.
+     */
+    void Update(int index, double newKey);
+};
+
+#endif // INDEXEDHEAP_H_INCLUDED
@@ -0,0 +1,501 @@
+#include <algorithm>
+#include "localSearch.h"
+
+/// Nejmensi zisk tahu, ktery se povazuje za zlepseni (chrani pred zacyklenim na zaokrouhlovacich chybach).
+static const double minGain = 1e-7;
+
+/// Nejdelsi presouvany usek tahu Or-opt.
+static const int maxSegment = 3;
+
+/// Nejmensi pocet mest, pro ktery se lokalni prohledavani provadi.
+static const int minDimension = 8;
+
+/// Objem prace (pocet jedincu * pocet mest), od ktereho se prohledavani rozdeluje mezi vice vlaken.
+static const long long parallelThreshold = 1 << 14;
+
+/// Pocet zpracovanych mest mezi kontrolami priznaku preruseni a casoveho limitu.
+static const int cancelCheckInterval = 256;
+
+/// Nejvetsi hloubka tahu LK (pocet skladanych tahu 2-opt).
+static const int lkDepth = 6;
+
+/// Pocet zkousenych kandidatu t3 v jednotlivych urovnich tahu LK (v hlubsich urovnich jeden).
+static const int lkBreadth[] = {5, 3, 1};
+
+/// Pocet urovni tahu LK s vice kandidaty.
+static const int lkBreadthLevels = sizeof(lkBreadth) / sizeof(lkBreadth[0]);
+
+/// Nejdelsi usek prohazovany pri naruseni cesty v zaverecnem doladeni.
+static const int maxKickSegment = 50;
+
+LocalSearch::LocalSearch()
+{
+    cityMatrix = NULL;
+    cityNeighbours = NULL;
+    neighbourCount = 0;
+    dimension = 0;
+    population = NULL;
+    selected = NULL;
+    tourGains = NULL;
+    cancelToken = NULL;
+    method = LS_2OPT;
+    deadline = 0;
+    gain = 0;
+}
+
+void LocalSearch::Improve(const CityMatrix &cityMatrix, const CityNeighbours &cityNeighbours, int neighbourCount,
+                          vector<tIndividual> &population, const vector<int> &selected, CancellationToken &cancelToken,
+                          E_LOCAL_SEARCH method, double timeLimit, vector<double> *tourGains)
+{
+    moveCount = 0;
+    improvedCount = 0;
+    gain = 0;
+    dimension = cityMatrix.GetDimension();
+    if(tourGains != NULL)
+        tourGains->assign(selected.size(), 0);
+    if(dimension < minDimension || selected.empty())
+        return;
+
+    this->cityMatrix = &cityMatrix;
+    this->cityNeighbours = &cityNeighbours;
+    this->neighbourCount = min(neighbourCount, cityNeighbours.GetCount());
+    this->population = &population;
+    this->selected = &selected;
+    this->tourGains = tourGains;
+    this->cancelToken = &cancelToken;
+    this->method = method;
+    deadline = (timeLimit > 0) ? PhaseProfiler::Now() + (long long)(timeLimit * 1e9) : 0;
+    nextIndividual = 0;
+
+    int threadCount = 1;
+    if((long long)selected.size() * dimension >= parallelThreshold)
+        threadCount = max(1, min(QThread::idealThreadCount(), (int)selected.size()));
+
+    vector<Worker *> workers;
+    for(int i = 1; i < threadCount; i++)
+    {
+        workers.push_back(new Worker(this));
+        workers.back()->start();
+    }
+
+    // Volajici vlakno pracuje take
+    Work();
+
+    for(unsigned int i = 0; i < workers.size(); i++)
+    {
+        workers[i]->wait();
+        delete workers[i];
+    }
+
+    this->cityMatrix = NULL;
+    this->cityNeighbours = NULL;
+    this->population = NULL;
+    this->selected = NULL;
+    this->tourGains = NULL;
+    this->cancelToken = NULL;
+}
+
+bool LocalSearch::Stopped() const
+{
+    return cancelToken->IsCancelled() || (deadline > 0 && PhaseProfiler::Now() >= deadline);
+}
+
+void LocalSearch::Work()
+{
+    tContext context;
+    context.position.resize(dimension);
+    context.queue.resize(dimension);
+    context.queued.resize(dimension);
+
+    double workGain = 0;
+    while(!Stopped())
+    {
+        int index = nextIndividual.fetchAndAddOrdered(1);
+        if(index >= (int)selected->size())
+            break;
+
+        tIndividual &individual = (*population)[(*selected)[index]];
+        double tourGain = 0;
+        int moves = ImproveTour(context, individual.genome, tourGain);
+        workGain += tourGain;
+        if(tourGains != NULL)
+            (*tourGains)[index] = tourGain;
+        if(moves > 0)
+        {
+            individual.hash = 0;
+            moveCount.fetchAndAddOrdered(moves);
+            improvedCount.fetchAndAddOrdered(1);
+        }
+    }
+
+    gainMutex.lock();
+    gain += workGain;
+    gainMutex.unlock();
+}
+
+int LocalSearch::Polish(const CityMatrix &cityMatrix, const CityNeighbours &cityNeighbours, int neighbourCount,
+                        vector<int> &tour, CancellationToken &cancelToken, double timeLimit, RandomGenerator &rng)
+{
+    moveCount = 0;
+    improvedCount = 0;
+    gain = 0;
+    dimension = cityMatrix.GetDimension();
+    if(dimension < minDimension)
+        return 0;
+
+    this->cityMatrix = &cityMatrix;
+    this->cityNeighbours = &cityNeighbours;
+    this->neighbourCount = min(neighbourCount, cityNeighbours.GetCount());
+    this->cancelToken = &cancelToken;
+    method = LS_LK;
+    deadline = (timeLimit > 0) ? PhaseProfiler::Now() + (long long)(timeLimit * 1e9) : 0;
+
+    tContext context;
+    context.position.resize(dimension);
+    context.queue.resize(dimension);
+    context.queued.resize(dimension);
+
+    // Nejprve lokalni optimum cele cesty
+    double tourGain = 0;
+    int moves = ImproveTour(context, tour, tourGain);
+    vector<int> best(tour);
+    double bestGain = tourGain;
+
+    // Bez casoveho limitu by narusovani nikdy neskoncilo
+    int kicks = 0;
+    while(deadline > 0 && !Stopped())
+    {
+        kicks++;
+        tourGain += Kick(context, rng);
+        moves += ProcessQueue(context, tourGain);
+
+        if(tourGain > bestGain + minGain)
+        {   // Zlepseni se prijme
+            bestGain = tourGain;
+            best = tour;
+        }
+        else
+        {   // Jinak se pokracuje z nejlepsi cesty
+            tour = best;
+            tourGain = bestGain;
+            for(int i = 0; i < dimension; i++)
+                context.position[tour[i]] = i;
+        }
+    }
+
+    moveCount = moves;
+    improvedCount = (bestGain > 0) ? 1 : 0;
+    gain = bestGain;
+    this->cityMatrix = NULL;
+    this->cityNeighbours = NULL;
+    this->cancelToken = NULL;
+    return kicks;
+}
+
+double LocalSearch::Kick(tContext &context, RandomGenerator &rng)
+{
+    // Lokalni double-bridge: za mestem a se prohodi sousedni useky B = b1..b2 a C = c1..c2
+    vector<int> &tour = *context.tour;
+    int window = min(maxKickSegment, (dimension - 2) / 2);
+    int lengthB = 1 + rng.Int(window);
+    int lengthC = 1 + rng.Int(window);
+    int start = rng.Int(dimension);
+
+    int a = tour[start];
+    int b1 = tour[(start + 1) % dimension];
+    int b2 = tour[(start + lengthB) % dimension];
+    int c1 = tour[(start + lengthB + 1) % dimension];
+    int c2 = tour[(start + lengthB + lengthC) % dimension];
+    int d = tour[(start + lengthB + lengthC + 1) % dimension];
+    double kickGain = cityMatrix->Distance(a, b1) + cityMatrix->Distance(b2, c1) + cityMatrix->Distance(c2, d)
+                    - cityMatrix->Distance(a, c1) - cityMatrix->Distance(c2, b1) - cityMatrix->Distance(b2, d);
+
+    context.segment.clear();
+    for(int i = lengthB + 1; i <= lengthB + lengthC; i++)
+        context.segment.push_back(tour[(start + i) % dimension]);
+    for(int i = 1; i <= lengthB; i++)
+        context.segment.push_back(tour[(start + i) % dimension]);
+    for(int i = 0; i < (int)context.segment.size(); i++)
+    {
+        int pos = (start + 1 + i) % dimension;
+        tour[pos] = context.segment[i];
+        context.position[tour[pos]] = pos;
+    }
+
+    Push(context, a);
+    Push(context, b1);
+    Push(context, b2);
+    Push(context, c1);
+    Push(context, c2);
+    Push(context, d);
+    return kickGain;
+}
+
+int LocalSearch::ImproveTour(tContext &context, vector<int> &tour, double &tourGain)
+{
+    // Index pozic a fronta se vsemi mesty v poradi cesty
+    context.tour = &tour;
+    for(int i = 0; i < dimension; i++)
+    {
+        context.position[tour[i]] = i;
+        context.queue[i] = tour[i];
+        context.queued[tour[i]] = 1;
+    }
+    context.queueHead = 0;
+    context.queueSize = dimension;
+
+    return ProcessQueue(context, tourGain);
+}
+
+int LocalSearch::ProcessQueue(tContext &context, double &tourGain)
+{
+    int moves = 0;
+    int processed = 0;
+    while(context.queueSize > 0)
+    {
+        if(++processed % cancelCheckInterval == 0 && Stopped())
+            break;
+
+        int city = context.queue[context.queueHead];
+        context.queueHead = (context.queueHead + 1 == dimension) ? 0 : context.queueHead + 1;
+        context.queueSize--;
+        context.queued[city] = 0;
+
+        double moveGain = ImproveCity(context, city);
+        if(moveGain > 0)
+        {
+            tourGain += moveGain;
+            moves++;
+        }
+    }
+
+    return moves;
+}
+
+double LocalSearch::ImproveCity(tContext &context, int a)
+{
+    const int *neighbour = cityNeighbours->Of(a);
+
+    // 2-opt: nova hrana (a, c) nahradi hranu (a, b) mesta a k naslednikovi, resp. predchudci
+    for(int dir = 0; dir < 2; dir++)
+    {
+        int b = (dir == 0) ? Next(context, a) : Prev(context, a);
+        double distanceAB = cityMatrix->Distance(a, b);
+        for(int k = 0; k < neighbourCount; k++)
+        {
+            int c = neighbour[k];
+            double gain = distanceAB - cityMatrix->Distance(a, c);
+            if(gain <= minGain)
+                break;
+
+            int d = (dir == 0) ? Next(context, c) : Prev(context, c);
+            if(c == b || d == a)
+                continue;
+            double moveGain = gain + cityMatrix->Distance(c, d) - cityMatrix->Distance(b, d);
+            if(moveGain > minGain)
+            {
+                Move2(context, a, b, c, d);
+                Push(context, a);
+                Push(context, b);
+                Push(context, c);
+                Push(context, d);
+                return moveGain;
+            }
+        }
+    }
+
+    // Or-opt: usek s1 .. s2 obsahujici mesto a na kraji se presune mezi mesta x a y = Next(x)
+    for(int length = 1; length <= maxSegment; length++)
+    {
+        for(int dir = 0; dir < 2; dir++)
+        {
+            int s1 = a, s2 = a;
+            for(int i = 1; i < length; i++)
+            {
+                if(dir == 0)
+                    s2 = Next(context, s2);
+                else
+                    s1 = Prev(context, s1);
+            }
+            int p = Prev(context, s1), n = Next(context, s2);
+            double removeGain = cityMatrix->Distance(p, s1) + cityMatrix->Distance(s2, n) - cityMatrix->Distance(p, n);
+            if(removeGain <= minGain)
+                continue;
+
+            int segmentStart = context.position[s1];
+            for(int end = 0; end < 2; end++)
+            {
+                // Mesto c je soused kraje useku, ke kteremu se usek pripoji
+                int segmentEnd = (end == 0) ? s1 : s2;
+                int otherEnd = (end == 0) ? s2 : s1;
+                const int *endNeighbour = cityNeighbours->Of(segmentEnd);
+                for(int k = 0; k < neighbourCount; k++)
+                {
+                    int c = endNeighbour[k];
+                    double distanceC = cityMatrix->Distance(segmentEnd, c);
+                    if(distanceC >= removeGain)
+                        break;
+                    if((context.position[c] - segmentStart + dimension) % dimension < length)
+                        continue;
+
+                    for(int side = 0; side < 2; side++)
+                    {
+                        int e = (side == 0) ? Next(context, c) : Prev(context, c);
+                        if((context.position[e] - segmentStart + dimension) % dimension < length)
+                            continue;
+                        double insertCost = distanceC + cityMatrix->Distance(otherEnd, e) - cityMatrix->Distance(c, e);
+                        if(removeGain - insertCost <= minGain)
+                            continue;
+
+                        // Presun trojici tahu 2-opt (bez posledniho tahu se usek vlozi otoceny)
+                        int x = (side == 0) ? c : e;
+                        int y = (side == 0) ? e : c;
+                        int xEnd = (side == 0) ? segmentEnd : otherEnd;
+                        Move2(context, p, s1, x, y);
+                        Move2(context, p, x, n, s2);
+                        if(xEnd == s1)
+                            Move2(context, x, s2, s1, y);
+
+                        Push(context, a);
+                        Push(context, p);
+                        Push(context, n);
+                        Push(context, s1);
+                        Push(context, s2);
+                        Push(context, x);
+                        Push(context, y);
+                        return removeGain - insertCost;
+                    }
+                }
+            }
+        }
+    }
+
+    // LK: hlubsi tahy se hledaji az u mest, ktera jsou optimalni vuci tahum 2-opt a Or-opt
+    if(method == LS_LK)
+        return MoveLK(context, a);
+
+    return 0;
+}
+
+double LocalSearch::MoveLK(tContext &context, int t1)
+{
+    for(int dir = 0; dir < 2; dir++)
+    {
+        int t2 = (dir == 0) ? Next(context, t1) : Prev(context, t1);
+        double bestGain = 0;
+        int bestDepth = 0;
+        context.moves.clear();
+        if(!SearchLK(context, t1, t2, cityMatrix->Distance(t1, t2), 0, bestGain, bestDepth))
+            continue;
+
+        // Tahy za nejlepsi urovni se vrati, mesta zmenenych hran se znovu aktivuji
+        while((int)context.moves.size() > 4 * bestDepth)
+            UndoMove(context);
+        for(int i = 0; i < (int)context.moves.size(); i++)
+            Push(context, context.moves[i]);
+        return bestGain;
+    }
+
+    return 0;
+}
+
+bool LocalSearch::SearchLK(tContext &context, int t1, int t2, double gain, int level, double &bestGain, int &bestDepth)
+{
+    int breadth = (level < lkBreadthLevels) ? lkBreadth[level] : 1;
+    const int *neighbour = cityNeighbours->Of(t2);
+    for(int k = 0, tried = 0; k < neighbourCount && tried < breadth; k++)
+    {
+        int t3 = neighbour[k];
+        double addGain = gain - cityMatrix->Distance(t2, t3);
+        if(addGain <= minGain)
+            break;
+
+        // Hrana (t2, t3) nesmi v ceste uz byt; t4 lezi u t3 na stejne strane jako t1 u t2
+        // (smer se urcuje znovu, vraceny tah mohl okruh otocit)
+        bool forward = (Next(context, t1) == t2);
+        int t2Other = forward ? Next(context, t2) : Prev(context, t2);
+        if(t3 == t1 || t3 == t2Other)
+            continue;
+
+        int t4 = forward ? Prev(context, t3) : Next(context, t3);
+        double removeGain = addGain + cityMatrix->Distance(t3, t4);
+        double closeGain = removeGain - cityMatrix->Distance(t4, t1);
+        tried++;
+
+        // Odebranim (t3, t4) a pridanim (t2, t3) a uzaviraci hrany (t4, t1) vznikne opet okruh
+        Move2(context, t2, t1, t3, t4);
+        context.moves.push_back(t2);
+        context.moves.push_back(t1);
+        context.moves.push_back(t3);
+        context.moves.push_back(t4);
+        if(closeGain > bestGain)
+        {
+            bestGain = closeGain;
+            bestDepth = context.moves.size() / 4;
+        }
+
+        // Pokracovani odebranim uzaviraci hrany
+        if(level + 1 < lkDepth)
+            SearchLK(context, t1, t4, removeGain, level + 1, bestGain, bestDepth);
+        if(bestGain > minGain)
+            return true;
+
+        UndoMove(context);
+    }
+
+    return false;
+}
+
+void LocalSearch::UndoMove(tContext &context)
+{
+    int size = context.moves.size();
+    int a = context.moves[size - 4], b = context.moves[size - 3];
+    int c = context.moves[size - 2], d = context.moves[size - 1];
+    context.moves.resize(size - 4);
+
+    // Tah pridal hrany (a, c) a (b, d); opacny tah vrati hrany (a, b) a (c, d)
+    Move2(context, a, c, b, d);
+}
+
+void LocalSearch::Move2(tContext &context, int a, int b, int c, int d)
+{
+    if(Next(context, a) != b)
+    {
+        swap(a, b);
+        swap(c, d);
+    }
+
+    // Otoci se cesta b .. c, nebo (je-li kratsi) zbytek okruhu d .. a
+    vector<int> &tour = *context.tour;
+    int i = context.position[b];
+    int j = context.position[c];
+    int length = (j - i + dimension) % dimension + 1;
+    if(2 * length > dimension)
+    {
+        i = context.position[d];
+        j = context.position[a];
+        length = dimension - length;
+    }
+
+    for(int k = 0; k < length / 2; k++)
+    {
+        int city1 = tour[i], city2 = tour[j];
+        tour[i] = city2;
+        context.position[city2] = i;
+        tour[j] = city1;
+        context.position[city1] = j;
+        i = (i + 1 == dimension) ? 0 : i + 1;
+        j = (j == 0) ? dimension - 1 : j - 1;
+    }
+}
+
+void LocalSearch::Push(tContext &context, int city)
+{
+    if(context.queued[city])
+        return;
+
+    int tail = context.queueHead + context.queueSize;
+    context.queue[(tail >= dimension) ? tail - dimension : tail] = city;
+    context.queueSize++;
+    context.queued[city] = 1;
+}
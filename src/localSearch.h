@@ -0,0 +1,266 @@
+/**
+* \file localSearch.h
+* Lokalni prohledavani cest (2-opt, Or-opt a tahy Lin-Kernighanova typu nad seznamy nejblizsich sousedu).
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef LOCALSEARCH_H_INCLUDED
+#define LOCALSEARCH_H_INCLUDED
+
+#include <QThread>
+#include <QAtomicInt>
+#include <QMutex>
+#include <vector>
+#include "tsp_evolution.h"
+#include "cityMatrix.h"
+#include "cancellationToken.h"
+#include "randomGenerator.h"
+
+using namespace std;
+
+/**
+ * Zlepsovani cest lokalnim prohledavanim do lokalniho optima.
+ * Zkousi se tahy 2-opt (vymena dvou hran) a Or-opt (presun useku 1 az 3 mest jinam, i s otocenim).
+ * Kandidati na novou hranu jsou jen nejblizsi sousede mesta a tah se zkousi jen tehdy, je-li nova
+ * hrana kratsi nez odebirana. Mesta, u kterych se zadny tah nenasel, se znovu zkouseji az po zmene
+ * nektere jejich hrany (don't-look bits, fronta aktivnich mest). Pozice mest v cestach se udrzuji
+ * v indexu, takze sousedy v ceste lze zjistit v konstantnim case; otaceni useku probiha vzdy na
+ * kratsi strane okruhu. Jedinci se mezi vlakna rozdeluji dynamicky.
+ *
+ * Metoda LS_LK u mest, u kterych uz nezlepsuje zadny tah 2-opt ani Or-opt, hleda navic tah
+ * s promennou hloubkou (Lin-Kernighan, zakladnim krokem je tah 2-opt): hrana (t1, t2) se odebere,
+ * t2 se spoji s kandidatem t3 ze seznamu sousedu a okruh se uzavre hranou (t4, t1). Uzaviraci hrana
+ * je v dalsi urovni opet odebirana, dokud je soucet odebranych hran bez pridanych kladny (kriterium
+ * zisku). Provede se nejlepsi nalezena uroven; na prvnich urovnich se pri neuspechu zkousi i dalsi
+ * kandidati.
+ *
+ * Zaverecne doladeni (Polish) po dosazeni lokalniho optima cestu opakovane narusi lokalnim tahem
+ * double-bridge (prohozeni dvou sousednich kratkych useku, ktere tahy 2-opt snadno nevrati), znovu
+ * prohleda jen okoli narusenych hran a zlepseni prijme, jinak se vrati k nejlepsi ceste (chained LK).
+ */
+class LocalSearch
+{
+    private:
+    /**
+     * Pracovni vlakno lokalniho prohledavani.
+     */
+    class Worker : public QThread
+    {
+        private:
+        LocalSearch *search;   ///< Lokalni prohledavani, na kterem vlakno pracuje.
+
+        /**
+        * Zlepsuje jedince, dokud nejsou vsichni hotovi.
+        */
+        void run() { search->Work(); }
+
+        public:
+        /**
+        * Konstruktor.
+        * @param search Lokalni prohledavani, na kterem vlakno pracuje.
+        */
+        Worker(LocalSearch *search) : search(search) {}
+    };
+    friend class Worker;
+
+    /// Pracovni data jednoho vlakna.
+    typedef struct
+    {
+        vector<int> *tour;       ///< Zlepsovana cesta.
+        vector<int> position;    ///< Pozice mest v ceste.
+        vector<int> queue;       ///< Kruhova fronta aktivnich mest.
+        vector<char> queued;     ///< Priznaky mest ve fronte (nulovy priznak = don't-look bit).
+        int queueHead;           ///< Zacatek fronty.
+        int queueSize;           ///< Pocet mest ve fronte.
+        vector<int> moves;       ///< Zasobnik tahu 2-opt provedenych v ramci tahu LK (ctverice mest).
+        vector<int> segment;     ///< Pomocny buffer pro prohazovani useku pri naruseni cesty.
+    } tContext;
+
+    const CityMatrix *cityMatrix;             ///< Matice vzdalenosti.
+    const CityNeighbours *cityNeighbours;     ///< Seznamy nejblizsich sousedu.
+    int neighbourCount;                       ///< Pocet zkousenych sousedu kazdeho mesta.
+    int dimension;                            ///< Pocet mest.
+    vector<tIndividual> *population;          ///< Zlepsovana populace.
+    const vector<int> *selected;              ///< Indexy zlepsovanych jedincu.
+    vector<double> *tourGains;                ///< Zisky jednotlivych zlepsovanych jedincu (NULL = neukladaji se).
+    CancellationToken *cancelToken;           ///< Priznak preruseni.
+    QAtomicInt nextIndividual;                ///< Dalsi nezpracovany jedinec.
+    E_LOCAL_SEARCH method;                    ///< Metoda prohledavani.
+    long long deadline;                       ///< Okamzik vycerpani casoveho limitu [ns] (0 = neomezeno).
+    QAtomicInt moveCount;                     ///< Pocet provedenych tahu.
+    QAtomicInt improvedCount;                 ///< Pocet zlepsenych jedincu.
+    QMutex gainMutex;                         ///< Zamek souctu zisku.
+    double gain;                              ///< Soucet zisku (zkraceni cest) vsech tahu.
+
+    /**
+     * Zlepsuje jedince z rozdelovane fronty (telo pracovniho vlakna).
+     */
+    void Work();
+
+    /**
+     * Vrati, zda-li je prohledavani preruseno nebo vycerpalo casovy limit.
+     * @return True, ma-li prohledavani skoncit.
+     */
+    bool Stopped() const;
+
+    /**
+     * Zlepsi cestu do lokalniho optima.
+     * @param context Pracovni data vlakna.
+     * @param tour Cesta.
+     * @param tourGain Cil pro pricteni zisku provedenych tahu.
+     * @return Pocet provedenych tahu.
+     */
+    int ImproveTour(tContext &context, vector<int> &tour, double &tourGain);
+
+    /**
+     * Zpracovava frontu aktivnich mest, dokud neni prazdna (nebo dokud prohledavani neskonci).
+     * @param context Pracovni data vlakna (s platnym indexem pozic).
+     * @param tourGain Cil pro pricteni zisku provedenych tahu.
+     * @return Pocet provedenych tahu.
+     */
+    int ProcessQueue(tContext &context, double &tourGain);
+
+    /**
+     * Narusi cestu nahodnym lokalnim tahem double-bridge a mesta na zmenenych hranach vlozi do fronty.
+     * @param context Pracovni data vlakna (s platnym indexem pozic).
+     * @param rng Generator pseudonahodnych cisel.
+     * @return Zisk tahu (obvykle zaporny).
+     */
+    double Kick(tContext &context, RandomGenerator &rng);
+
+    /**
+     * Zkusi najit a provest zlepsujici tah u mesta (2-opt, Or-opt, u metody LS_LK nakonec tah LK).
+     * @param context Pracovni data vlakna.
+     * @param city Mesto.
+     * @return Zisk provedeneho tahu (0 = tah nebyl nalezen).
+     */
+    double ImproveCity(tContext &context, int city);
+
+    /**
+     * Zkusi najit a provest zlepsujici tah LK zacinajici mestem t1.
+     * @param context Pracovni data vlakna.
+     * @param t1 Pocatecni mesto.
+     * @return Zisk provedeneho tahu (0 = tah nebyl nalezen).
+     */
+    double MoveLK(tContext &context, int t1);
+
+    /**
+     * Prohleda jednu uroven tahu LK: odebira se hrana (t1, t2), zkousi se kandidati t3 ze seznamu sousedu t2.
+     * Provedene tahy 2-opt zustavaji na zasobniku, neuspesne vetve se vraceji.
+     * @param context Pracovni data vlakna.
+     * @param t1 Pocatecni mesto tahu.
+     * @param t2 Mesto, jehoz hrana k t1 se odebira.
+     * @param gain Soucet delek odebranych hran bez pridanych (vcetne hrany (t1, t2)).
+     * @param level Uroven (od 0).
+     * @param bestGain Nejlepsi zisk po uzavreni okruhu.
+     * @param bestDepth Pocet tahu na zasobniku pri nejlepsim zisku.
+     * @return True, byl-li nalezen zlepsujici tah.
+     */
+    bool SearchLK(tContext &context, int t1, int t2, double gain, int level, double &bestGain, int &bestDepth);
+
+    /**
+     * Vrati posledni tah 2-opt ze zasobniku tahu LK.
+     * @param context Pracovni data vlakna.
+     */
+    void UndoMove(tContext &context);
+
+    /**
+     * Vrati nasledujici mesto v ceste.
+     * @param context Pracovni data vlakna.
+     * @param city Mesto.
+     * @return Nasledujici mesto.
+     */
+    int Next(const tContext &context, int city) const
+    {
+        int pos = context.position[city] + 1;
+        return (*context.tour)[(pos == dimension) ? 0 : pos];
+    }
+
+    /**
+     * Vrati predchazejici mesto v ceste.
+     * @param context Pracovni data vlakna.
+     * @param city Mesto.
+     * @return Predchazejici mesto.
+     */
+    int Prev(const tContext &context, int city) const
+    {
+        int pos = context.position[city];
+        return (*context.tour)[(pos == 0) ? dimension - 1 : pos - 1];
+    }
+
+    /**
+     * Provede tah 2-opt: odebere hrany (a, b) a (c, d) a prida hrany (a, c) a (b, d).
+     * Mesto b musi lezet za mestem a ve stejnem smeru, v jakem lezi d za c.
+     * @param context Pracovni data vlakna.
+     * @param a Prvni mesto prvni hrany.
+     * @param b Druhe mesto prvni hrany.
+     * @param c Prvni mesto druhe hrany.
+     * @param d Druhe mesto druhe hrany.
+     */
+    void Move2(tContext &context, int a, int b, int c, int d);
+
+    /**
+     * Vlozi mesto do fronty aktivnich mest (neni-li v ni).
+     * @param context Pracovni data vlakna.
+     * @param city Mesto.
+     */
+    void Push(tContext &context, int city);
+
+    public:
+    /**
+    * Konstruktor.
+    */
+    LocalSearch();
+
+    /**
+     * Zlepsi vybrane jedince populace do lokalniho optima. Zmenenym jedincum se vynuluje hash,
+     * ceny se nepocitaji (ohodnoceni zustava na volajicim).
+     * @param cityMatrix Matice vzdalenosti.
+     * @param cityNeighbours Seznamy nejblizsich sousedu (alespon neighbourCount sousedu kazdeho mesta).
+     * @param neighbourCount Pocet zkousenych sousedu kazdeho mesta.
+     * @param population Populace.
+     * @param selected Indexy zlepsovanych jedincu.
+     * @param cancelToken Priznak preruseni (po preruseni jsou cesty platne, jen nemusi byt v lokalnim optimu).
+     * @param method Metoda prohledavani.
+     * @param timeLimit Casovy limit v sekundach (0 = neomezeno; po vycerpani se skonci jako pri preruseni).
+     * @param tourGains Cil pro zkraceni jednotlivych vybranych jedincu (v poradi selected; NULL = neukladaji se).
+     */
+    void Improve(const CityMatrix &cityMatrix, const CityNeighbours &cityNeighbours, int neighbourCount,
+                 vector<tIndividual> &population, const vector<int> &selected, CancellationToken &cancelToken,
+                 E_LOCAL_SEARCH method = LS_2OPT, double timeLimit = 0, vector<double> *tourGains = NULL);
+
+    /**
+     * Doladi cestu: zlepsi ji do lokalniho optima metodou LS_LK a do vycerpani casoveho limitu ji
+     * opakovane narusuje a znovu zlepsuje, pricemz si drzi nejlepsi nalezenou cestu.
+     * @param cityMatrix Matice vzdalenosti.
+     * @param cityNeighbours Seznamy nejblizsich sousedu (alespon neighbourCount sousedu kazdeho mesta).
+     * @param neighbourCount Pocet zkousenych sousedu kazdeho mesta.
+     * @param tour Cesta (po skonceni nejlepsi nalezena).
+     * @param cancelToken Priznak preruseni.
+     * @param timeLimit Casovy limit v sekundach (0 = jen lokalni optimum bez narusovani).
+     * @param rng Generator pseudonahodnych cisel.
+     * @return Pocet naruseni cesty.
+     */
+    int Polish(const CityMatrix &cityMatrix, const CityNeighbours &cityNeighbours, int neighbourCount,
+               vector<int> &tour, CancellationToken &cancelToken, double timeLimit, RandomGenerator &rng);
+
+    /**
+     * Vrati pocet tahu provedenych pri poslednim volani Improve() nebo Polish().
+     * @return Pocet tahu.
+     */
+    int GetMoves() const { return (int)moveCount; }
+
+    /**
+     * Vrati pocet jedincu zlepsenych pri poslednim volani Improve() (u Polish() 0 nebo 1).
+     * @return Pocet jedincu zmenenych alespon jednim tahem.
+     */
+    int GetImproved() const { return (int)improvedCount; }
+
+    /**
+     * Vrati soucet zisku tahu provedenych pri poslednim volani Improve() nebo Polish().
+     * @return Celkove zkraceni cest.
+     */
+    double GetGain() const { return gain; }
+};
+
+#endif // LOCALSEARCH_H_INCLUDED
@@ -1,11 +1,31 @@
 #include <QtGui>
 #include <time.h>
 #include "workSpace.h"
+#include "tspLoader.h"
 
 int main(int argc, char *argv[])
 {
     srand(time(NULL));
 
+    // Prevod ulohy do binarniho formatu: --convert vstup vystup [pocetSousedu] [-nomatrix] [-integer]
+    if(argc >= 4 && string(argv[1]) == "--convert")
+    {
+        int neighbourCount = 0;
+        bool storeMatrix = true;
+        bool integerDistances = false;
+        for(int i = 4; i < argc; i++)
+        {
+            if(string(argv[i]) == "-nomatrix")
+                storeMatrix = false;
+            else if(string(argv[i]) == "-integer")
+                integerDistances = true;
+            else
+                neighbourCount = atoi(argv[i]);
+        }
+
+        return ConvertProblem(argv[2], argv[3], neighbourCount, storeMatrix, integerDistances) ? 0 : 1;
+    }
+
     // Start aplikace
     QApplication app(argc, argv);
     WorkSpace workSpace;
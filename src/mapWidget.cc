@@ -11,17 +11,20 @@ MapWidget::MapWidget(QWidget *parent) : QWidget(parent)
     timerInterval = 250;
     timerId = -1;
     timerRunning = false;
+    pathChannel = NULL;
+    cityLayerValid = false;
 }
 
-void MapWidget::SetNewMap(vector<CityPosition> &cityPosition)
+void MapWidget::SetNewMap(const vector<CityPosition> &cityPosition)
 {
     this->cityPosition.clear();
-    tempBestIndividual.genome.clear();
     bestIndividual.genome.clear();
+    tourLines.clear();
+    cityLayerValid = false;
 
-    int maxPositionX = 0, maxPositionY = 0;
-    int minPositionX = INT_MAX, minPositionY = INT_MAX;
-    float multConstantX = 0, multConstantY = 0;
+    double maxPositionX = -DBL_MAX, maxPositionY = -DBL_MAX;
+    double minPositionX = DBL_MAX, minPositionY = DBL_MAX;
+    double multConstantX = 0, multConstantY = 0;
 
     // Vypocet konstant pro prepocitani souradnic mest (aby se vesly do vymezeneho rastru)
     for(int i = 0; i < (int)cityPosition.size(); i++)
@@ -35,35 +38,83 @@ void MapWidget::SetNewMap(vector<CityPosition> &cityPosition)
         if(cityPosition[i].y < minPositionY)
             minPositionY = cityPosition[i].y;
     }
-    multConstantX = ((double) (this->width() - 12)) / (maxPositionX - minPositionX);
-    multConstantY = ((double) (this->height() - 12)) / (maxPositionY - minPositionY);
+    if(maxPositionX > minPositionX)
+        multConstantX = ((double) (this->width() - 12)) / (maxPositionX - minPositionX);
+    if(maxPositionY > minPositionY)
+        multConstantY = ((double) (this->height() - 12)) / (maxPositionY - minPositionY);
 
     // Prepocitani souradnic mest
     CityPosition actCity;
     for(int i = 0; i < (int)cityPosition.size(); i++)
     {
-        cityPosition[i].x -= minPositionX;
-        cityPosition[i].y -= minPositionY;
-        actCity.x = ceil(multConstantX * cityPosition[i].x) + 6;
-        actCity.y = ceil(multConstantY * cityPosition[i].y) + 6;
+        actCity.x = ceil(multConstantX * (cityPosition[i].x - minPositionX)) + 6;
+        actCity.y = ceil(multConstantY * (cityPosition[i].y - minPositionY)) + 6;
         this->cityPosition.push_back(actCity);
     }
 
     update();
 }
 
-void MapWidget::SetBestIndividual(tIndividual bestIndividual)
+void MapWidget::SetBestIndividual(const tIndividual &bestIndividual)
 {
-    mutex.lock();
-    tempBestIndividual = bestIndividual;
-    mutex.unlock();
+    this->bestIndividual = bestIndividual;
+    BuildTourLines();
+    update();
+}
+
+void MapWidget::SetPathChannel(SnapshotChannel<tIndividual> *pathChannel)
+{
+    this->pathChannel = pathChannel;
+}
+
+void MapWidget::RenderCityLayer()
+{
+    int layerWidth = this->width(), layerHeight = this->height();
+    cityLayer = QPixmap(layerWidth, layerHeight);
+    cityLayer.fill(Qt::transparent);
+
+    QPainter painter(&cityLayer);
+    vector<bool> drawn((size_t)layerWidth * layerHeight, false);
+    for(int i = 0; i < (int)cityPosition.size(); i++)
+    {
+        int x = (int)cityPosition[i].x, y = (int)cityPosition[i].y;
+        if(x < 0 || y < 0 || x >= layerWidth || y >= layerHeight || drawn[(size_t)y * layerWidth + x])
+            continue;
+        drawn[(size_t)y * layerWidth + x] = true;
+        painter.fillRect(x - 1, y - 1, 2, 2, Qt::black);
+    }
+    painter.end();
+
+    cityLayerValid = true;
+}
+
+void MapWidget::BuildTourLines()
+{
+    tourLines.clear();
+
+    int size = bestIndividual.genome.size();
+    if(size < 2 || (int)cityPosition.size() < size)
+        return;
+
+    // Mesta padnouci do stejneho pixelu jako predchozi vykreslene mesto se preskoci
+    int lastX = (int)cityPosition[bestIndividual.genome[0]].x;
+    int lastY = (int)cityPosition[bestIndividual.genome[0]].y;
+    for(int i = 1; i <= size; i++)
+    {
+        const CityPosition &city = cityPosition[bestIndividual.genome[i % size]];
+        int x = (int)city.x, y = (int)city.y;
+        if(x == lastX && y == lastY)
+            continue;
+        tourLines.push_back(QLine(lastX, lastY, x, y));
+        lastX = x;
+        lastY = y;
+    }
 }
 
 void MapWidget::paintEvent(QPaintEvent * /* event */)
 {
-    mutex.lock();
-    bestIndividual = tempBestIndividual;
-    mutex.unlock();
+    if(!cityLayerValid)
+        RenderCityLayer();
 
     QPainter painter(this);
 
@@ -72,34 +123,26 @@ void MapWidget::paintEvent(QPaintEvent * /* event */)
     painter.setBrush(Qt::white);
     painter.drawRect(0, 0, (this->width() - 1), (this->height() - 1));
 
-    // Vykresleni cesty mezi mesty
+    // Vykresleni cesty mezi mesty (jednim volanim)
     painter.setPen(Qt::red);
-    if(!bestIndividual.genome.empty())
-    {
-        int i1, i2;
-        for(int i = 0; i < (int)bestIndividual.genome.size(); i++)
-        {
-            i1 = bestIndividual.genome[i%bestIndividual.genome.size()];
-            i2 = bestIndividual.genome[(i+1)%bestIndividual.genome.size()];
-            painter.drawLine(cityPosition[i1].x, cityPosition[i1].y, cityPosition[i2].x, cityPosition[i2].y);
-        }
-    }
+    if(!tourLines.empty())
+        painter.drawLines(&tourLines[0], tourLines.size());
 
-    // Vykresleni mest
-    painter.setBrush(Qt::black);
-    painter.setPen(Qt::black);
-    if(!cityPosition.empty())
-    {
-        for(int i = 0; i < (int)cityPosition.size(); i++)
-        {
-            painter.drawPie(QRect((cityPosition[i].x - 1), (cityPosition[i].y - 1), 2, 2), 0, (16 * 360));
-        }
-    }
+    // Vykresleni mest z predkreslene vrstvy
+    painter.drawPixmap(0, 0, cityLayer);
 }
 
 void MapWidget::timerEvent(QTimerEvent *)
 {
-    update();
+    // Prekresluje se jen pri nove ceste; buffer kanalu patri mape az do dalsiho prevzeti,
+    // takze se jeho obsah jen vymeni (bez kopirovani)
+    if(pathChannel != NULL && pathChannel->Update())
+    {
+        bestIndividual.genome.swap(pathChannel->Front().genome);
+        bestIndividual.price = pathChannel->Front().price;
+        BuildTourLines();
+        update();
+    }
 
     if(!timerRunning)
         killTimer(timerId);
@@ -4,19 +4,21 @@
 * \author Bendl Jaroslav (xbendl00)
 */
 
-#ifndef MAPWIDGET_H_INCLUDED
+#ifndef MAPWIDGET_H_INCLUDED
 #define MAPWIDGET_H_INCLUDED
-
+
 #include <QtGui>
 #include <QWidget>
 #include <QMetaType>
 #include <QThread>
 #include <QMutex>
 #include <QWaitCondition>
-#include <stdlib.h>
+#include <stdlib.h>
 #include <math.h>
 #include <iostream>
-#include "tsp_evolution.h"
+#include <float.h>
+#include "tsp_evolution.h"
+#include "snapshotChannel.h"
 
 /// 2D mrizka pro zobrazeni stavu bunek celularniho automatu.
 class MapWidget : public QWidget
@@ -24,13 +26,24 @@ class MapWidget : public QWidget
     Q_OBJECT
 
     vector<CityPosition> cityPosition;   ///< Pozice mest na mape.
-    tIndividual tempBestIndividual;
     tIndividual bestIndividual;          ///< Jedinec evolvovane populace s nejlepsim ohodnocenim cesty.
+    vector<QLine> tourLines;             ///< Usecky vykreslovane trasy (bez usecek kratsich nez pixel).
+    QPixmap cityLayer;                   ///< Predkreslena vrstva mest (s pruhlednym pozadim).
+    bool cityLayerValid;                 ///< Udava, zda-li vrstva mest odpovida aktualni mape.
+    SnapshotChannel<tIndividual> *pathChannel;   ///< Kanal, ze ktereho se pri tiku casovace prebira nejlepsi cesta.
     int timerInterval;    ///< Interval tiku casovace
     int timerId;          ///< ID casovace
     bool timerRunning;
 
-    QMutex mutex;
+    /**
+    * Predkresli vrstvu mest (mesta ve stejnem pixelu se kresli jen jednou).
+    */
+    void RenderCityLayer();
+
+    /**
+    * Sestavi usecky trasy nejlepsiho jedince; usecky kratsi nez pixel se vynechaji.
+    */
+    void BuildTourLines();
 
     protected:
     void timerEvent(QTimerEvent *timerEvent);
@@ -47,7 +60,7 @@ class MapWidget : public QWidget
     * Nastavi mapu podle predaneho seznamu s pozicemi mest
     * @param cityPosition Pozice mest na mape.
     */
-    void SetNewMap(vector<CityPosition> &cityPosition);
+    void SetNewMap(const vector<CityPosition> &cityPosition);
 
     /**
     * Nastavi na mape trasu pruchodu mesty podle predaneho jedince.
@@ -59,7 +72,13 @@ class MapWidget : public QWidget
     * Nastavi nejlepsiho jedince.
     * @param bestIndividual Jedinec populace s nejlepe ohodnocenou trasou pruchodu mesty.
     */
-    void SetBestIndividual(tIndividual bestIndividual);
+    void SetBestIndividual(const tIndividual &bestIndividual);
+
+    /**
+    * Nastavi kanal, ze ktereho se za behu vypoctu prebira nejlepsi cesta (mapa je jeho jedinym ctenarem).
+    * @param pathChannel Kanal s nejlepsi cestou.
+    */
+    void SetPathChannel(SnapshotChannel<tIndividual> *pathChannel);
 
     /**
     * Spusti casovac.
@@ -78,5 +97,5 @@ class MapWidget : public QWidget
     */
     bool IsTimerRunning();
 };
-
-#endif // MAPWIDGET_H_INCLUDED
+
+#endif // MAPWIDGET_H_INCLUDED
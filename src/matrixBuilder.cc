@@ -0,0 +1,235 @@
+#include <math.h>
+#include <limits.h>
+#include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "matrixBuilder.h"
+#include "tspLoader.h"
+
+/// Pocet radku v jednom pasu (zaroven rozmer dlazdice).
+static const int blockRows = 64;
+
+/// Dimenze, od ktere se vypocet rozdeluje mezi vice vlaken.
+static const int parallelThreshold = 256;
+
+/**
+ * Ulozi vzdalenost do realne matice.
+ * @param target Prvek matice.
+ * @param distance Vzdalenost.
+ */
+static inline void StoreDistance(float &target, double distance)
+{
+    target = distance;
+}
+
+/**
+ * Ulozi vzdalenost do celociselne matice (zaokrouhleni nint podle TSPLIB).
+ * @param target Prvek matice.
+ * @param distance Vzdalenost.
+ */
+static inline void StoreDistance(unsigned int &target, double distance)
+{
+    target = (unsigned int)(distance + 0.5);
+}
+
+#ifdef __SSE2__
+/**
+ * Ulozi dve eukleidovske vzdalenosti do realne matice.
+ * @param target Prvni ze dvou prvku matice.
+ * @param distance Vzdalenosti.
+ */
+static inline void StoreDistancePair(float *target, __m128d distance)
+{
+    _mm_storel_pi((__m64 *)target, _mm_cvtpd_ps(distance));
+}
+
+/**
+ * Ulozi dve eukleidovske vzdalenosti do celociselne matice (zaokrouhleni nint podle TSPLIB).
+ * @param target Prvni ze dvou prvku matice.
+ * @param distance Vzdalenosti (mensi nez INT_MAX).
+ */
+static inline void StoreDistancePair(unsigned int *target, __m128d distance)
+{
+    _mm_storel_epi64((__m128i *)target, _mm_cvttpd_epi32(_mm_add_pd(distance, _mm_set1_pd(0.5))));
+}
+#endif
+
+MatrixBuilder::MatrixBuilder()
+{
+    cityPosition = NULL;
+    type = EUC_2D;
+    floatMatrix = NULL;
+    integerMatrix = NULL;
+    dimension = 0;
+    blockCount = 0;
+}
+
+void MatrixBuilder::Build(const vector<CityPosition> &cityPosition, E_EDGE_WEIGHT type, CityMatrix &cityMatrix, bool integer, MatrixProgress *progress)
+{
+    this->cityPosition = &cityPosition;
+    this->type = type;
+    dimension = cityPosition.size();
+    blockCount = (dimension + blockRows - 1) / blockRows;
+    doneBlocks = 0;
+
+    // Rozdeleni souradnic po slozkach pro vektorovy vypocet
+    cityX.resize(dimension);
+    cityY.resize(dimension);
+    double minX = 0, maxX = 0, minY = 0, maxY = 0;
+    for(int i = 0; i < dimension; i++)
+    {
+        cityX[i] = cityPosition[i].x;
+        cityY[i] = cityPosition[i].y;
+        minX = (i == 0) ? cityX[i] : min(minX, cityX[i]);
+        maxX = (i == 0) ? cityX[i] : max(maxX, cityX[i]);
+        minY = (i == 0) ? cityY[i] : min(minY, cityY[i]);
+        maxY = (i == 0) ? cityY[i] : max(maxY, cityY[i]);
+    }
+
+    // Celociselne vzdalenosti musi byt mensi nez INT_MAX (vektorovy prevod je znamenkovy)
+    if(integer && type != GEO && sqrt((maxX - minX) * (maxX - minX) + (maxY - minY) * (maxY - minY)) + 1 >= INT_MAX)
+    {
+        cerr << "Upozorneni: Vzdalenosti mest jsou prilis velke pro celociselnou matici, pouzije se realna." << endl;
+        integer = false;
+    }
+
+    floatMatrix = integer ? NULL : cityMatrix.Allocate(dimension);
+    integerMatrix = integer ? cityMatrix.AllocateInteger(dimension) : NULL;
+
+    int threadCount = 1;
+    if(dimension >= parallelThreshold)
+        threadCount = max(1, min(QThread::idealThreadCount(), blockCount));
+
+    nextBlock = 0;
+    vector<Worker *> workers;
+    for(int i = 1; i < threadCount; i++)
+    {
+        workers.push_back(new Worker(this));
+        workers.back()->start();
+    }
+
+    // Volajici vlakno pracuje take a prubezne hlasi postup; pri zruseni se zbyvajici pasy
+    // oznaci za rozdelene, takze pracovni vlakna skonci po dokonceni rozpracovanych pasu
+    bool cancelled = false;
+    while(ProcessBlock())
+    {
+        if(progress != NULL)
+            progress->SetProgress(doneBlocks, blockCount);
+        if(progress != NULL && progress->IsCancelled())
+        {
+            nextBlock.fetchAndStoreOrdered(blockCount);
+            cancelled = true;
+            break;
+        }
+    }
+
+    for(unsigned int i = 0; i < workers.size(); i++)
+    {
+        workers[i]->wait();
+        delete workers[i];
+    }
+
+    if(cancelled)
+        cityMatrix.Clear();
+    else if(integer)
+        cityMatrix.Narrow();
+
+    if(progress != NULL)
+        progress->SetProgress(blockCount, blockCount);
+
+    cityX.clear();
+    cityY.clear();
+    this->cityPosition = NULL;
+    floatMatrix = NULL;
+    integerMatrix = NULL;
+}
+
+bool MatrixBuilder::ProcessBlock()
+{
+    int block = nextBlock.fetchAndAddOrdered(1);
+    if(block >= blockCount)
+        return false;
+
+    int first = block * blockRows;
+    int last = min(first + blockRows, dimension);
+
+    if(integerMatrix != NULL)
+        ProcessBand(integerMatrix, first, last);
+    else
+        ProcessBand(floatMatrix, first, last);
+
+    doneBlocks.fetchAndAddOrdered(1);
+    return true;
+}
+
+template <class T> void MatrixBuilder::ProcessBand(T *matrix, int first, int last)
+{
+    for(int i = first; i < last; i++)
+        matrix[(size_t)i * dimension + i] = 0;
+
+    for(int tile = first; tile < dimension; tile += blockRows)
+    {
+        int tileEnd = min(tile + blockRows, dimension);
+
+        // Dlazdice horniho trojuhelniku
+        for(int i = first; i < last; i++)
+            ComputeRow(matrix, i, max(tile, i + 1), tileEnd);
+
+        // Zrcadlova dlazdice dolniho trojuhelniku (zdrojova data jsou jeste v cache)
+        for(int j = tile; j < tileEnd; j++)
+        {
+            T *row = matrix + (size_t)j * dimension;
+            int mirrorEnd = min(last, j);
+            for(int i = first; i < mirrorEnd; i++)
+                row[i] = matrix[(size_t)i * dimension + j];
+        }
+    }
+}
+
+template <class T> void MatrixBuilder::ComputeRow(T *matrix, int i, int from, int to)
+{
+    T *row = matrix + (size_t)i * dimension;
+    int j = from;
+
+    if(type != EUC_2D && type != CEIL_2D)
+    {   // ostatni typy vzdalenosti se pocitaji po jednotlivych dvojicich mest
+        for(; j < to; j++)
+            StoreDistance(row[j], CityDistance(type, (*cityPosition)[i], (*cityPosition)[j]));
+        return;
+    }
+
+    double x = cityX[i];
+    double y = cityY[i];
+
+#ifdef __SSE2__
+    // Dve vzdalenosti naraz; vypocet v dvojite presnosti dava stejne vysledky jako CityDistance
+    __m128d vectorX = _mm_set1_pd(x);
+    __m128d vectorY = _mm_set1_pd(y);
+    for(; j + 1 < to; j += 2)
+    {
+        __m128d dX = _mm_sub_pd(vectorX, _mm_loadu_pd(&cityX[j]));
+        __m128d dY = _mm_sub_pd(vectorY, _mm_loadu_pd(&cityY[j]));
+        __m128d distance = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dX, dX), _mm_mul_pd(dY, dY)));
+        if(type == EUC_2D)
+        {
+            StoreDistancePair(row + j, distance);
+        }
+        else
+        {
+            double value[2];
+            _mm_storeu_pd(value, distance);
+            StoreDistance(row[j], ceil(value[0]));
+            StoreDistance(row[j + 1], ceil(value[1]));
+        }
+    }
+#endif
+
+    for(; j < to; j++)
+    {
+        double dX = x - cityX[j];
+        double dY = y - cityY[j];
+        double distance = sqrt(dX * dX + dY * dY);
+        StoreDistance(row[j], (type == CEIL_2D) ? ceil(distance) : distance);
+    }
+}
@@ -0,0 +1,128 @@
+/**
+* \file matrixBuilder.h
+* Paralelni vypocet matice vzdalenosti ze souradnic mest.
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef MATRIXBUILDER_H_INCLUDED
+#define MATRIXBUILDER_H_INCLUDED
+
+#include <QThread>
+#include <QAtomicInt>
+#include <vector>
+#include "tsp_evolution.h"
+#include "cityMatrix.h"
+
+using namespace std;
+
+/**
+ * Prijemce informaci o prubehu vypoctu matice.
+ */
+class MatrixProgress
+{
+    public:
+    /**
+     * Destruktor.
+     */
+    virtual ~MatrixProgress() {}
+
+    /**
+     * Oznami postup vypoctu (vola se z vlakna, ktere vypocet spustilo).
+     * @param done Pocet zpracovanych jednotek prace.
+     * @param total Celkovy pocet jednotek prace.
+     */
+    virtual void SetProgress(int done, int total) = 0;
+
+    /**
+     * Overi, zda-li ma byt vypocet zrusen (dotazuje se vlakno, ktere vypocet spustilo, po kazdem pasu radku).
+     * @return True, pokud ma byt vypocet zrusen.
+     */
+    virtual bool IsCancelled() { return false; }
+};
+
+/**
+ * Vypocet matice vzdalenosti.
+ * Pocita se jen horni trojuhelnik po ctvercovych dlazdicich; kazda dlazdice se hned
+ * (dokud je v cache) zkopiruje do dolniho trojuhelniku. Pasy radku se dynamicky rozdeluji
+ * mezi vlakna. Souradnice jsou ulozeny po slozkach (zvlast X a Y), takze eukleidovske
+ * vzdalenosti lze pocitat vektorove (SSE2) po dvojicich mest.
+ * Celociselna matice obsahuje vzdalenosti zaokrouhlene podle TSPLIB (nint) a po vypoctu
+ * se zuzi na 16bitove prvky, vejdou-li se do nich.
+ */
+class MatrixBuilder
+{
+    private:
+    /**
+     * Pracovni vlakno vypoctu.
+     */
+    class Worker : public QThread
+    {
+        private:
+        MatrixBuilder *builder;   ///< Vypocet, na kterem vlakno pracuje.
+
+        /**
+        * Zpracovava pasy radku, dokud nejsou vsechny hotove.
+        */
+        void run() { while(builder->ProcessBlock()); }
+
+        public:
+        /**
+        * Konstruktor.
+        * @param builder Vypocet, na kterem vlakno pracuje.
+        */
+        Worker(MatrixBuilder *builder) : builder(builder) {}
+    };
+    friend class Worker;
+
+    vector<double> cityX;      ///< Souradnice X mest.
+    vector<double> cityY;      ///< Souradnice Y mest.
+    const vector<CityPosition> *cityPosition;   ///< Pozice mest (pro nevektorove typy vzdalenosti).
+    E_EDGE_WEIGHT type;        ///< Zpusob vypoctu vzdalenosti.
+    float *floatMatrix;        ///< Vypocitavana realna matice (NULL u celociselne).
+    unsigned int *integerMatrix;   ///< Vypocitavana celociselna matice (NULL u realne).
+    int dimension;             ///< Dimenze matice.
+    int blockCount;            ///< Pocet pasu radku.
+    QAtomicInt nextBlock;      ///< Dalsi nezpracovany pas radku.
+    QAtomicInt doneBlocks;     ///< Pocet dokoncenych pasu radku.
+
+    /**
+     * Zpracuje jeden pas radku (jeho cast horniho trojuhelniku a zrcadlovou cast dolniho).
+     * @return False, pokud jiz zadny pas nezbyva.
+     */
+    bool ProcessBlock();
+
+    /**
+     * Vypocita pas radku first az last - 1 a zrcadlove doplni dolni trojuhelnik.
+     * @param matrix Vypocitavana matice.
+     * @param first Prvni radek pasu.
+     * @param last Radek za poslednim radkem pasu.
+     */
+    template <class T> void ProcessBand(T *matrix, int first, int last);
+
+    /**
+     * Vypocita cast radku matice (vzdalenosti mesta i k mestum from az to - 1).
+     * @param matrix Vypocitavana matice.
+     * @param i Index radku.
+     * @param from Prvni sloupec.
+     * @param to Sloupec za poslednim pocitanym.
+     */
+    template <class T> void ComputeRow(T *matrix, int i, int from, int to);
+
+    public:
+    /**
+    * Konstruktor.
+    */
+    MatrixBuilder();
+
+    /**
+     * Vypocita matici vzdalenosti mest.
+     * @param cityPosition Pozice mest.
+     * @param type Zpusob vypoctu vzdalenosti.
+     * @param cityMatrix Vypoctena matice vzdalenosti.
+     * @param integer Urcuje, zda-li se ma vypocitat celociselna matice.
+     * @param progress Prijemce informaci o prubehu (muze byt NULL); zrusi-li vypocet, matice zustane prazdna.
+     */
+    void Build(const vector<CityPosition> &cityPosition, E_EDGE_WEIGHT type, CityMatrix &cityMatrix, bool integer = false, MatrixProgress *progress = NULL);
+};
+
+#endif // MATRIXBUILDER_H_INCLUDED
@@ -0,0 +1,216 @@
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "metricsServer.h"
+
+MetricsServer::MetricsServer(TSPEvolution *tspEvolution) : QThread()
+{
+    this->tspEvolution = tspEvolution;
+    port = 0;
+    listenFd = -1;
+    abortFlag = 0;
+}
+
+MetricsServer::~MetricsServer()
+{
+    Close();
+}
+
+bool MetricsServer::Listen(int port, string socketPath)
+{
+    Close();
+    this->port = port;
+    this->socketPath = socketPath;
+
+    if(port > 0)
+    {   // TCP server dostupny pouze z lokalniho pocitace
+        listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if(listenFd < 0)
+            return false;
+
+        int reuse = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if(bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        {
+            cerr << "Chyba! Port " << port << " pro export metrik nelze otevrit (" << strerror(errno) << ")." << endl;
+            close(listenFd);
+            listenFd = -1;
+            return false;
+        }
+    }
+    else if(!socketPath.empty())
+    {   // Unix socket
+        listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(listenFd < 0)
+            return false;
+
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(socketPath.c_str());
+        if(bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        {
+            cerr << "Chyba! Socket " << socketPath << " pro export metrik nelze otevrit (" << strerror(errno) << ")." << endl;
+            close(listenFd);
+            listenFd = -1;
+            return false;
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    if(listen(listenFd, 8) < 0)
+    {
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    abortFlag = 0;
+    start();
+    return true;
+}
+
+void MetricsServer::Close()
+{
+    if(listenFd < 0)
+        return;
+
+    abortFlag = 1;
+    wait();
+
+    close(listenFd);
+    listenFd = -1;
+    if(port == 0 && !socketPath.empty())
+        unlink(socketPath.c_str());
+}
+
+void MetricsServer::run()
+{
+    struct pollfd pfd;
+    pfd.fd = listenFd;
+    pfd.events = POLLIN;
+
+    while(abortFlag == 0)
+    {
+        // Cekani na pozadavek s omezenou dobou, aby bylo mozne reagovat na priznak ukonceni
+        if(poll(&pfd, 1, 250) <= 0)
+            continue;
+
+        int clientFd = accept(listenFd, NULL, NULL);
+        if(clientFd < 0)
+            continue;
+
+        // Obsah pozadavku neni dulezity, kazdy pozadavek dostane metriky
+        char request[2048];
+        struct pollfd cfd;
+        cfd.fd = clientFd;
+        cfd.events = POLLIN;
+        if(poll(&cfd, 1, 1000) > 0)
+            recv(clientFd, request, sizeof(request), 0);
+
+        string body = BuildMetrics();
+        stringstream response;
+        response << "HTTP/1.0 200 OK\r\n"
+                 << "Content-Type: text/plain; version=0.0.4\r\n"
+                 << "Content-Length: " << body.size() << "\r\n"
+                 << "Connection: close\r\n\r\n"
+                 << body;
+        string data = response.str();
+
+        size_t sent = 0;
+        while(sent < data.size())
+        {
+            ssize_t n = send(clientFd, data.c_str() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if(n <= 0)
+                break;
+            sent += n;
+        }
+        close(clientFd);
+    }
+}
+
+string MetricsServer::BuildMetrics()
+{
+    tMetrics m = tspEvolution->GetMetrics();
+    stringstream out;
+    out << setprecision(17);   // ceny i casy bez ztraty presnosti (vychozich 6 cislic by ceny zaokrouhlilo)
+
+    // Vyuziti pameti procesu (/proc/self/statm: celkova velikost a rezidentni cast ve strankach)
+    long long vmPages = 0, rssPages = 0;
+    ifstream statm("/proc/self/statm");
+    if(statm.good())
+        statm >> vmPages >> rssPages;
+    long long pageSize = sysconf(_SC_PAGESIZE);
+
+    out << "# HELP tsp_running 1 pokud vypocet prave probiha.\n# TYPE tsp_running gauge\n"
+        << "tsp_running " << (m.running ? 1 : 0) << "\n";
+    out << "# HELP tsp_generation Cislo aktualni generace.\n# TYPE tsp_generation gauge\n"
+        << "tsp_generation " << m.generation << "\n";
+    out << "# HELP tsp_generations_target Pocet generaci pozadovanych pro beh.\n# TYPE tsp_generations_target gauge\n"
+        << "tsp_generations_target " << m.nGenerations << "\n";
+    out << "# HELP tsp_price Cena cesty v aktualni populaci.\n# TYPE tsp_price gauge\n"
+        << "tsp_price{stat=\"best\"} " << m.minPrice << "\n"
+        << "tsp_price{stat=\"avg\"} " << m.avgPrice << "\n"
+        << "tsp_price{stat=\"worst\"} " << m.maxPrice << "\n";
+    out << "# HELP tsp_best_price_overall Nejlepsi cena cesty od inicializace.\n# TYPE tsp_best_price_overall gauge\n"
+        << "tsp_best_price_overall " << m.bestPrice << "\n";
+    out << "# HELP tsp_evaluations_total Pocet ohodnoceni genomu.\n# TYPE tsp_evaluations_total counter\n"
+        << "tsp_evaluations_total " << m.evaluationCount << "\n";
+    out << "# HELP tsp_crossovers_total Pocet aplikaci operatoru krizeni.\n# TYPE tsp_crossovers_total counter\n"
+        << "tsp_crossovers_total " << m.crossoverCount << "\n";
+    out << "# HELP tsp_mutations_total Pocet aplikaci operatoru mutace.\n# TYPE tsp_mutations_total counter\n"
+        << "tsp_mutations_total " << m.mutationCount << "\n";
+    out << "# HELP tsp_evaluations_per_second Pocet ohodnoceni za sekundu (od posledni aktualizace).\n# TYPE tsp_evaluations_per_second gauge\n"
+        << "tsp_evaluations_per_second " << m.evaluationsPerSecond << "\n";
+    out << "# HELP tsp_generations_per_second Pocet generaci za sekundu (od posledni aktualizace).\n# TYPE tsp_generations_per_second gauge\n"
+        << "tsp_generations_per_second " << m.generationsPerSecond << "\n";
+    out << "# HELP tsp_mutation_rate Efektivni pravdepodobnost mutace.\n# TYPE tsp_mutation_rate gauge\n"
+        << "tsp_mutation_rate " << m.mutationRate << "\n";
+    out << "# HELP tsp_tournament_size Efektivni pocet ucastniku turnaje.\n# TYPE tsp_tournament_size gauge\n"
+        << "tsp_tournament_size " << m.tournamentSize << "\n";
+    out << "# HELP tsp_elapsed_seconds Doba behu vypoctu.\n# TYPE tsp_elapsed_seconds gauge\n"
+        << "tsp_elapsed_seconds " << m.elapsedSeconds << "\n";
+    out << "# HELP tsp_phase_seconds_total Celkova doba behu fazi evolucniho kroku.\n# TYPE tsp_phase_seconds_total counter\n";
+    for(int i = 0; i < PHASE_COUNT; i++)
+        out << "tsp_phase_seconds_total{phase=\"" << PhaseProfiler::PhaseName((E_PHASE)i) << "\"} " << (m.phaseTime[i] / 1e9) << "\n";
+    if(m.distanceCache)
+    {
+        out << "# HELP tsp_distance_cache_hits_total Pocet zasahu vyrovnavaci pameti radku matice.\n# TYPE tsp_distance_cache_hits_total counter\n"
+            << "tsp_distance_cache_hits_total " << m.distanceCacheHits << "\n";
+        out << "# HELP tsp_distance_cache_misses_total Pocet chyb vyrovnavaci pameti radku matice.\n# TYPE tsp_distance_cache_misses_total counter\n"
+            << "tsp_distance_cache_misses_total " << m.distanceCacheMisses << "\n";
+    }
+    if(m.fitnessCache)
+    {
+        out << "# HELP tsp_fitness_cache_hits_total Pocet ohodnoceni usporenych vyrovnavaci pameti cen cest.\n# TYPE tsp_fitness_cache_hits_total counter\n"
+            << "tsp_fitness_cache_hits_total " << m.fitnessCacheHits << "\n";
+        out << "# HELP tsp_fitness_cache_misses_total Pocet chyb vyrovnavaci pameti cen cest.\n# TYPE tsp_fitness_cache_misses_total counter\n"
+            << "tsp_fitness_cache_misses_total " << m.fitnessCacheMisses << "\n";
+    }
+    out << "# HELP tsp_local_search_moves_total Pocet tahu lokalniho prohledavani.\n# TYPE tsp_local_search_moves_total counter\n"
+        << "tsp_local_search_moves_total " << m.localSearchMoves << "\n";
+    out << "# HELP tsp_process_resident_memory_bytes Rezidentni pamet procesu.\n# TYPE tsp_process_resident_memory_bytes gauge\n"
+        << "tsp_process_resident_memory_bytes " << (rssPages * pageSize) << "\n";
+    out << "# HELP tsp_process_virtual_memory_bytes Virtualni pamet procesu.\n# TYPE tsp_process_virtual_memory_bytes gauge\n"
+        << "tsp_process_virtual_memory_bytes " << (vmPages * pageSize) << "\n";
+
+    return out.str();
+}
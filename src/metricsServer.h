@@ -0,0 +1,68 @@
+/**
+* \file metricsServer.h
+* Export prubeznych metrik vypoctu ve formatu Prometheus.
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef METRICSSERVER_H_INCLUDED
+#define METRICSSERVER_H_INCLUDED
+
+#include <QThread>
+#include <QAtomicInt>
+#include <string>
+#include "tsp_evolution.h"
+
+using namespace std;
+
+/**
+ * Jednoduchy HTTP server (lokalni TCP port nebo Unix socket), ktery na kazdy pozadavek
+ * vrati aktualni metriky vypoctu v textovem formatu Prometheus.
+ * Server bezi ve vlastnim vlakne a metriky si vyzvedava od spravce evoluce, vypocet tak neblokuje.
+ */
+class MetricsServer : public QThread
+{
+    private:
+    TSPEvolution *tspEvolution;   ///< Spravce evoluce, jehoz metriky jsou exportovany.
+    int port;                     ///< TCP port (0 = TCP se nepouziva).
+    string socketPath;            ///< Cesta k Unix socketu (prazdna = Unix socket se nepouziva).
+    int listenFd;                 ///< Deskriptor naslouchajiciho socketu.
+    QAtomicInt abortFlag;         ///< Priznak ukonceni serveru.
+
+    /**
+    * Smycka obsluhy pozadavku.
+    */
+    void run();
+
+    /**
+     * Sestavi odpoved s aktualnimi metrikami.
+     * @return Telo odpovedi ve formatu Prometheus.
+     */
+    string BuildMetrics();
+
+    public:
+    /**
+    * Konstruktor.
+    * @param tspEvolution Spravce evoluce, jehoz metriky jsou exportovany.
+    */
+    MetricsServer(TSPEvolution *tspEvolution);
+
+    /**
+     * Destruktor.
+     */
+    ~MetricsServer();
+
+    /**
+     * Otevre naslouchajici socket a spusti vlakno serveru.
+     * @param port TCP port na adrese 127.0.0.1 (0 = nepouzije se).
+     * @param socketPath Cesta k Unix socketu (pouzije se, je-li port 0).
+     * @return Urcuje, zda-li se server podarilo spustit.
+     */
+    bool Listen(int port, string socketPath);
+
+    /**
+     * Ukonci server.
+     */
+    void Close();
+};
+
+#endif // METRICSSERVER_H_INCLUDED
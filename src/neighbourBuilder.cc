@@ -0,0 +1,153 @@
+#include <math.h>
+#include <algorithm>
+#include "neighbourBuilder.h"
+#include "tspLoader.h"
+
+/// Pocet mest v jednom bloku rozdelovanem mezi vlakna.
+static const int blockCities = 256;
+
+/// Pocet mest, od ktereho se vypocet rozdeluje mezi vice vlaken.
+static const int parallelThreshold = 2048;
+
+/// Porovnani mest podle vzdalenosti od vychoziho mesta (pro razeni sousedu).
+template <class T> class NeighbourCompare
+{
+    const T *row;   ///< Radek matice vychoziho mesta.
+
+    public:
+    NeighbourCompare(const void *row) : row((const T *)row) {}
+    bool operator()(int a, int b) const { return row[a] < row[b]; }
+};
+
+NeighbourBuilder::NeighbourBuilder()
+{
+    cityMatrix = NULL;
+    cityPosition = NULL;
+    type = EUC_2D;
+    useTree = false;
+    dimension = 0;
+    count = 0;
+    target = NULL;
+    blockCount = 0;
+}
+
+void NeighbourBuilder::Build(const CityMatrix &cityMatrix, const vector<CityPosition> &cityPosition, E_EDGE_WEIGHT type, int count, CityNeighbours &cityNeighbours)
+{
+    dimension = cityMatrix.IsEmpty() ? (int)cityPosition.size() : cityMatrix.GetDimension();
+    this->count = min(count, dimension - 1);
+
+    // Strom vyzaduje vzdalenost rostouci s eukleidovskou, jinak se radi radky matice (pripadne spocitane ze souradnic)
+    bool hasPositions = ((int)cityPosition.size() == dimension);
+    useTree = hasPositions && (type == EUC_2D || type == CEIL_2D || type == ATT);
+    if(this->count <= 0 || (!useTree && cityMatrix.IsEmpty() && !(hasPositions && type != EXPLICIT)))
+    {
+        cityNeighbours.Clear();
+        return;
+    }
+
+    this->cityMatrix = &cityMatrix;
+    this->cityPosition = &cityPosition;
+    this->type = type;
+
+    QSharedPointer<MatrixStorage> storage(new MatrixStorage);
+    storage->buffer.resize((size_t)dimension * this->count * sizeof(int));
+    target = (int *)&storage->buffer[0];
+
+    if(useTree)
+        tree.Build(cityPosition);
+
+    blockCount = (dimension + blockCities - 1) / blockCities;
+    int threadCount = 1;
+    if(dimension >= parallelThreshold)
+        threadCount = max(1, min(QThread::idealThreadCount(), blockCount));
+
+    nextBlock = 0;
+    vector<Worker *> workers;
+    for(int i = 1; i < threadCount; i++)
+    {
+        workers.push_back(new Worker(this));
+        workers.back()->start();
+    }
+
+    // Volajici vlakno pracuje take
+    Work();
+
+    for(unsigned int i = 0; i < workers.size(); i++)
+    {
+        workers[i]->wait();
+        delete workers[i];
+    }
+
+    cityNeighbours.Attach(dimension, this->count, target, storage);
+
+    tree.Clear();
+    this->cityMatrix = NULL;
+    this->cityPosition = NULL;
+    target = NULL;
+}
+
+void NeighbourBuilder::Work()
+{
+    vector<pair<double, int> > heap;
+    vector<int> neighbours;
+    vector<float> row;
+    vector<int> candidates;
+    if(!useTree)
+    {
+        row.resize(dimension);
+        candidates.resize(dimension - 1);
+    }
+
+    while(true)
+    {
+        int block = nextBlock.fetchAndAddOrdered(1);
+        if(block >= blockCount)
+            break;
+
+        // Ve stromu se mesta zpracovavaji v poradi listu (sousedni mesta prohledavaji tytez uzly)
+        int last = min((block + 1) * blockCities, dimension);
+        for(int k = block * blockCities; k < last; k++)
+        {
+            if(useTree)
+            {
+                int city = tree.GetOrder()[k];
+                tree.Nearest(city, count, neighbours, heap);
+                copy(neighbours.begin(), neighbours.end(), target + (size_t)city * count);
+            }
+            else
+                SearchRow(k, row, candidates);
+        }
+    }
+}
+
+void NeighbourBuilder::SearchRow(int city, vector<float> &row, vector<int> &candidates)
+{
+    for(int j = 0, k = 0; j < dimension; j++)
+        if(j != city)
+            candidates[k++] = j;
+
+    // Ostatni mesta se castecne seradi podle vzdalenosti (radek vyrovnavaci pameti nebo radek
+    // spocitany ze souradnic se nejdrive zkopiruje, aby se kazda vzdalenost nezamykala zvlast)
+    E_MATRIX_TYPE matrixType = cityMatrix->IsEmpty() ? MATRIX_CACHED : cityMatrix->GetType();
+    if(matrixType == MATRIX_UINT16)
+        partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), NeighbourCompare<unsigned short>(cityMatrix->Row(city)));
+    else if(matrixType == MATRIX_UINT32)
+        partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), NeighbourCompare<unsigned int>(cityMatrix->Row(city)));
+    else if(matrixType == MATRIX_FLOAT)
+        partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), NeighbourCompare<float>(cityMatrix->Row(city)));
+    else
+    {
+        if(cityMatrix->IsEmpty())
+        {
+            for(int j = 0; j < dimension; j++)
+                row[j] = CityDistance(type, (*cityPosition)[city], (*cityPosition)[j]);
+        }
+        else
+        {
+            cityMatrix->GetCache()->CopyRow(city, &row[0]);
+        }
+        partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), NeighbourCompare<float>(&row[0]));
+    }
+
+    copy(candidates.begin(), candidates.begin() + count, target + (size_t)city * count);
+}
@@ -0,0 +1,94 @@
+/**
+* \file neighbourBuilder.h
+* Paralelni vypocet seznamu nejblizsich sousedu mest.
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef NEIGHBOURBUILDER_H_INCLUDED
+#define NEIGHBOURBUILDER_H_INCLUDED
+
+#include <QThread>
+#include <QAtomicInt>
+#include <vector>
+#include "tsp_evolution.h"
+#include "cityMatrix.h"
+#include "cityTree.h"
+
+using namespace std;
+
+/**
+ * Vypocet seznamu K nejblizsich sousedu kazdeho mesta.
+ * U vzdalenosti odvozenych od eukleidovske (EUC_2D, CEIL_2D, ATT) se sousede hledaji v k-d stromu
+ * nad souradnicemi (CityTree). Matice vzdalenosti se pritom nepouziva vubec a vypocet neni
+ * kvadraticky ani u shlukovanych mest.
+ * U ostatnich uloh (GEO, EXPLICIT) se castecne radi radky matice (radek vyrovnavaci pameti se
+ * zkopiruje najednou, bez matice se radek spocita ze souradnic).
+ * Mesta se mezi vlakna rozdeluji po blocich dynamicky.
+ */
+class NeighbourBuilder
+{
+    private:
+    /**
+     * Pracovni vlakno vypoctu.
+     */
+    class Worker : public QThread
+    {
+        private:
+        NeighbourBuilder *builder;   ///< Vypocet, na kterem vlakno pracuje.
+
+        /**
+        * Zpracovava bloky mest, dokud nejsou vsechny hotove.
+        */
+        void run() { builder->Work(); }
+
+        public:
+        /**
+        * Konstruktor.
+        * @param builder Vypocet, na kterem vlakno pracuje.
+        */
+        Worker(NeighbourBuilder *builder) : builder(builder) {}
+    };
+    friend class Worker;
+
+    const CityMatrix *cityMatrix;               ///< Matice vzdalenosti (muze byt prazdna).
+    const vector<CityPosition> *cityPosition;   ///< Pozice mest.
+    E_EDGE_WEIGHT type;                         ///< Zpusob vypoctu vzdalenosti.
+    bool useTree;                               ///< Udava, zda-li se sousede hledaji v k-d stromu.
+    int dimension;                              ///< Pocet mest.
+    int count;                                  ///< Pocet sousedu kazdeho mesta.
+    int *target;                                ///< Vypocitavane seznamy (dimension * count indexu).
+    QAtomicInt nextBlock;                       ///< Dalsi nezpracovany blok mest.
+    int blockCount;                             ///< Pocet bloku mest.
+    CityTree tree;                              ///< K-d strom nad souradnicemi mest.
+
+    /**
+     * Zpracovava bloky mest (telo pracovniho vlakna).
+     */
+    void Work();
+
+    /**
+     * Najde sousedy mesta castecnym serazenim radku matice.
+     * @param city Mesto.
+     * @param row Pomocny radek vzdalenosti.
+     * @param candidates Pomocny seznam kandidatu.
+     */
+    void SearchRow(int city, vector<float> &row, vector<int> &candidates);
+
+    public:
+    /**
+     * Konstruktor.
+     */
+    NeighbourBuilder();
+
+    /**
+     * Vypocita seznamy nejblizsich sousedu.
+     * @param cityMatrix Matice vzdalenosti (u vypoctu v k-d stromu se nepouziva a muze byt prazdna).
+     * @param cityPosition Pozice mest (prazdne = sousede se hledaji jen v matici).
+     * @param type Zpusob vypoctu vzdalenosti.
+     * @param count Pocet sousedu kazdeho mesta (omezi se na pocet mest - 1).
+     * @param cityNeighbours Vypoctene seznamy sousedu.
+     */
+    void Build(const CityMatrix &cityMatrix, const vector<CityPosition> &cityPosition, E_EDGE_WEIGHT type, int count, CityNeighbours &cityNeighbours);
+};
+
+#endif // NEIGHBOURBUILDER_H_INCLUDED
@@ -0,0 +1,110 @@
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+#include "operatorBandit.h"
+
+OperatorBandit::OperatorBandit()
+{
+    Reset(1, 1, 0);
+}
+
+void OperatorBandit::Reset(int arms, int window, double exploration)
+{
+    gainSum.assign(arms, 0);
+    costSum.assign(arms, 0);
+    useSum.assign(arms, 0);
+    armPending.assign(arms, 0);
+    armUses.assign(arms, 0);
+    armGain.assign(arms, 0);
+    armCost.assign(arms, 0);
+    discount = 1.0 - 1.0 / max(window, 1);
+    this->exploration = exploration;
+}
+
+int OperatorBandit::Select(RandomGenerator &rng)
+{
+    int arms = armUses.size();
+
+    // Dosud nepouzite operatory maji prednost (nahodne jeden z nich)
+    int unseen = 0;
+    for(int i = 0; i < arms; i++)
+    {
+        if(useSum[i] == 0 && armPending[i] == 0)
+            unseen++;
+    }
+    if(unseen > 0)
+    {
+        int choice = rng.Int(unseen);
+        for(int i = 0; i < arms; i++)
+        {
+            if(useSum[i] == 0 && armPending[i] == 0 && choice-- == 0)
+            {
+                armPending[i]++;
+                return i;
+            }
+        }
+    }
+
+    // Jednotkou pruzkumu je prumerna doba nejlevnejsiho operatoru; kvalita se vztahuje k nejlepsimu
+    double unitCost = DBL_MAX, bestRate = 0;
+    for(int i = 0; i < arms; i++)
+    {
+        if(useSum[i] > 0 && costSum[i] > 0)
+        {
+            unitCost = min(unitCost, costSum[i] / useSum[i]);
+            bestRate = max(bestRate, gainSum[i] / costSum[i]);
+        }
+    }
+    if(unitCost == DBL_MAX)
+    {   // zatim neprisla zadna odmena
+        int arm = rng.Int(arms);
+        armPending[arm]++;
+        return arm;
+    }
+
+    // Efektivni pocet pouziti (cas v operatoru v jednotkach unitCost), vcetne cekajicich vyberu
+    vector<double> effective(arms);
+    double totalEffective = 0;
+    for(int i = 0; i < arms; i++)
+    {
+        double armUnitCost = (useSum[i] > 0) ? costSum[i] / useSum[i] : unitCost;
+        effective[i] = (costSum[i] + armPending[i] * armUnitCost) / unitCost;
+        totalEffective += effective[i];
+    }
+
+    int bestArm = 0;
+    double bestScore = -1;
+    double logTotal = log(max(totalEffective, 1.0));
+    for(int i = 0; i < arms; i++)
+    {
+        double quality = (bestRate > 0 && costSum[i] > 0) ? (gainSum[i] / costSum[i]) / bestRate : 0;
+        double score = quality + exploration * sqrt(2 * logTotal / max(effective[i], 1e-9));
+        if(score > bestScore)
+        {
+            bestScore = score;
+            bestArm = i;
+        }
+    }
+    armPending[bestArm]++;
+    return bestArm;
+}
+
+void OperatorBandit::Reward(int arm, double gain, double cost)
+{
+    // Starsi vysledky vsech operatoru ztraceji vahu
+    for(int i = 0; i < (int)armUses.size(); i++)
+    {
+        gainSum[i] *= discount;
+        costSum[i] *= discount;
+        useSum[i] *= discount;
+    }
+
+    if(armPending[arm] > 0)
+        armPending[arm]--;
+    gainSum[arm] += gain;
+    costSum[arm] += cost;
+    useSum[arm] += 1;
+    armUses[arm]++;
+    armGain[arm] += gain;
+    armCost[arm] += cost;
+}
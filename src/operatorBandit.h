@@ -0,0 +1,88 @@
+/**
+* \file operatorBandit.h
+* Adaptivni vyber genetickych operatoru (vicerameny bandita).
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef OPERATORBANDIT_H_INCLUDED
+#define OPERATORBANDIT_H_INCLUDED
+
+#include <vector>
+#include "randomGenerator.h"
+
+using namespace std;
+
+/**
+ * Vyber operatoru metodou UCB se zapominanim, ktera zohlednuje cenu (dobu behu) operatoru.
+ * Kvalitou operatoru je zlepseni na jednotku casu (soucet zlepseni / soucet doby behu).
+ * Soucty se pri kazde odmene nasobi koeficientem zapominani, takze vyber sleduje zmeny behem
+ * vypoctu (pamet je priblizne window pouziti). Clen za pruzkum se nepocita z poctu pouziti,
+ * ale z casu straveneho v operatoru (v nasobcich doby nejlevnejsiho operatoru), takze drahy
+ * operator se znovu zkousi jen zridka a spotrebuje-li cas, musi jej vyvazit zlepsenim.
+ * Odmeny mohou prichazet az po vice vyberech (po ohodnoceni cele generace); vybery cekajici
+ * na odmenu se do pruzkumu zapocitavaji hned.
+ */
+class OperatorBandit
+{
+    private:
+    vector<double> gainSum;      ///< Soucet zlepseni operatoru (se zapominanim).
+    vector<double> costSum;      ///< Soucet doby behu operatoru (se zapominanim).
+    vector<double> useSum;       ///< Pocet pouziti operatoru (se zapominanim).
+    vector<int> armPending;      ///< Pocet vyberu operatoru, za ktere jeste neprisla odmena.
+    vector<long long> armUses;   ///< Pocet ohodnocenych pouziti operatoru od inicializace.
+    vector<double> armGain;      ///< Soucet zlepseni operatoru od inicializace.
+    vector<double> armCost;      ///< Soucet doby behu operatoru od inicializace.
+    double discount;             ///< Koeficient zapominani (1 - 1 / window).
+    double exploration;          ///< Vaha clenu za pruzkum.
+
+    public:
+    /**
+    * Konstruktor.
+    */
+    OperatorBandit();
+
+    /**
+     * Inicializuje vyber (zapomene vsechny odmeny).
+     * @param arms Pocet operatoru.
+     * @param window Delka pameti (pocet pouziti, po kterem vaha odmeny klesne na 1/e).
+     * @param exploration Vaha clenu za pruzkum.
+     */
+    void Reset(int arms, int window, double exploration);
+
+    /**
+     * Vybere operator.
+     * @param rng Generator nahodnych cisel (pro vyber mezi dosud nepouzitymi operatory).
+     * @return Index operatoru.
+     */
+    int Select(RandomGenerator &rng);
+
+    /**
+     * Zaznamena vysledek pouziti operatoru.
+     * @param arm Index operatoru.
+     * @param gain Zlepseni (nezaporne).
+     * @param cost Doba behu operatoru (kladna).
+     */
+    void Reward(int arm, double gain, double cost);
+
+    /**
+     * Vrati pocet operatoru.
+     * @return Pocet operatoru.
+     */
+    int GetArmCount() const { return armUses.size(); }
+
+    /**
+     * Vrati pocet ohodnocenych pouziti operatoru od inicializace.
+     * @param arm Index operatoru.
+     * @return Pocet pouziti.
+     */
+    long long GetUses(int arm) const { return armUses[arm]; }
+
+    /**
+     * Vrati zlepseni na jednotku casu operatoru od inicializace.
+     * @param arm Index operatoru.
+     * @return Zlepseni na jednotku casu.
+     */
+    double GetRate(int arm) const { return (armCost[arm] > 0) ? armGain[arm] / armCost[arm] : 0; }
+};
+
+#endif // OPERATORBANDIT_H_INCLUDED
@@ -0,0 +1,386 @@
+#include <algorithm>
+#include "populationSeeder.h"
+#include "tspLoader.h"
+#include "neighbourBuilder.h"
+
+/// Pocet sousedu v seznamech, ktere se vypocitaji, nejsou-li k dispozici.
+static const int seedNeighbours = 10;
+
+/// Pravdepodobnost pokracovani do druheho nejblizsiho souseda (randomizace nejblizsiho souseda).
+static const double nearestDetour = 0.1;
+
+/// Relativni sum delky hran pri hladovem parovani.
+static const double greedyNoise = 0.1;
+
+/// Objem prace (pocet jedincu * pocet mest), od ktereho se tvorba rozdeluje mezi vice vlaken.
+static const long long parallelThreshold = 1 << 16;
+
+/// Hrana kandidatni na zarazeni do cesty.
+typedef struct
+{
+    double length;   ///< Delka hrany (zasumena).
+    int city1;       ///< Prvni mesto.
+    int city2;       ///< Druhe mesto.
+} tSeedEdge;
+
+/**
+ * Porovna hrany podle delky.
+ * @param edge1 Prvni hrana.
+ * @param edge2 Druha hrana.
+ * @return True, je-li prvni hrana kratsi.
+ */
+static bool SeedEdgeSort(const tSeedEdge &edge1, const tSeedEdge &edge2)
+{
+    return edge1.length < edge2.length;
+}
+
+/**
+ * Najde reprezentanta useku (mnoziny mest) s pulenim cesty.
+ * @param parent Rodice v lese mnozin.
+ * @param city Mesto.
+ * @return Reprezentant useku.
+ */
+static int FindFragment(vector<int> &parent, int city)
+{
+    while(parent[city] != city)
+    {
+        parent[city] = parent[parent[city]];
+        city = parent[city];
+    }
+    return city;
+}
+
+PopulationSeeder::PopulationSeeder()
+{
+    cityMatrix = NULL;
+    cityPosition = NULL;
+    dimension = 0;
+    population = NULL;
+    seed = 0;
+    cancelToken = NULL;
+}
+
+void PopulationSeeder::Generate(const CityMatrix &cityMatrix, const vector<CityPosition> &cityPosition, E_EDGE_WEIGHT type,
+                                const CityNeighbours &cityNeighbours, const double *weights, int size, unsigned long long seed, CancellationToken &cancelToken, vector<tIndividual> &population)
+{
+    this->cityMatrix = &cityMatrix;
+    this->cityPosition = &cityPosition;
+    this->cityNeighbours = cityNeighbours;
+    this->population = &population;
+    this->seed = seed;
+    this->cancelToken = &cancelToken;
+    dimension = cityMatrix.GetDimension();
+
+    // Rozdeleni jedincu mezi zpusoby tvorby podle vah (kumulativni zaokrouhleni)
+    double total = 0;
+    for(int i = 0; i < SEEDING_COUNT; i++)
+        total += max(0.0, weights[i]);
+    strategy.assign(size, SEEDING_RANDOM);
+    if(total > 0)
+    {
+        double cumulative = 0;
+        int first = 0;
+        for(int i = 0; i < SEEDING_COUNT; i++)
+        {
+            cumulative += max(0.0, weights[i]);
+            int last = (int)(size * cumulative / total + 0.5);
+            for(int j = first; j < last && j < size; j++)
+                strategy[j] = i;
+            first = last;
+        }
+    }
+
+    // Cesty podel krivky potrebuji souradnice, heuristiky seznamy sousedu
+    bool needNeighbours = false;
+    for(int i = 0; i < size; i++)
+    {
+        if(strategy[i] == SEEDING_CURVE && (int)cityPosition.size() != dimension)
+            strategy[i] = SEEDING_RANDOM;
+        needNeighbours = needNeighbours || strategy[i] == SEEDING_NEAREST || strategy[i] == SEEDING_GREEDY;
+    }
+    if(needNeighbours && this->cityNeighbours.GetCount() == 0)
+    {
+        NeighbourBuilder builder;
+        builder.Build(cityMatrix, cityPosition, type, seedNeighbours, this->cityNeighbours);
+    }
+    if(needNeighbours && (int)cityPosition.size() == dimension && (type == EUC_2D || type == CEIL_2D || type == ATT))
+        tree.Build(cityPosition);
+
+    tIndividual empty;
+    empty.price = 0;
+    empty.hash = 0;
+    population.assign(size, empty);
+
+    int threadCount = 1;
+    if((long long)size * dimension >= parallelThreshold)
+        threadCount = max(1, min(QThread::idealThreadCount(), size));
+
+    nextIndividual = 0;
+    vector<Worker *> workers;
+    for(int i = 1; i < threadCount; i++)
+    {
+        workers.push_back(new Worker(this));
+        workers.back()->start();
+    }
+
+    // Volajici vlakno pracuje take
+    while(ProcessIndividual());
+
+    for(unsigned int i = 0; i < workers.size(); i++)
+    {
+        workers[i]->wait();
+        delete workers[i];
+    }
+
+    tree.Clear();
+    this->cityMatrix = NULL;
+    this->cityPosition = NULL;
+    this->population = NULL;
+    this->cancelToken = NULL;
+}
+
+bool PopulationSeeder::ProcessIndividual()
+{
+    if(cancelToken->IsCancelled())
+        return false;
+
+    int index = nextIndividual.fetchAndAddOrdered(1);
+    if(index >= (int)population->size())
+        return false;
+
+    RandomGenerator rng(seed + index);
+    vector<int> &genome = (*population)[index].genome;
+    switch(strategy[index])
+    {
+        case SEEDING_NEAREST:
+            NearestNeighbourTour(rng, genome);
+            break;
+        case SEEDING_GREEDY:
+            GreedyTour(rng, genome);
+            break;
+        case SEEDING_CURVE:
+            CurveTour(rng, genome);
+            break;
+        default:
+            RandomTour(rng, genome);
+            break;
+    }
+
+    return true;
+}
+
+void PopulationSeeder::RandomTour(RandomGenerator &rng, vector<int> &genome)
+{
+    genome.resize(dimension);
+    for(int i = 0; i < dimension; i++)
+        genome[i] = i;
+    for(int i = dimension - 1; i > 0; i--)
+        swap(genome[i], genome[rng.Int(i + 1)]);
+}
+
+void PopulationSeeder::NearestNeighbourTour(RandomGenerator &rng, vector<int> &genome)
+{
+    // Nenavstivena mesta (odebirana vymenou s poslednim prvkem) pro hledani mimo seznam sousedu;
+    // ve strome se navstivena mesta odebiraji take
+    vector<int> remaining(dimension), remainingIndex(dimension);
+    for(int i = 0; i < dimension; i++)
+        remaining[i] = remainingIndex[i] = i;
+    CityTree::tRemovalState treeState;
+    if(!tree.IsEmpty())
+        tree.ResetState(treeState);
+
+    int count = cityNeighbours.GetCount();
+    genome.clear();
+    genome.reserve(dimension);
+    int city = rng.Int(dimension);
+    while(true)
+    {
+        genome.push_back(city);
+        int last = remaining.back();
+        remaining[remainingIndex[city]] = last;
+        remainingIndex[last] = remainingIndex[city];
+        remaining.pop_back();
+        remainingIndex[city] = -1;
+        if(!tree.IsEmpty())
+            tree.Remove(treeState, city);
+        if(remaining.empty())
+            break;
+
+        // Dva nejblizsi nenavstiveni sousede
+        const int *neighbour = cityNeighbours.Of(city);
+        int first = -1, second = -1;
+        for(int i = 0; i < count && second < 0; i++)
+        {
+            if(remainingIndex[neighbour[i]] < 0)
+                continue;
+            if(first < 0)
+                first = neighbour[i];
+            else
+                second = neighbour[i];
+        }
+
+        if(first >= 0)
+        {
+            city = (second >= 0 && rng.Real() < nearestDetour) ? second : first;
+            continue;
+        }
+
+        // Vsichni sousede jsou navstiveni, hleda se ve vsech nenavstivenych mestech
+        if(!tree.IsEmpty())
+        {
+            city = tree.NearestAlive(treeState, city);
+            continue;
+        }
+        int nearest = remaining[0];
+        double nearestDistance = cityMatrix->Distance(city, nearest);
+        for(int i = 1; i < (int)remaining.size(); i++)
+        {
+            double distance = cityMatrix->Distance(city, remaining[i]);
+            if(distance < nearestDistance)
+            {
+                nearestDistance = distance;
+                nearest = remaining[i];
+            }
+        }
+        city = nearest;
+    }
+}
+
+void PopulationSeeder::GreedyTour(RandomGenerator &rng, vector<int> &genome)
+{
+    // Kandidatni hrany ze seznamu sousedu serazene podle zasumene delky
+    int count = cityNeighbours.GetCount();
+    vector<tSeedEdge> edges;
+    edges.reserve((size_t)dimension * count);
+    for(int i = 0; i < dimension; i++)
+    {
+        const int *neighbour = cityNeighbours.Of(i);
+        for(int j = 0; j < count; j++)
+        {
+            tSeedEdge edge;
+            edge.city1 = i;
+            edge.city2 = neighbour[j];
+            edge.length = cityMatrix->Distance(i, neighbour[j]) * (1 + greedyNoise * rng.Real());
+            edges.push_back(edge);
+        }
+    }
+    sort(edges.begin(), edges.end(), SeedEdgeSort);
+
+    // Pridavani hran, ktere nevytvori mesto stupne 3 ani cyklus
+    vector<int> adjacent(2 * dimension, -1), parent(dimension);
+    for(int i = 0; i < dimension; i++)
+        parent[i] = i;
+    for(int i = 0; i < (int)edges.size(); i++)
+    {
+        int city1 = edges[i].city1, city2 = edges[i].city2;
+        if(adjacent[2 * city1 + 1] >= 0 || adjacent[2 * city2 + 1] >= 0)
+            continue;
+        int fragment1 = FindFragment(parent, city1), fragment2 = FindFragment(parent, city2);
+        if(fragment1 == fragment2)
+            continue;
+
+        adjacent[2 * city1 + (adjacent[2 * city1] >= 0 ? 1 : 0)] = city2;
+        adjacent[2 * city2 + (adjacent[2 * city2] >= 0 ? 1 : 0)] = city1;
+        parent[fragment1] = fragment2;
+    }
+
+    // Koncova mesta useku (mesta stupne 0 a 1); ve strome zustanou jen ona
+    vector<int> ends;
+    CityTree::tRemovalState treeState;
+    if(!tree.IsEmpty())
+        tree.ResetState(treeState);
+    for(int i = 0; i < dimension; i++)
+    {
+        if(adjacent[2 * i + 1] < 0)
+            ends.push_back(i);
+        else if(!tree.IsEmpty())
+            tree.Remove(treeState, i);
+    }
+
+    // Useky se prochazeji od konce ke konci a spojuji s nejblizsim koncem dosud nepouziteho useku
+    vector<char> fragmentDone(dimension, 0);
+    genome.clear();
+    genome.reserve(dimension);
+    int city = ends.empty() ? 0 : ends[rng.Int(ends.size())];
+    while(true)
+    {
+        if(!tree.IsEmpty())
+            tree.Remove(treeState, city);
+        int previous = -1;
+        while(true)
+        {
+            genome.push_back(city);
+            int next = adjacent[2 * city];
+            if(next < 0 || next == previous)
+                next = adjacent[2 * city + 1];
+            if(next < 0 || next == previous)
+                break;
+            previous = city;
+            city = next;
+        }
+        fragmentDone[FindFragment(parent, city)] = 1;
+
+        if(!tree.IsEmpty())
+        {   // konce pouziteho useku jsou ze stromu odebrane
+            tree.Remove(treeState, city);
+            city = tree.NearestAlive(treeState, city);
+            if(city < 0)
+                break;
+            continue;
+        }
+        int nearest = -1;
+        double nearestDistance = 0;
+        for(int i = 0; i < (int)ends.size(); i++)
+        {
+            if(fragmentDone[FindFragment(parent, ends[i])])
+            {   // konec pouziteho useku se vyradi
+                ends[i--] = ends.back();
+                ends.pop_back();
+                continue;
+            }
+            double distance = cityMatrix->Distance(city, ends[i]);
+            if(nearest < 0 || distance < nearestDistance)
+            {
+                nearest = ends[i];
+                nearestDistance = distance;
+            }
+        }
+        if(nearest < 0)
+            break;
+        city = nearest;
+    }
+}
+
+void PopulationSeeder::CurveTour(RandomGenerator &rng, vector<int> &genome)
+{
+    const vector<CityPosition> &position = *cityPosition;
+    double minX = position[0].x, maxX = position[0].x;
+    double minY = position[0].y, maxY = position[0].y;
+    for(int i = 1; i < dimension; i++)
+    {
+        minX = min(minX, position[i].x);
+        maxX = max(maxX, position[i].x);
+        minY = min(minY, position[i].y);
+        maxY = max(maxY, position[i].y);
+    }
+
+    // Mesta se posunou o nahodny kus rozsahu uvnitr dvojnasobne mrizky (deleni krivky na kvadranty
+    // pak u ruznych jedincu prochazi jinymi misty)
+    double extent = max(maxX - minX, maxY - minY);
+    if(extent <= 0)
+        extent = 1;
+    double shiftX = rng.Real() * extent, shiftY = rng.Real() * extent;
+    double scale = 65535.0 / (2 * extent);
+    vector<pair<unsigned int, int> > order(dimension);
+    for(int i = 0; i < dimension; i++)
+    {
+        double x = position[i].x - minX + shiftX;
+        double y = position[i].y - minY + shiftY;
+        order[i] = make_pair(HilbertIndex((unsigned int)(x * scale), (unsigned int)(y * scale)), i);
+    }
+    sort(order.begin(), order.end());
+
+    genome.resize(dimension);
+    for(int i = 0; i < dimension; i++)
+        genome[i] = order[i].second;
+}
@@ -0,0 +1,140 @@
+/**
+* \file populationSeeder.h
+* Paralelni tvorba pocatecni populace (nahodne cesty a cesty z konstrukcnich heuristik).
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef POPULATIONSEEDER_H_INCLUDED
+#define POPULATIONSEEDER_H_INCLUDED
+
+#include <QThread>
+#include <QAtomicInt>
+#include <vector>
+#include "tsp_evolution.h"
+#include "cityMatrix.h"
+#include "cityTree.h"
+#include "randomGenerator.h"
+#include "cancellationToken.h"
+
+using namespace std;
+
+/// Zpusoby tvorby pocatecnich cest.
+enum E_SEEDING
+{
+    SEEDING_RANDOM = 0,    ///< Nahodna permutace (Fisher-Yates).
+    SEEDING_NEAREST = 1,   ///< Randomizovany nejblizsi soused (po seznamech nejblizsich sousedu).
+    SEEDING_GREEDY = 2,    ///< Randomizovane hladove parovani hran.
+    SEEDING_CURVE = 3,     ///< Poradi mest na Hilbertove krivce s nahodnym posunutim mest v mrizce.
+    SEEDING_COUNT = 4      ///< Pocet zpusobu.
+};
+
+/**
+ * Tvorba pocatecni populace.
+ * Kazdy jedinec vznika jednim ze zpusobu E_SEEDING; pocty jedincu jednotlivych zpusobu odpovidaji
+ * zadanym podilum. Heuristiky pracuji se seznamy nejblizsich sousedu (nejsou-li k dispozici, vypocitaji
+ * se) a nejblizsi mesto mimo seznamy hledaji v k-d stromu nad souradnicemi, takze cesta vznikne
+ * priblizne v case O(n log n). Jen u vzdalenosti, ktere nelze hledat ve strome (GEO, EXPLICIT),
+ * se mimo seznamy prochazi vsechna zbyvajici mesta. Jedinci se mezi vlakna rozdeluji dynamicky;
+ * kazdy jedinec ma vlastni generator nahodnych cisel odvozeny z jeho indexu, takze vysledek nezavisi
+ * na poctu vlaken. Ceny cest se nepocitaji (ohodnoceni zustava na volajicim).
+ */
+class PopulationSeeder
+{
+    private:
+    /**
+     * Pracovni vlakno tvorby populace.
+     */
+    class Worker : public QThread
+    {
+        private:
+        PopulationSeeder *seeder;   ///< Tvorba populace, na ktere vlakno pracuje.
+
+        /**
+        * Vytvari jedince, dokud nejsou vsichni hotovi.
+        */
+        void run() { while(seeder->ProcessIndividual()); }
+
+        public:
+        /**
+        * Konstruktor.
+        * @param seeder Tvorba populace, na ktere vlakno pracuje.
+        */
+        Worker(PopulationSeeder *seeder) : seeder(seeder) {}
+    };
+    friend class Worker;
+
+    const CityMatrix *cityMatrix;                 ///< Matice vzdalenosti.
+    const vector<CityPosition> *cityPosition;     ///< Pozice mest (pro cesty podel krivky).
+    CityNeighbours cityNeighbours;                ///< Seznamy nejblizsich sousedu.
+    CityTree tree;                                ///< K-d strom nad souradnicemi (prazdny = hleda se linearne).
+    int dimension;                                ///< Pocet mest.
+    vector<tIndividual> *population;              ///< Vytvarena populace.
+    vector<int> strategy;                         ///< Zpusob tvorby kazdeho jedince (E_SEEDING).
+    unsigned long long seed;                      ///< Zaklad generatoru nahodnych cisel jedincu.
+    CancellationToken *cancelToken;               ///< Priznak preruseni.
+    QAtomicInt nextIndividual;                    ///< Dalsi nezpracovany jedinec.
+
+    /**
+     * Vytvori jednoho jedince.
+     * @return False, pokud jiz zadny jedinec nezbyva (nebo byla tvorba prerusena).
+     */
+    bool ProcessIndividual();
+
+    /**
+     * Vytvori nahodnou permutaci mest (Fisher-Yates).
+     * @param rng Generator nahodnych cisel.
+     * @param genome Vytvarena cesta.
+     */
+    void RandomTour(RandomGenerator &rng, vector<int> &genome);
+
+    /**
+     * Vytvori cestu randomizovanou metodou nejblizsiho souseda. Z nahodneho mesta se pokracuje
+     * do nejblizsiho nenavstiveneho souseda (s malou pravdepodobnosti do druheho nejblizsiho);
+     * jsou-li navstiveni vsichni sousede ze seznamu, hleda se nejblizsi nenavstivene mesto ze vsech
+     * (v k-d stromu, z nehoz se navstivena mesta odebiraji).
+     * @param rng Generator nahodnych cisel.
+     * @param genome Vytvarena cesta.
+     */
+    void NearestNeighbourTour(RandomGenerator &rng, vector<int> &genome);
+
+    /**
+     * Vytvori cestu hladovym parovanim hran. Hrany mezi sousedy se seradi podle delky (nahodne
+     * zasumene) a postupne se pridavaji ty, ktere nevytvori mesto stupne 3 ani predcasny cyklus.
+     * Vznikle useky se spoji metodou nejblizsiho souseda nad jejich koncovymi mesty (v k-d stromu
+     * obsahujicim jen konce dosud nepouzitych useku).
+     * @param rng Generator nahodnych cisel.
+     * @param genome Vytvarena cesta.
+     */
+    void GreedyTour(RandomGenerator &rng, vector<int> &genome);
+
+    /**
+     * Vytvori cestu podel Hilbertovy krivky; mesta se v mrizce krivky nahodne posunou, takze
+     * ruzni jedinci maji ruzne cesty.
+     * @param rng Generator nahodnych cisel.
+     * @param genome Vytvarena cesta.
+     */
+    void CurveTour(RandomGenerator &rng, vector<int> &genome);
+
+    public:
+    /**
+    * Konstruktor.
+    */
+    PopulationSeeder();
+
+    /**
+     * Vytvori pocatecni populaci.
+     * @param cityMatrix Matice vzdalenosti.
+     * @param cityPosition Pozice mest (prazdne = cesty podel krivky se nahradi nahodnymi).
+     * @param type Zpusob vypoctu vzdalenosti (pro vypocet seznamu sousedu a hledani ve strome).
+     * @param cityNeighbours Seznamy nejblizsich sousedu (prazdne = vypocitaji se, jsou-li potreba).
+     * @param weights Podily jednotlivych zpusobu tvorby (SEEDING_COUNT nezapornych vah).
+     * @param size Pocet jedincu.
+     * @param seed Zaklad generatoru nahodnych cisel.
+     * @param cancelToken Priznak preruseni (po preruseni je populace neuplna).
+     * @param population Vytvorena populace (ceny jedincu jsou nulove).
+     */
+    void Generate(const CityMatrix &cityMatrix, const vector<CityPosition> &cityPosition, E_EDGE_WEIGHT type, const CityNeighbours &cityNeighbours,
+                  const double *weights, int size, unsigned long long seed, CancellationToken &cancelToken, vector<tIndividual> &population);
+};
+
+#endif // POPULATIONSEEDER_H_INCLUDED
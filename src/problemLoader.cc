@@ -0,0 +1,38 @@
+#include "problemLoader.h"
+
+ProblemLoader::ProblemLoader()
+{
+    lastPercent = -1;
+}
+
+ProblemLoader::~ProblemLoader()
+{
+    cancelToken.Cancel();
+    wait();                // Pockani na dobehnuti vlakna
+}
+
+void ProblemLoader::Load(string fileName)
+{
+    wait();                // Predchozi nacitani musi byt dokonceno, nez se prepisou jeho data
+    this->fileName = fileName;
+    lastPercent = -1;
+    cancelToken.Reset();
+    start();
+}
+
+void ProblemLoader::run()
+{
+    long long memoryLimit = (long long)Config::GetInstance()->matrixMemoryLimit * 1024 * 1024;
+    bool success = LoadProblem(fileName, info, cityPosition, cityMatrix, cityNeighbours, Config::GetInstance()->integerDistances, memoryLimit, Config::GetInstance()->hilbertOrder, this);
+    emit ProblemLoaded(success);
+}
+
+void ProblemLoader::SetProgress(int done, int total)
+{
+    int percent = (total > 0) ? (int)((long long)done * 100 / total) : 100;
+    if(percent != lastPercent)
+    {
+        lastPercent = percent;
+        emit LoadProgress(percent);
+    }
+}
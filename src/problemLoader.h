@@ -0,0 +1,87 @@
+/**
+* \file problemLoader.h
+* Nacitani ulohy na pozadi (mimo vlakno uzivatelskeho rozhrani).
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef PROBLEMLOADER_H_INCLUDED
+#define PROBLEMLOADER_H_INCLUDED
+
+#include <QThread>
+#include <string>
+#include <vector>
+#include "tsp_evolution.h"
+#include "tspLoader.h"
+#include "cancellationToken.h"
+
+using namespace std;
+
+/**
+ * Vlakno, ktere nacte ulohu ze souboru a vypocita matici vzdalenosti.
+ * Prubeh vypoctu matice hlasi signalem, po dokonceni jsou nactena data k dispozici
+ * v clenskych promennych (do dalsiho spusteni nacitani).
+ */
+class ProblemLoader : public QThread, public MatrixProgress
+{
+    Q_OBJECT
+
+    private:
+    string fileName;      ///< Cesta k nacitanemu souboru.
+    int lastPercent;      ///< Naposledy ohlaseny postup (v procentech).
+    CancellationToken cancelToken;   ///< Priznak zruseni nacitani (vypocet matice se prerusi).
+
+    /**
+    * Nacteni ulohy.
+    */
+    void run();
+
+    public:
+    tProblemInfo info;                   ///< Informace o nactenem problemu.
+    vector<CityPosition> cityPosition;   ///< Pozice mest na mape.
+    CityMatrix cityMatrix;               ///< Matice vzdalenosti mest.
+    CityNeighbours cityNeighbours;       ///< Seznamy nejblizsich sousedu (jsou-li ulozeny v binarnim souboru ulohy).
+
+    /**
+    * Konstruktor.
+    */
+    ProblemLoader();
+
+    /**
+    * Destruktor; zrusi rozpracovane nacitani a pocka na dobehnuti vlakna.
+    */
+    ~ProblemLoader();
+
+    /**
+     * Spusti nacitani ulohy na pozadi.
+     * @param fileName Cesta k souboru s ulohou.
+     */
+    void Load(string fileName);
+
+    /**
+     * Prevede postup vypoctu matice na procenta a pri zmene jej ohlasi signalem.
+     * @param done Pocet zpracovanych jednotek prace.
+     * @param total Celkovy pocet jednotek prace.
+     */
+    void SetProgress(int done, int total);
+
+    /**
+     * Overi, zda-li bylo nacitani zruseno.
+     * @return True, pokud bylo nacitani zruseno.
+     */
+    bool IsCancelled() { return cancelToken.IsCancelled(); }
+
+    signals:
+    /**
+    * Signal zaslany pri zmene postupu nacitani.
+    * @param percent Postup v procentech.
+    */
+    void LoadProgress(int percent);
+
+    /**
+    * Signal zaslany po dokonceni nacitani.
+    * @param success Urcuje, zda-li se ulohu podarilo nacist.
+    */
+    void ProblemLoaded(bool success);
+};
+
+#endif // PROBLEMLOADER_H_INCLUDED
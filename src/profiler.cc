@@ -0,0 +1,270 @@
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <string.h>
+#include <errno.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "profiler.h"
+
+PhaseProfiler::PhaseProfiler()
+{
+    countersEnabled = false;
+    for(int i = 0; i < COUNTER_COUNT; i++)
+        counterFd[i] = -1;
+
+    Reset(false);
+}
+
+PhaseProfiler::~PhaseProfiler()
+{
+    CloseCounters();
+}
+
+void PhaseProfiler::Reset(bool enabled)
+{
+#ifndef TSP_NO_PROFILING
+    this->enabled = enabled;
+#else
+    (void)enabled;
+    this->enabled = false;
+#endif
+    generationCount = 0;
+    countersCollected = false;
+    for(int i = 0; i < PHASE_COUNT; i++)
+        phaseTotal[i] = phaseCurrent[i] = phaseLast[i] = phaseMax[i] = 0;
+    for(int i = 0; i <= PHASE_COUNT; i++)
+    {
+        for(int j = 0; j < COUNTER_COUNT; j++)
+            counterTotal[i][j] = counterCurrent[i][j] = counterLast[i][j] = 0;
+    }
+}
+
+bool PhaseProfiler::OpenCounters()
+{
+    CloseCounters();
+
+    if(!enabled)
+        return false;
+
+#ifdef __linux__
+    static const unsigned long long config[COUNTER_COUNT] =
+    {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    // Vsechny citace tvori jednu skupinu, aby je bylo mozne precist jednim volanim read(); citace
+    // se dedi do vlaken spustenych pozdeji (jejich hodnoty se po skonceni vlakna prictou ke skupine)
+    bool inherit = true;
+    for(int i = 0; i < COUNTER_COUNT; i++)
+    {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config[i];
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.disabled = (i == 0);
+        attr.inherit = inherit;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        counterFd[i] = syscall(__NR_perf_event_open, &attr, 0, -1, (i == 0) ? -1 : counterFd[0], 0);
+        if(counterFd[i] < 0 && inherit && errno == EINVAL)
+        {   // Starsi jadra nepodporuji dedeni u skupin, citace pak pokryvaji jen vlakno vypoctu
+            cerr << "Upozorneni: Dedeni hardwarovych citacu neni podporovano, citace pokryvaji pouze vlakno vypoctu." << endl;
+            CloseCounters();
+            inherit = false;
+            i = -1;
+            continue;
+        }
+        if(counterFd[i] < 0)
+        {
+            cerr << "Upozorneni: Hardwarove citace nejsou dostupne (" << strerror(errno) << "), meri se pouze doba behu." << endl;
+            CloseCounters();
+            return false;
+        }
+    }
+
+    ioctl(counterFd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(counterFd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    countersEnabled = countersCollected = true;
+    return true;
+#else
+    cerr << "Upozorneni: Hardwarove citace jsou podporovany pouze v systemu Linux, meri se pouze doba behu." << endl;
+    return false;
+#endif
+}
+
+void PhaseProfiler::CloseCounters()
+{
+    countersEnabled = false;
+#ifdef __linux__
+    for(int i = COUNTER_COUNT - 1; i >= 0; i--)
+    {
+        if(counterFd[i] >= 0)
+            close(counterFd[i]);
+        counterFd[i] = -1;
+    }
+#endif
+}
+
+bool PhaseProfiler::ReadCounters(long long *values)
+{
+#ifdef __linux__
+    // Format PERF_FORMAT_GROUP: pocet citacu nasledovany jejich hodnotami
+    unsigned long long buffer[1 + COUNTER_COUNT];
+    if(read(counterFd[0], buffer, sizeof(buffer)) != (ssize_t)sizeof(buffer))
+        return false;
+
+    for(int i = 0; i < COUNTER_COUNT; i++)
+        values[i] = (long long)buffer[i + 1];
+    return true;
+#else
+    (void)values;
+    return false;
+#endif
+}
+
+void PhaseProfiler::StartCounters()
+{
+    if(!ReadCounters(counterStart))
+        CloseCounters();
+}
+
+void PhaseProfiler::StopCounters(int row)
+{
+    long long values[COUNTER_COUNT];
+    if(!ReadCounters(values))
+    {
+        CloseCounters();
+        return;
+    }
+
+    for(int i = 0; i < COUNTER_COUNT; i++)
+        counterCurrent[row][i] += values[i] - counterStart[i];
+}
+
+void PhaseProfiler::EndGeneration()
+{
+    if(!enabled)
+        return;
+
+    for(int i = 0; i < PHASE_COUNT; i++)
+    {
+        phaseTotal[i] += phaseCurrent[i];
+        phaseLast[i] = phaseCurrent[i];
+        if(phaseCurrent[i] > phaseMax[i])
+            phaseMax[i] = phaseCurrent[i];
+        phaseCurrent[i] = 0;
+    }
+    for(int i = 0; i <= PHASE_COUNT; i++)
+    {
+        for(int j = 0; j < COUNTER_COUNT; j++)
+        {
+            counterTotal[i][j] += counterCurrent[i][j];
+            counterLast[i][j] = counterCurrent[i][j];
+            counterCurrent[i][j] = 0;
+        }
+    }
+    generationCount++;
+}
+
+string PhaseProfiler::Report() const
+{
+    stringstream out;
+
+    if(!enabled)
+    {
+        out << "Mereni doby behu fazi je vypnuto.\n";
+        return out.str();
+    }
+
+    long long sum = 0;
+    for(int i = 0; i < PHASE_COUNT; i++)
+        sum += phaseTotal[i];
+
+    // Faze, celkovy cas [ms], podil [%], prumer / posledni / maximum na generaci [ms]
+    out << std::fixed << std::setprecision(3);
+    for(int i = 0; i < PHASE_COUNT; i++)
+    {
+        double total = phaseTotal[i] / 1e6;
+        double share = (sum > 0) ? (100.0 * phaseTotal[i] / sum) : 0;
+        double avg = (generationCount > 0) ? (total / generationCount) : 0;
+        out << std::left << std::setw(10) << PhaseName((E_PHASE)i) << std::right
+            << std::setw(12) << total << " ms "
+            << std::setw(6) << std::setprecision(1) << share << " % " << std::setprecision(3)
+            << " prum. " << avg << " ms"
+            << " posl. " << (phaseLast[i] / 1e6) << " ms"
+            << " max. " << (phaseMax[i] / 1e6) << " ms\n";
+    }
+
+    // Celkove hodnoty hardwarovych citacu (takty, instrukce, IPC, vypadky LLC a chybne predikce skoku)
+    if(countersCollected)
+    {
+        for(int i = 0; i <= PHASE_COUNT; i++)
+        {
+            if(IsPerChild(i))
+                continue;
+            const long long *c = counterTotal[i];
+            out << std::left << std::setw(10) << CounterRowName(i) << std::right
+                << " takty " << c[COUNTER_CYCLES]
+                << " instr. " << c[COUNTER_INSTRUCTIONS]
+                << " IPC " << std::setprecision(2) << ((c[COUNTER_CYCLES] > 0) ? ((double)c[COUNTER_INSTRUCTIONS] / c[COUNTER_CYCLES]) : 0)
+                << " LLC " << c[COUNTER_LLC_MISSES]
+                << " skoky " << c[COUNTER_BRANCH_MISSES] << "\n";
+        }
+    }
+
+    return out.str();
+}
+
+string PhaseProfiler::GenerationCounterReport() const
+{
+    stringstream out;
+
+    if(!countersCollected)
+        return out.str();
+
+    // Pro kazdou fazi: IPC / vypadky LLC / chybne predikce skoku v posledni generaci
+    out << std::fixed << std::setprecision(2);
+    for(int i = 0; i <= PHASE_COUNT; i++)
+    {
+        if(IsPerChild(i))
+            continue;
+        const long long *c = counterLast[i];
+        out << CounterRowName(i) << " "
+            << ((c[COUNTER_CYCLES] > 0) ? ((double)c[COUNTER_INSTRUCTIONS] / c[COUNTER_CYCLES]) : 0) << "/"
+            << c[COUNTER_LLC_MISSES] << "/" << c[COUNTER_BRANCH_MISSES]
+            << ((i < PHASE_COUNT) ? "  " : "");
+    }
+
+    return out.str();
+}
+
+const char *PhaseProfiler::PhaseName(E_PHASE phase)
+{
+    switch(phase)
+    {
+        case PHASE_SELECTION:  return "selekce";
+        case PHASE_CROSSOVER:  return "krizeni";
+        case PHASE_MUTATION:   return "mutace";
+        case PHASE_EVALUATION: return "ohodnoceni";
+        case PHASE_ELITISM:    return "elitismus";
+        case PHASE_SURVIVE:    return "obnova";
+        case PHASE_LOCAL_SEARCH: return "lokalni";
+        default:               return "?";
+    }
+}
+
+const char *PhaseProfiler::CounterRowName(int row)
+{
+    return (row == PHASE_COUNT) ? "tvorba" : PhaseName((E_PHASE)row);
+}
@@ -0,0 +1,279 @@
+/**
+* \file profiler.h
+* Mereni doby behu jednotlivych fazi evolucniho kroku.
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef PROFILER_H_INCLUDED
+#define PROFILER_H_INCLUDED
+
+#include <string>
+#include <time.h>
+
+using namespace std;
+
+/// Faze evolucniho kroku, jejichz doba behu je merena.
+enum E_PHASE
+{
+    PHASE_SELECTION = 0,   ///< Turnajova selekce rodicu.
+    PHASE_CROSSOVER = 1,   ///< Aplikace operatoru krizeni.
+    PHASE_MUTATION = 2,    ///< Aplikace operatoru mutace.
+    PHASE_EVALUATION = 3,  ///< Ohodnoceni potomku.
+    PHASE_ELITISM = 4,     ///< Spojeni populaci a serazeni pro elitismus.
+    PHASE_SURVIVE = 5,     ///< Obnova populace (funkce Survive).
+    PHASE_LOCAL_SEARCH = 6,  ///< Lokalni prohledavani potomku.
+    PHASE_COUNT = 7        ///< Pocet merenych fazi.
+};
+
+/// Hardwarove citace procesoru snimane behem jednotlivych fazi (Linux perf_event_open).
+enum E_COUNTER
+{
+    COUNTER_CYCLES = 0,         ///< Pocet taktu procesoru.
+    COUNTER_INSTRUCTIONS = 1,   ///< Pocet provedenych instrukci.
+    COUNTER_LLC_MISSES = 2,     ///< Pocet vypadku posledni urovne cache.
+    COUNTER_BRANCH_MISSES = 3,  ///< Pocet chybne predikovanych skoku.
+    COUNTER_COUNT = 4           ///< Pocet snimanych citacu.
+};
+
+/**
+ * Akumulator doby behu fazi evolucniho kroku.
+ * Kazde vlakno vypoctu vlastni svou instanci, pri mereni se proto nepouziva zadne zamykani.
+ * Mereni lze vypnout za prekladu (makro TSP_NO_PROFILING) nebo za behu (parametr PROFILING).
+ * Volitelne jsou snimany i hardwarove citace procesoru (parametr PERF_COUNTERS); nejsou-li
+ * dostupne, meri se pouze doba behu. Citace zahrnuji i pracovni vlakna spustena vlaknem vypoctu
+ * (lokalni prohledavani, tvorba populace), pokud to jadro podporuje. Faze merene pro kazdeho potomka
+ * zvlast (selekce, krizeni, mutace) jsou kratke, jejich citace se proto snimaji souhrnne za celou
+ * tvorbu potomku (radek "tvorba").
+ */
+class PhaseProfiler
+{
+    private:
+    bool enabled;                              ///< Udava, zda-li je mereni zapnuto.
+    int generationCount;                       ///< Pocet uzavrenych generaci.
+    long long phaseTotal[PHASE_COUNT];         ///< Celkova doba behu fazi od inicializace [ns].
+    long long phaseCurrent[PHASE_COUNT];       ///< Doba behu fazi v prave probihajici generaci [ns].
+    long long phaseLast[PHASE_COUNT];          ///< Doba behu fazi v posledni dokoncene generaci [ns].
+    long long phaseMax[PHASE_COUNT];           ///< Nejdelsi doba behu fazi v ramci jedne generace [ns].
+
+    bool countersEnabled;                                  ///< Udava, zda-li jsou snimany hardwarove citace.
+    bool countersCollected;                                ///< Udava, zda-li byly v aktualnim behu citace snimany.
+    int counterFd[COUNTER_COUNT];                          ///< Deskriptory otevrenych citacu (prvni je vedouci skupiny).
+    long long counterStart[COUNTER_COUNT];                 ///< Stav citacu na zacatku prave merene faze.
+    long long counterTotal[PHASE_COUNT + 1][COUNTER_COUNT];    ///< Celkove hodnoty citacu od inicializace (posledni radek = tvorba potomku).
+    long long counterCurrent[PHASE_COUNT + 1][COUNTER_COUNT];  ///< Hodnoty citacu v prave probihajici generaci.
+    long long counterLast[PHASE_COUNT + 1][COUNTER_COUNT];     ///< Hodnoty citacu v posledni dokoncene generaci.
+
+    /**
+     * Precte aktualni stav vsech citacu skupiny jednim systemovym volanim.
+     * @param values Pole pro ulozeni hodnot citacu.
+     * @return Urcuje, zda-li se cteni podarilo.
+     */
+    bool ReadCounters(long long *values);
+
+    /**
+     * Ulozi stav citacu na zacatku faze.
+     */
+    void StartCounters();
+
+    /**
+     * Pricte prirustek citacu od zacatku faze.
+     * @param row Radek akumulatoru citacu (faze nebo tvorba potomku).
+     */
+    void StopCounters(int row);
+
+    /**
+     * Zjisti, zda-li je faze merena pro kazdeho potomka zvlast (jeji citace se snimaji za celou tvorbu potomku).
+     * @param phase Faze.
+     * @return True pro selekci, krizeni a mutaci.
+     */
+    static bool IsPerChild(int phase) { return phase == PHASE_SELECTION || phase == PHASE_CROSSOVER || phase == PHASE_MUTATION; }
+
+    public:
+    /**
+    * Konstruktor.
+    */
+    PhaseProfiler();
+
+    /**
+    * Destruktor.
+    */
+    ~PhaseProfiler();
+
+    /**
+     * Vynuluje vsechny akumulatory.
+     * @param enabled Udava, zda-li ma byt mereni zapnuto.
+     */
+    void Reset(bool enabled);
+
+    /**
+     * Otevre hardwarove citace pro volajici vlakno (musi byt volano z vlakna, ktere se meri).
+     * @return Urcuje, zda-li jsou citace k dispozici.
+     */
+    bool OpenCounters();
+
+    /**
+     * Uzavre hardwarove citace.
+     */
+    void CloseCounters();
+
+    /**
+     * Vrati aktualni cas monotonnich hodin.
+     * @return Cas v nanosekundach.
+     */
+    static long long Now()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+
+    /**
+     * Zahaji mereni faze.
+     * @param counters Udava, zda-li se maji snimat i hardwarove citace (u fazi merenych pro kazdeho
+     * potomka zvlast se nesnimaji, viz StartBreeding()).
+     * @return Casova znacka zacatku faze (0, je-li mereni vypnuto).
+     */
+    long long Start(bool counters = true)
+    {
+#ifndef TSP_NO_PROFILING
+        if(enabled)
+        {
+            if(counters && countersEnabled)
+                StartCounters();
+            return Now();
+        }
+#endif
+        return 0;
+    }
+
+    /**
+     * Ukonci mereni faze a pricte jeji dobu do akumulatoru.
+     * @param phase Merena faze.
+     * @param startTime Casova znacka ziskana funkci Start().
+     * @param counters Udava, zda-li byly pri zahajeni faze snimany citace.
+     */
+    void Stop(E_PHASE phase, long long startTime, bool counters = true)
+    {
+#ifndef TSP_NO_PROFILING
+        if(enabled)
+        {
+            phaseCurrent[phase] += Now() - startTime;
+            if(counters && countersEnabled)
+                StopCounters(phase);
+        }
+#else
+        (void)phase;
+        (void)startTime;
+        (void)counters;
+#endif
+    }
+
+    /**
+     * Zahaji snimani citacu za celou tvorbu potomku (selekce, krizeni a mutace).
+     */
+    void StartBreeding()
+    {
+#ifndef TSP_NO_PROFILING
+        if(enabled && countersEnabled)
+            StartCounters();
+#endif
+    }
+
+    /**
+     * Ukonci snimani citacu za celou tvorbu potomku.
+     */
+    void StopBreeding()
+    {
+#ifndef TSP_NO_PROFILING
+        if(enabled && countersEnabled)
+            StopCounters(PHASE_COUNT);
+#endif
+    }
+
+    /**
+     * Uzavre mereni aktualni generace (prevede casy do celkovych akumulatoru).
+     */
+    void EndGeneration();
+
+    /**
+     * Zjisti, zda-li je mereni zapnuto.
+     * @return Stav mereni.
+     */
+    bool IsEnabled() const { return enabled; }
+
+    /**
+     * Vrati pocet uzavrenych generaci.
+     * @return Pocet generaci.
+     */
+    int GetGenerationCount() const { return generationCount; }
+
+    /**
+     * Vrati celkovou dobu behu faze.
+     * @param phase Faze.
+     * @return Doba behu [ns].
+     */
+    long long GetTotal(E_PHASE phase) const { return phaseTotal[phase]; }
+
+    /**
+     * Vrati dobu behu faze v posledni dokoncene generaci.
+     * @param phase Faze.
+     * @return Doba behu [ns].
+     */
+    long long GetLast(E_PHASE phase) const { return phaseLast[phase]; }
+
+    /**
+     * Vrati nejdelsi dobu behu faze v ramci jedne generace.
+     * @param phase Faze.
+     * @return Doba behu [ns].
+     */
+    long long GetMax(E_PHASE phase) const { return phaseMax[phase]; }
+
+    /**
+     * Zjisti, zda-li jsou snimany hardwarove citace.
+     * @return Stav citacu.
+     */
+    bool HasCounters() const { return countersEnabled; }
+
+    /**
+     * Vrati celkovou hodnotu citace v dane fazi (u selekce, krizeni a mutace 0, viz GetBreedingCounterTotal()).
+     * @param phase Faze.
+     * @param counter Citac.
+     * @return Hodnota citace.
+     */
+    long long GetCounterTotal(E_PHASE phase, E_COUNTER counter) const { return counterTotal[phase][counter]; }
+
+    /**
+     * Vrati celkovou hodnotu citace za tvorbu potomku (selekce, krizeni a mutace dohromady).
+     * @param counter Citac.
+     * @return Hodnota citace.
+     */
+    long long GetBreedingCounterTotal(E_COUNTER counter) const { return counterTotal[PHASE_COUNT][counter]; }
+
+    /**
+     * Sestavi textovy prehled namerenych casu (jeden radek na fazi).
+     * @return Textovy prehled.
+     */
+    string Report() const;
+
+    /**
+     * Sestavi jednoradkovy prehled hardwarovych citacu posledni dokoncene generace.
+     * @return Textovy prehled (prazdny, nejsou-li citace k dispozici).
+     */
+    string GenerationCounterReport() const;
+
+    /**
+     * Vrati nazev faze.
+     * @param phase Faze.
+     * @return Nazev faze.
+     */
+    static const char *PhaseName(E_PHASE phase);
+
+    /**
+     * Vrati nazev radku akumulatoru citacu.
+     * @param row Radek (faze nebo PHASE_COUNT pro tvorbu potomku).
+     * @return Nazev radku.
+     */
+    static const char *CounterRowName(int row);
+};
+
+#endif // PROFILER_H_INCLUDED
@@ -0,0 +1,91 @@
+/**
+* \file randomGenerator.h
+* Generator pseudonahodnych cisel s ulozitelnym stavem.
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef RANDOMGENERATOR_H_INCLUDED
+#define RANDOMGENERATOR_H_INCLUDED
+
+/**
+ * Generator pseudonahodnych cisel (xorshift64*).
+ * Na rozdil od funkce rand() ma stav, ktery lze ulozit do kontrolniho bodu a pozdeji obnovit,
+ * a kazde vlakno muze mit vlastni instanci.
+ */
+class RandomGenerator
+{
+    private:
+    unsigned long long state;   ///< Vnitrni stav generatoru (nesmi byt nulovy).
+
+    public:
+    /**
+    * Konstruktor.
+    * @param seed Pocatecni hodnota generatoru.
+    */
+    RandomGenerator(unsigned long long seed = 1)
+    {
+        Seed(seed);
+    }
+
+    /**
+     * Nastavi pocatecni hodnotu generatoru.
+     * @param seed Pocatecni hodnota generatoru.
+     */
+    void Seed(unsigned long long seed)
+    {
+        // Promichani pocatecni hodnoty (splitmix64), aby i blizke hodnoty davaly ruzne posloupnosti
+        seed += 0x9E3779B97F4A7C15ULL;
+        seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+        seed ^= seed >> 31;
+        state = (seed != 0) ? seed : 0x2545F4914F6CDD1DULL;
+    }
+
+    /**
+     * Vrati vnitrni stav generatoru.
+     * @return Stav generatoru.
+     */
+    unsigned long long GetState() const { return state; }
+
+    /**
+     * Obnovi vnitrni stav generatoru.
+     * @param state Stav generatoru ziskany funkci GetState().
+     */
+    void SetState(unsigned long long state)
+    {
+        this->state = (state != 0) ? state : 0x2545F4914F6CDD1DULL;
+    }
+
+    /**
+     * Vygeneruje dalsi pseudonahodne cislo.
+     * @return 32bitove pseudonahodne cislo.
+     */
+    unsigned int Next()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return (unsigned int)((state * 0x2545F4914F6CDD1DULL) >> 32);
+    }
+
+    /**
+     * Vygeneruje pseudonahodne cele cislo z intervalu <0, n).
+     * @param n Horni mez intervalu (n > 0).
+     * @return Pseudonahodne cislo.
+     */
+    int Int(int n)
+    {
+        return (int)(((unsigned long long)Next() * (unsigned int)n) >> 32);
+    }
+
+    /**
+     * Vygeneruje pseudonahodne realne cislo z intervalu <0, 1).
+     * @return Pseudonahodne cislo.
+     */
+    double Real()
+    {
+        return Next() * (1.0 / 4294967296.0);
+    }
+};
+
+#endif // RANDOMGENERATOR_H_INCLUDED
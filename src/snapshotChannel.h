@@ -0,0 +1,80 @@
+/**
+* \file snapshotChannel.h
+* Predavani posledniho stavu mezi vlakny bez zamku (trojity buffer).
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef SNAPSHOTCHANNEL_H_INCLUDED
+#define SNAPSHOTCHANNEL_H_INCLUDED
+
+#include <QAtomicInt>
+
+/**
+ * Kanal pro predavani posledniho stavu (snimku) od jednoho zapisovatele jednomu ctenari.
+ * Zapisovatel a ctenar maji kazdy svuj buffer, treti buffer se mezi nimi vymenuje atomickou
+ * operaci. Zapisovatel nikdy neceka; ctenar vzdy dostane nejnovejsi snimek a snimky, ktere
+ * mezitim prepsal novejsi, se zahodi. Buffery se opakovane pouzivaji, takze po zahrati
+ * se pri predavani nealokuje.
+ */
+template <class T> class SnapshotChannel
+{
+    private:
+    enum
+    {
+        indexMask = 3,   ///< Maska indexu sdileneho bufferu.
+        freshFlag = 4    ///< Priznak nepreceteneho snimku ve sdilenem bufferu.
+    };
+
+    T buffer[3];         ///< Buffery snimku.
+    int back;            ///< Buffer zapisovatele.
+    int front;           ///< Buffer ctenare.
+    QAtomicInt middle;   ///< Sdileny buffer (index a priznak freshFlag).
+
+    public:
+    /**
+    * Konstruktor.
+    */
+    SnapshotChannel() : back(0), front(1), middle(2) {}
+
+    /**
+     * Vrati buffer zapisovatele, do ktereho se pripravuje dalsi snimek.
+     * @return Buffer zapisovatele.
+     */
+    T &Back() { return buffer[back]; }
+
+    /**
+     * Zverejni pripraveny snimek (vola jen zapisovatel, nikdy neceka).
+     */
+    void Publish()
+    {
+        back = middle.fetchAndStoreOrdered(back | freshFlag) & indexMask;
+    }
+
+    /**
+     * Prevezme nejnovejsi zverejneny snimek (vola jen ctenar).
+     * @return True, pokud byl od posledniho volani zverejnen novy snimek.
+     */
+    bool Update()
+    {
+        if(!((int)middle & freshFlag))
+            return false;
+        front = middle.fetchAndStoreOrdered(front) & indexMask;
+        return true;
+    }
+
+    /**
+     * Vrati buffer ctenare s naposledy prevzatym snimkem (patri ctenari do dalsiho Update).
+     * @return Buffer ctenare.
+     */
+    T &Front() { return buffer[front]; }
+
+    /**
+     * Zahodi neprevzaty snimek (jen ve chvili, kdy zapisovatel nebezi).
+     */
+    void Reset()
+    {
+        middle.fetchAndStoreOrdered((int)middle & indexMask);
+    }
+};
+
+#endif // SNAPSHOTCHANNEL_H_INCLUDED
@@ -8,5 +8,8 @@ DEPENDPATH += .
 INCLUDEPATH += .
 
 # Input
-HEADERS += config.h mapWidget.h tsp_evolution.h workSpace.h
-SOURCES += config.cc main.cc mapWidget.cc tsp_evolution.cc workSpace.cc
+HEADERS += cancellationToken.h chartWidget.h checkpoint.h cityMatrix.h cityTree.h config.h distanceCache.h indexedHeap.h localSearch.h mapWidget.h matrixBuilder.h metricsServer.h neighbourBuilder.h operatorBandit.h populationSeeder.h problemLoader.h profiler.h randomGenerator.h snapshotChannel.h statisticsLog.h tourHash.h tsp_evolution.h tspLoader.h tsplibParser.h workSpace.h
+SOURCES += chartWidget.cc checkpoint.cc cityMatrix.cc cityTree.cc config.cc distanceCache.cc indexedHeap.cc localSearch.cc main.cc mapWidget.cc matrixBuilder.cc metricsServer.cc neighbourBuilder.cc operatorBandit.cc populationSeeder.cc problemLoader.cc profiler.cc statisticsLog.cc tourHash.cc tsp_evolution.cc tspLoader.cc tsplibParser.cc workSpace.cc
+
+# Mereni doby behu fazi lze vypnout za prekladu: DEFINES += TSP_NO_PROFILING
+LIBS += -lrt
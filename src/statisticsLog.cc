@@ -0,0 +1,110 @@
+#include <iostream>
+#include "statisticsLog.h"
+
+/// Kapacita fronty zaznamu (mocnina dvou).
+static const int queueCapacity = 8192;
+
+/// Prodleva zapisovaciho vlakna pri prazdne fronte [ms].
+static const int pollInterval = 50;
+
+StatisticsLog::StatisticsLog() : QThread()
+{
+    file = NULL;
+    queue.resize(queueCapacity);
+}
+
+StatisticsLog::~StatisticsLog()
+{
+    Close();
+}
+
+bool StatisticsLog::Open(string fileName, bool append)
+{
+    Close();
+
+    file = fopen(fileName.c_str(), append ? "a" : "w");
+    if(file == NULL)
+    {
+        cerr << "Chyba! Soubor se statistikami " << fileName << " nelze otevrit." << endl;
+        return false;
+    }
+
+    // Hlavicka se zapisuje jen do noveho (prazdneho) souboru
+    if(ftell(file) == 0)
+        fprintf(file, "generation,min,avg,max,best,evaluations,seconds\n");
+    fflush(file);
+
+    head = 0;
+    tail = 0;
+    dropped = 0;
+    abortFlag = 0;
+    start();
+
+    return true;
+}
+
+void StatisticsLog::Close()
+{
+    if(file == NULL)
+        return;
+
+    abortFlag.fetchAndStoreRelease(1);
+    wait();
+
+    if((int)dropped > 0)
+        cerr << "Upozorneni: Do souboru se statistikami nebylo zapsano " << (int)dropped << " zaznamu (plna fronta)." << endl;
+    fclose(file);
+    file = NULL;
+}
+
+bool StatisticsLog::Push(const tGenerationRecord &record)
+{
+    int actHead = head;
+    int nextHead = (actHead + 1) & (queueCapacity - 1);
+    if(nextHead == tail.fetchAndAddAcquire(0))
+    {   // fronta je plna
+        dropped.ref();
+        return false;
+    }
+
+    queue[actHead] = record;
+    head.fetchAndStoreRelease(nextHead);   // zaznam je zapsan drive, nez jej konzument uvidi
+    return true;
+}
+
+int StatisticsLog::Drain()
+{
+    int actTail = tail;
+    int actHead = head.fetchAndAddAcquire(0);
+    int count = 0;
+
+    while(actTail != actHead)
+    {
+        const tGenerationRecord &record = queue[actTail];
+        fprintf(file, "%d,%.15g,%.15g,%.15g,%.15g,%lld,%.3f\n", record.generation, record.minPrice, record.avgPrice,
+                record.maxPrice, record.bestPrice, record.evaluationCount, record.elapsedTime);
+        actTail = (actTail + 1) & (queueCapacity - 1);
+        count++;
+    }
+
+    if(count > 0)
+    {
+        tail.fetchAndStoreRelease(actTail);
+        fflush(file);
+    }
+    return count;
+}
+
+void StatisticsLog::run()
+{
+    while(true)
+    {
+        bool abort = (abortFlag.fetchAndAddAcquire(0) != 0);
+        if(Drain() == 0)
+        {
+            if(abort)
+                break;
+            msleep(pollInterval);
+        }
+    }
+}
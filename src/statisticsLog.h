@@ -0,0 +1,96 @@
+/**
+* \file statisticsLog.h
+* Prubezny zapis statistik generaci do souboru (CSV).
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef STATISTICSLOG_H_INCLUDED
+#define STATISTICSLOG_H_INCLUDED
+
+#include <QThread>
+#include <QAtomicInt>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/// Zaznam statistik jedne generace.
+typedef struct
+{
+    int generation;             ///< Cislo generace.
+    double minPrice;            ///< Nejlepsi cena cesty v populaci.
+    double avgPrice;            ///< Prumerna cena cesty v populaci.
+    double maxPrice;            ///< Nejhorsi cena cesty v populaci.
+    double bestPrice;           ///< Nejlepsi cena cesty od inicializace.
+    long long evaluationCount;  ///< Pocet ohodnoceni genomu.
+    double elapsedTime;         ///< Doba behu vypoctu [s].
+} tGenerationRecord;
+
+/**
+ * Zapisovac statistik generaci bezici ve vlastnim vlakne.
+ * Vypocet predava zaznamy pres frontu bez zamku (jeden producent, jeden konzument) s pevnou
+ * kapacitou, takze spotreba pameti nezavisi na delce behu; pri zaplneni fronty se zaznam
+ * zahodi (vypocet nikdy neceka na disk). Zapisovac soubor po kazde davce vyprazdni,
+ * takze jej lze prubezne sledovat (napr. tail -f).
+ */
+class StatisticsLog : public QThread
+{
+    private:
+    FILE *file;                         ///< Vystupni soubor (NULL = zapis neprobiha).
+    vector<tGenerationRecord> queue;    ///< Kruhova fronta zaznamu.
+    QAtomicInt head;                    ///< Pozice pro dalsi vkladany zaznam (meni jen producent).
+    QAtomicInt tail;                    ///< Pozice dalsiho zapisovaneho zaznamu (meni jen konzument).
+    QAtomicInt dropped;                 ///< Pocet zaznamu zahozenych pri plne fronte.
+    QAtomicInt abortFlag;               ///< Priznak ukonceni vlakna.
+
+    /**
+    * Smycka zapisu zaznamu.
+    */
+    void run();
+
+    /**
+     * Zapise vsechny zaznamy cekajici ve fronte.
+     * @return Pocet zapsanych zaznamu.
+     */
+    int Drain();
+
+    public:
+    /**
+    * Konstruktor.
+    */
+    StatisticsLog();
+
+    /**
+     * Destruktor (zapise cekajici zaznamy a zavre soubor).
+     */
+    ~StatisticsLog();
+
+    /**
+     * Otevre soubor a spusti zapisovaci vlakno.
+     * @param fileName Cesta k vystupnimu souboru.
+     * @param append Urcuje, zda-li se ma pridavat na konec existujiciho souboru.
+     * @return Urcuje, zda-li se soubor podarilo otevrit.
+     */
+    bool Open(string fileName, bool append);
+
+    /**
+     * Zapise cekajici zaznamy, ukonci zapisovaci vlakno a zavre soubor.
+     */
+    void Close();
+
+    /**
+     * Vrati, zda-li je soubor otevren.
+     * @return True, pokud zapis probiha.
+     */
+    bool IsOpen() const { return file != NULL; }
+
+    /**
+     * Vlozi zaznam do fronty (vola jen vlakno vypoctu, bez zamku).
+     * @param record Zaznam statistik generace.
+     * @return False, pokud byla fronta plna a zaznam byl zahozen.
+     */
+    bool Push(const tGenerationRecord &record);
+};
+
+#endif // STATISTICSLOG_H_INCLUDED
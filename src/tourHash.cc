@@ -0,0 +1,116 @@
+#include "tourHash.h"
+#include "randomGenerator.h"
+
+/// Pocatecni hodnota generatoru klicu mest (klice jsou pro dany pocet mest vzdy stejne).
+static const unsigned long long keySeed = 0x5DEECE66DULL;
+
+void TourHash::Init(int dimension)
+{
+    RandomGenerator rng(keySeed);
+    cityKey.resize(dimension);
+    for(int i = 0; i < dimension; i++)
+        cityKey[i] = ((unsigned long long)rng.Next() << 32) | rng.Next() | 1;
+}
+
+unsigned long long TourHash::Compute(const vector<int> &genome) const
+{
+    int dimension = genome.size();
+    unsigned long long hash = 0;
+    for(int i = 0; i < dimension - 1; i++)
+        hash ^= Edge(genome[i], genome[i + 1]);
+    if(dimension > 0)
+        hash ^= Edge(genome[dimension - 1], genome[0]);
+
+    return (hash != 0) ? hash : 1;
+}
+
+unsigned long long TourHash::EdgesAt(const vector<int> &genome, const int *positions, int count) const
+{
+    unsigned long long hash = 0;
+    for(int i = 0; i < count; i++)
+    {
+        bool repeated = false;
+        for(int j = 0; j < i; j++)
+            repeated = repeated || (positions[j] == positions[i]);
+        if(!repeated)
+            hash ^= EdgeAt(genome, positions[i]);
+    }
+
+    return hash;
+}
+
+FitnessCache::FitnessCache()
+{
+    Reset(0);
+}
+
+void FitnessCache::Reset(int size)
+{
+    int capacity = 1;
+    while(capacity < size)
+        capacity *= 2;
+
+    tEntry empty = {0, 0};
+    entries.assign((size > 0) ? capacity : 0, empty);
+    mask = capacity - 1;
+    hits = 0;
+    misses = 0;
+}
+
+bool FitnessCache::Lookup(unsigned long long hash, double &price)
+{
+    const tEntry &entry = entries[Index(hash)];
+    if(entry.hash != hash)
+    {
+        misses++;
+        return false;
+    }
+
+    price = entry.price;
+    hits++;
+    return true;
+}
+
+TourSet::TourSet()
+{
+    Reset(0);
+}
+
+void TourSet::Reset(int count)
+{
+    int capacity = 2;
+    while(capacity < 2 * count)
+        capacity *= 2;
+
+    table.assign(capacity, 0);
+    mask = capacity - 1;
+    size = 0;
+}
+
+bool TourSet::Insert(unsigned long long hash)
+{
+    // Zaplni-li se tabulka do poloviny, zdvojnasobi se a prvky se vlozi znovu
+    if(2 * (size + 1) > (int)table.size())
+    {
+        vector<unsigned long long> old;
+        old.swap(table);
+        Reset(size + 1);
+        for(unsigned int i = 0; i < old.size(); i++)
+        {
+            if(old[i] != 0)
+                Insert(old[i]);
+        }
+    }
+
+    unsigned long long index = (hash ^ (hash >> 32)) & mask;
+    while(table[index] != 0)
+    {
+        if(table[index] == hash)
+            return false;
+        index = (index + 1) & mask;
+    }
+
+    table[index] = hash;
+    size++;
+    return true;
+}
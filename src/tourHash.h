@@ -0,0 +1,188 @@
+/**
+* \file tourHash.h
+* Hash okruzni cesty nezavisly na pocatecnim meste a smeru a vyrovnavaci pamet cen cest.
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef TOURHASH_H_INCLUDED
+#define TOURHASH_H_INCLUDED
+
+#include <vector>
+
+using namespace std;
+
+/**
+ * Hash okruzni cesty (Zobrist) nad mnozinou neorientovanych hran.
+ * Kazde mesto ma nahodny klic, klic hrany vznika promichanim soucinu klicu obou mest (nezalezi
+ * tedy na smeru hrany) a hash cesty je XOR klicu vsech jejich hran. Cesta se stejnymi hranami
+ * ma stejny hash bez ohledu na pocatecni mesto a smer pruchodu. Zmena nekolika hran (napr. mutaci
+ * 2-opt) se do hashe promitne v konstantnim case: klice odebranych hran se XORuji ven a klice
+ * pridanych dovnitr.
+ */
+class TourHash
+{
+    private:
+    vector<unsigned long long> cityKey;   ///< Nahodne klice mest (liche).
+
+    public:
+    /**
+     * Vygeneruje klice mest (klice zavisi jen na poctu mest).
+     * @param dimension Pocet mest.
+     */
+    void Init(int dimension);
+
+    /**
+     * Vrati klic neorientovane hrany.
+     * @param city1 Index prvniho mesta.
+     * @param city2 Index druheho mesta.
+     * @return Klic hrany.
+     */
+    unsigned long long Edge(int city1, int city2) const
+    {
+        unsigned long long key = cityKey[city1] * cityKey[city2];
+        return key ^ (key >> 29);
+    }
+
+    /**
+     * Vrati klic hrany vychazejici z dane pozice genomu (k naslednikovi, cyklicky).
+     * @param genome Permutace mest.
+     * @param position Pozice v genomu.
+     * @return Klic hrany.
+     */
+    unsigned long long EdgeAt(const vector<int> &genome, int position) const
+    {
+        int next = (position + 1 < (int)genome.size()) ? position + 1 : 0;
+        return Edge(genome[position], genome[next]);
+    }
+
+    /**
+     * Spocita hash cele cesty.
+     * @param genome Permutace mest.
+     * @return Hash cesty (nikdy 0).
+     */
+    unsigned long long Compute(const vector<int> &genome) const;
+
+    /**
+     * Vrati XOR klicu hran vychazejicich z danych pozic genomu (kazda pozice se zapocita jednou).
+     * Zavola-li se pred zmenou genomu s pozicemi odebranych hran a po ni s pozicemi pridanych hran
+     * a oba vysledky se XORuji do hashe, hash odpovida zmenene ceste.
+     * @param genome Permutace mest.
+     * @param positions Pozice v genomu.
+     * @param count Pocet pozic.
+     * @return XOR klicu hran.
+     */
+    unsigned long long EdgesAt(const vector<int> &genome, const int *positions, int count) const;
+};
+
+/**
+ * Vyrovnavaci pamet cen cest indexovana hashem cesty.
+ * Tabulka s pevnym poctem polozek (mocnina dvou) a primym mapovanim: nova cena prepise polozku
+ * se stejnym indexem, takze pamet nikdy neroste a vyhledani i vlozeni je konstantni. Shoda se
+ * posuzuje podle celeho 64bitoveho hashe.
+ */
+class FitnessCache
+{
+    private:
+    /// Polozka vyrovnavaci pameti.
+    typedef struct
+    {
+        unsigned long long hash;   ///< Hash cesty (0 = prazdna polozka).
+        double price;              ///< Cena cesty.
+    } tEntry;
+
+    vector<tEntry> entries;        ///< Polozky.
+    unsigned long long mask;       ///< Maska indexu polozky.
+    long long hits;                ///< Pocet zasahu.
+    long long misses;              ///< Pocet chyb.
+
+    /**
+     * Vrati index polozky pro hash (slozi horni a dolni polovinu hashe).
+     * @param hash Hash cesty.
+     * @return Index polozky.
+     */
+    int Index(unsigned long long hash) const { return (int)((hash ^ (hash >> 32)) & mask); }
+
+    public:
+    /**
+    * Konstruktor.
+    */
+    FitnessCache();
+
+    /**
+     * Vyprazdni pamet a nastavi jeji velikost.
+     * @param size Pozadovany pocet polozek (zaokrouhli se nahoru na mocninu dvou; 0 = pamet se nepouziva).
+     */
+    void Reset(int size);
+
+    /**
+     * Vrati, zda-li se pamet pouziva.
+     * @return True, ma-li pamet nenulovou velikost.
+     */
+    bool IsEnabled() const { return !entries.empty(); }
+
+    /**
+     * Vyhleda cenu cesty.
+     * @param hash Hash cesty.
+     * @param price Cil pro nalezenou cenu.
+     * @return True, byla-li cena nalezena.
+     */
+    bool Lookup(unsigned long long hash, double &price);
+
+    /**
+     * Ulozi cenu cesty.
+     * @param hash Hash cesty.
+     * @param price Cena cesty.
+     */
+    void Store(unsigned long long hash, double price)
+    {
+        tEntry &entry = entries[Index(hash)];
+        entry.hash = hash;
+        entry.price = price;
+    }
+
+    /**
+     * Vrati pocet zasahu.
+     * @return Pocet zasahu od posledniho Reset().
+     */
+    long long GetHits() const { return hits; }
+
+    /**
+     * Vrati pocet chyb.
+     * @return Pocet chyb od posledniho Reset().
+     */
+    long long GetMisses() const { return misses; }
+};
+
+/**
+ * Mnozina hashu cest (otevrene adresovani s linearnim prohledavanim).
+ * Tabulka ma alespon dvojnasobek slotu proti poctu prvku, vlozeni i dotaz jsou tak v prumeru
+ * konstantni. Prvky nelze jednotlive odebirat, mnozina se jen cela vyprazdni.
+ */
+class TourSet
+{
+    private:
+    vector<unsigned long long> table;   ///< Sloty tabulky (0 = prazdny slot; hash cesty neni nikdy 0).
+    unsigned long long mask;            ///< Maska indexu slotu.
+    int size;                           ///< Pocet prvku.
+
+    public:
+    /**
+    * Konstruktor.
+    */
+    TourSet();
+
+    /**
+     * Vyprazdni mnozinu a pripravi ji pro dany pocet prvku.
+     * @param count Ocekavany pocet prvku (pri prekroceni se tabulka zvetsi).
+     */
+    void Reset(int count);
+
+    /**
+     * Vlozi hash cesty do mnoziny.
+     * @param hash Hash cesty (nenulovy).
+     * @return True, nebyl-li hash v mnozine.
+     */
+    bool Insert(unsigned long long hash);
+};
+
+#endif // TOURHASH_H_INCLUDED
@@ -0,0 +1,595 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "tspLoader.h"
+#include "neighbourBuilder.h"
+
+/// Verze binarniho formatu.
+static const unsigned int binaryVersion = 1;
+
+/// Zarovnani matice v binarnim souboru (velikost stranky).
+static const long long binaryAlignment = 4096;
+
+/**
+ * Zarovna pozici v souboru nahoru na nasobek zarovnani.
+ * @param offset Pozice v souboru.
+ * @param alignment Zarovnani.
+ * @return Zarovnana pozice.
+ */
+static long long AlignOffset(long long offset, long long alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * Precte sekci souradnic mest (NODE_COORD_SECTION nebo DISPLAY_DATA_SECTION).
+ * @param parser Cteny soubor.
+ * @param section Nazev sekce (pro chybova hlaseni).
+ * @param dimension Dimenze ulohy (0, neni-li dosud znama).
+ * @param threeDimensional Urcuje, zda-li maji zaznamy tri souradnice.
+ * @param cityPosition Pozice mest na mape.
+ * @param coordCount Pocet prectenych zaznamu (zvysuje se).
+ * @return Urcuje, zda-li se sekci podarilo precist.
+ */
+static bool ReadCoordinateSection(TSPLIBParser &parser, const string &section, int dimension, bool threeDimensional, vector<CityPosition> &cityPosition, int &coordCount)
+{
+    long long cityIndex;
+    double x, y, z;
+    while(parser.ReadInt(cityIndex))
+    {
+        if(!parser.ReadDouble(x) || !parser.ReadDouble(y) || (threeDimensional && !parser.ReadDouble(z)))
+        {
+            cerr << "Chyba! Neplatny zaznam v sekci " << section << " (mesto " << cityIndex << ")." << endl;
+            return false;
+        }
+
+        if(dimension > 0)
+        {
+            if(cityIndex < 1 || cityIndex > dimension)
+            {
+                cerr << "Chyba! Index mesta " << cityIndex << " je mimo rozsah dimenze ulohy." << endl;
+                return false;
+            }
+            cityPosition[cityIndex - 1].x = x;
+            cityPosition[cityIndex - 1].y = y;
+        }
+        else
+        {   // dimenze neni uvedena pred sekci - mesta se pridavaji v poradi souboru
+            CityPosition actCity;
+            actCity.x = x;
+            actCity.y = y;
+            cityPosition.push_back(actCity);
+        }
+        coordCount++;
+    }
+
+    return true;
+}
+
+/**
+ * Precte sekci EDGE_WEIGHT_SECTION primo do matice vzdalenosti (bez mezivysledku).
+ * U trojuhelnikovych formatu se kazda vzdalenost zapise symetricky do obou polovin matice.
+ * @param parser Cteny soubor.
+ * @param dimension Dimenze ulohy.
+ * @param format Format zapisu matice (EDGE_WEIGHT_FORMAT).
+ * @param cityMatrix Nactena matice vzdalenosti.
+ * @param integerDistances Urcuje, zda-li se maji vzdalenosti ulozit celociselne (zaokrouhlene).
+ * @return Urcuje, zda-li se sekci podarilo precist.
+ */
+static bool ReadEdgeWeightSection(TSPLIBParser &parser, int dimension, const string &format, CityMatrix &cityMatrix, bool integerDistances)
+{
+    // Sloupcovy zapis jednoho trojuhelniku symetricke matice je shodny s radkovym zapisem druheho
+    bool full = false, upper = false, diagonal = false;
+    if(format == "FULL_MATRIX")
+        full = true;
+    else if(format == "UPPER_ROW" || format == "LOWER_COL")
+        upper = true;
+    else if(format == "LOWER_ROW" || format == "UPPER_COL")
+        upper = false;
+    else if(format == "UPPER_DIAG_ROW" || format == "LOWER_DIAG_COL")
+        upper = diagonal = true;
+    else if(format == "LOWER_DIAG_ROW" || format == "UPPER_DIAG_COL")
+        diagonal = true;
+    else
+    {
+        cerr << "Chyba! Format matice vzdalenosti " << format << " neni podporovan." << endl;
+        return false;
+    }
+
+    float *matrix = integerDistances ? NULL : cityMatrix.Allocate(dimension);
+    unsigned int *integerMatrix = integerDistances ? cityMatrix.AllocateInteger(dimension) : NULL;
+    double weight;
+    for(int i = 0; i < dimension; i++)
+    {
+        int from = (full || !upper) ? 0 : (diagonal ? i : i + 1);
+        int to = (full || upper) ? dimension : (diagonal ? i + 1 : i);
+        for(int j = from; j < to; j++)
+        {
+            if(!parser.ReadDouble(weight))
+            {
+                cerr << "Chyba! Sekce EDGE_WEIGHT_SECTION neobsahuje vsechny vzdalenosti." << endl;
+                cityMatrix.Clear();
+                return false;
+            }
+            if(integerDistances)
+            {
+                unsigned int value = (weight > 0) ? (unsigned int)min(weight + 0.5, (double)UINT_MAX) : 0;
+                integerMatrix[(size_t)i * dimension + j] = value;
+                if(!full)
+                    integerMatrix[(size_t)j * dimension + i] = value;
+            }
+            else
+            {
+                matrix[(size_t)i * dimension + j] = weight;
+                if(!full)
+                    matrix[(size_t)j * dimension + i] = weight;
+            }
+        }
+    }
+
+    if(integerDistances)
+        cityMatrix.Narrow();
+
+    return true;
+}
+
+void CoordinateRowSource::FillRow(int row, float *target)
+{
+    int dimension = cityPosition.size();
+    for(int j = 0; j < dimension; j++)
+        target[j] = Distance(row, j);
+}
+
+float CoordinateRowSource::Distance(int i, int j)
+{
+    if(i == j)
+        return 0;
+
+    double distance = CityDistance(type, cityPosition[i], cityPosition[j]);
+    return integerDistances ? (float)(unsigned int)(distance + 0.5) : (float)distance;
+}
+
+bool LoadProblem(string fileName, tProblemInfo &info, vector<CityPosition> &cityPosition, CityMatrix &cityMatrix, CityNeighbours &cityNeighbours, bool integerDistances, long long memoryLimit, bool hilbertOrder, MatrixProgress *progress, bool buildMatrix)
+{
+    cityPosition.clear();
+    cityMatrix.Clear();
+    cityNeighbours.Clear();
+    info.cityId.clear();
+
+    // Rozliseni formatu podle identifikace na zacatku souboru
+    char magic[8] = { 0 };
+    FILE *file = fopen(fileName.c_str(), "rb");
+    if(file == NULL)
+    {
+        cerr << "Chyba! Vstupni soubor s daty nelze otevrit." << endl;
+        return false;
+    }
+    size_t magicLength = fread(magic, 1, sizeof(magic), file);
+    fclose(file);
+
+    bool binary = (magicLength == sizeof(magic) && memcmp(magic, TSP_BINARY_MAGIC, sizeof(magic)) == 0);
+    if(binary)
+    {
+        if(!LoadBinaryProblem(fileName, info, cityPosition, cityMatrix, cityNeighbours, integerDistances))
+            return false;
+    }
+    else if(!LoadTextProblem(fileName, info, cityPosition, cityMatrix, integerDistances))
+    {
+        return false;
+    }
+
+    // Matice se dopocita, neni-li predpocitana nebo primo zadana v souboru
+    if(cityMatrix.IsEmpty() && info.edgeWeightType == EXPLICIT)
+    {
+        cerr << "Chyba! Soubor neobsahuje matici vzdalenosti a ze souradnic ji dopocitat nelze." << endl;
+        return false;
+    }
+
+    // Nesymetricka muze byt jen zadana matice (FULL_MATRIX); overi se pred pripadnym nahrazenim vyrovnavaci pameti
+    info.symmetric = (info.edgeWeightType != EXPLICIT || cityMatrix.IsSymmetric());
+    if(!info.symmetric)
+        cout << "Upozorneni: Matice vzdalenosti neni symetricka." << endl;
+
+    // Precislovat lze jen mesta, jejichz matice se teprve spocita (ulozene seznamy sousedu se zahodi)
+    if(hilbertOrder && cityMatrix.IsEmpty())
+    {
+        RenumberCities(info, cityPosition);
+        cityNeighbours.Clear();
+    }
+    else if(hilbertOrder)
+    {
+        cout << "Upozorneni: Matice vzdalenosti je zadana v souboru, mesta se neprecisluji." << endl;
+    }
+
+    // Matice, ktera by prekrocila limit pameti, se nahradi vyrovnavaci pameti radku plnenou
+    // ze souradnic nebo z matice namapovane ze souboru (textova matice EXPLICIT uz je nactena cela)
+    long long matrixSize = (long long)info.dimension * info.dimension * sizeof(float);
+    if(memoryLimit > 0 && matrixSize > memoryLimit && (cityMatrix.IsEmpty() || binary))
+    {
+        DistanceRowSource *source;
+        if(cityMatrix.IsEmpty())
+            source = new CoordinateRowSource(cityPosition, info.edgeWeightType, integerDistances);
+        else
+            source = new MatrixRowSource(cityMatrix);
+
+        QSharedPointer<DistanceRowCache> cache(new DistanceRowCache(info.dimension, memoryLimit, source, info.edgeWeightType != EXPLICIT));
+        cityMatrix.AttachCache(info.dimension, cache);
+        cout << "Matice vzdalenosti presahuje limit pameti, pouzije se vyrovnavaci pamet pro " << cache->GetCapacity() << " radku." << endl;
+    }
+
+    if(cityMatrix.IsEmpty() && buildMatrix)
+    {
+        BuildCityMatrix(cityPosition, info.edgeWeightType, cityMatrix, integerDistances, progress);
+        if(progress != NULL && progress->IsCancelled())
+            return false;
+    }
+
+    return true;
+}
+
+bool LoadTextProblem(string fileName, tProblemInfo &info, vector<CityPosition> &cityPosition, CityMatrix &cityMatrix, bool integerDistances)
+{
+    TSPLIBParser parser;
+    if(!parser.Open(fileName))
+    {
+        cerr << "Chyba! Vstupni soubor s daty nelze otevrit." << endl;
+        return false;
+    }
+
+    info.name.clear();
+    info.comment.clear();
+    info.dimension = 0;
+    info.edgeWeightType = EUC_2D;
+    cityPosition.clear();
+
+    bool threeDimensional = false;
+    int coordCount = 0;
+    string edgeWeightFormat;
+    string keyword, value;
+
+    // Zpracovani hlavicky a sekci souboru
+    while(parser.ReadKeyword(keyword, value))
+    {
+        if(keyword == "EOF")
+        {   // ukonceni nacitani, je-li na radku "EOF" (nektere soubory formatu TSPLib tak cini)
+            break;
+        }
+        else if(keyword == "NAME")
+            info.name = value;
+        else if(keyword == "COMMENT")
+            info.comment = info.comment.empty() ? value : (info.comment + " " + value);
+        else if(keyword == "DIMENSION")
+        {
+            info.dimension = atoi(value.c_str());
+            cityPosition.assign(info.dimension > 0 ? info.dimension : 0, CityPosition());
+        }
+        else if(keyword == "EDGE_WEIGHT_TYPE")
+        {
+            if(value == "EUC_2D")
+                info.edgeWeightType = EUC_2D;
+            else if(value == "CEIL_2D")
+                info.edgeWeightType = CEIL_2D;
+            else if(value == "ATT")
+                info.edgeWeightType = ATT;
+            else if(value == "GEO")
+                info.edgeWeightType = GEO;
+            else if(value == "EXPLICIT")
+                info.edgeWeightType = EXPLICIT;
+            else
+                cerr << "Upozorneni: Typ vzdalenosti " << value << " neni podporovan, pouzije se EUC_2D." << endl;
+        }
+        else if(keyword == "NODE_COORD_TYPE")
+        {
+            threeDimensional = (value == "THREED_COORDS");
+        }
+        else if(keyword == "EDGE_WEIGHT_FORMAT")
+        {
+            edgeWeightFormat = value;
+        }
+        else if(keyword == "NODE_COORD_SECTION" || keyword == "DISPLAY_DATA_SECTION")
+        {   // sekce souradnic: "index x y" (u THREED_COORDS i z, ktera se ignoruje)
+            if(!ReadCoordinateSection(parser, keyword, info.dimension, threeDimensional && keyword == "NODE_COORD_SECTION", cityPosition, coordCount))
+                return false;
+        }
+        else if(keyword == "EDGE_WEIGHT_SECTION")
+        {
+            if(info.edgeWeightType != EXPLICIT || info.dimension <= 0)
+            {
+                cerr << "Chyba! Sekce EDGE_WEIGHT_SECTION vyzaduje EDGE_WEIGHT_TYPE: EXPLICIT a predchozi DIMENSION." << endl;
+                return false;
+            }
+            if(!ReadEdgeWeightSection(parser, info.dimension, edgeWeightFormat, cityMatrix, integerDistances))
+                return false;
+        }
+        else if(value.empty() && keyword.find("_SECTION") != keyword.npos)
+        {   // nepodporovana sekce - preskoceni jejich cisel
+            double number;
+            while(parser.ReadDouble(number))
+                ;
+        }
+    }
+
+    if(info.dimension <= 0)
+        info.dimension = cityPosition.size();
+    if(info.edgeWeightType == EXPLICIT && cityMatrix.IsEmpty())
+    {
+        cerr << "Chyba! Vstupni soubor neobsahuje sekci EDGE_WEIGHT_SECTION." << endl;
+        return false;
+    }
+
+    if(info.edgeWeightType == EXPLICIT && coordCount < info.dimension)
+    {   // bez souradnic pro zobrazeni se mesta rozmisti rovnomerne na kruznici
+        cityPosition.resize(info.dimension);
+        for(int i = 0; i < info.dimension; i++)
+        {
+            cityPosition[i].x = 1000.0 * cos(2 * M_PI * i / info.dimension);
+            cityPosition[i].y = 1000.0 * sin(2 * M_PI * i / info.dimension);
+        }
+    }
+    else if(info.dimension <= 0 || coordCount < info.dimension)
+    {
+        cerr << "Chyba! Vstupni soubor neobsahuje souradnice vsech mest." << endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool LoadBinaryProblem(string fileName, tProblemInfo &info, vector<CityPosition> &cityPosition, CityMatrix &cityMatrix, CityNeighbours &cityNeighbours, bool integerDistances)
+{
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        cerr << "Chyba! Vstupni soubor s daty nelze otevrit." << endl;
+        return false;
+    }
+
+    struct stat fileInfo;
+    if(fstat(fd, &fileInfo) != 0 || fileInfo.st_size < (off_t)sizeof(tBinaryHeader))
+    {
+        close(fd);
+        return false;
+    }
+
+    // Namapovani celeho souboru; mapovani drzi sdilena pamet, dokud existuje matice nebo seznamy sousedu
+    QSharedPointer<MatrixStorage> storage(new MatrixStorage);
+    storage->mapLength = fileInfo.st_size;
+    storage->mapAddress = mmap(NULL, storage->mapLength, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(storage->mapAddress == MAP_FAILED)
+    {
+        storage->mapAddress = NULL;
+        cerr << "Chyba! Vstupni soubor s daty nelze namapovat do pameti." << endl;
+        return false;
+    }
+
+    const char *base = (const char *)storage->mapAddress;
+    tBinaryHeader header;
+    memcpy(&header, base, sizeof(header));
+
+    // Kontrola hlavicky a velikosti jednotlivych casti
+    long long n = header.dimension;
+    long long fileSize = fileInfo.st_size;
+    E_MATRIX_TYPE matrixType = (header.flags & TSP_BINARY_UINT16) ? MATRIX_UINT16 : ((header.flags & TSP_BINARY_UINT32) ? MATRIX_UINT32 : MATRIX_FLOAT);
+    long long elementSize = (matrixType == MATRIX_UINT16) ? sizeof(unsigned short) : sizeof(float);
+    if(header.byteOrder != 0x01020304 || header.version != binaryVersion || n <= 0 || header.neighbourCount < 0 ||
+       header.coordOffset < (long long)sizeof(header) || header.coordOffset + n * 2 * (long long)sizeof(double) > fileSize ||
+       ((header.flags & TSP_BINARY_MATRIX) && (header.matrixOffset % elementSize != 0 || header.matrixOffset + n * n * elementSize > fileSize)) ||
+       (header.neighbourCount > 0 && (header.neighbourOffset % sizeof(int) != 0 || header.neighbourOffset + n * header.neighbourCount * (long long)sizeof(int) > fileSize)))
+    {
+        cerr << "Chyba! Binarni soubor s ulohou je poskozen nebo ma nepodporovanou verzi." << endl;
+        return false;
+    }
+
+    header.name[sizeof(header.name) - 1] = '\0';
+    header.comment[sizeof(header.comment) - 1] = '\0';
+    info.name = header.name;
+    info.comment = header.comment;
+    info.dimension = header.dimension;
+    info.edgeWeightType = (header.edgeWeightType <= EXPLICIT) ? (E_EDGE_WEIGHT)header.edgeWeightType : EUC_2D;
+
+    // Souradnice mest
+    const double *coords = (const double *)(base + header.coordOffset);
+    cityPosition.resize(info.dimension);
+    for(int i = 0; i < info.dimension; i++)
+    {
+        cityPosition[i].x = coords[2 * i];
+        cityPosition[i].y = coords[2 * i + 1];
+    }
+
+    // Predpocitana matice a seznamy sousedu se pouziji primo z namapovaneho souboru
+    // (matice jineho typu, nez je pozadovan, se dopocita ze souradnic - lze-li to)
+    if((header.flags & TSP_BINARY_MATRIX) && ((matrixType != MATRIX_FLOAT) == integerDistances || info.edgeWeightType == EXPLICIT))
+    {
+        madvise((void *)(base + header.matrixOffset / binaryAlignment * binaryAlignment), n * n * elementSize, MADV_WILLNEED);
+        cityMatrix.Attach(info.dimension, matrixType, base + header.matrixOffset, storage);
+    }
+    if(header.neighbourCount > 0)
+        cityNeighbours.Attach(info.dimension, header.neighbourCount, (const int *)(base + header.neighbourOffset), storage);
+
+    return true;
+}
+
+bool SaveBinaryProblem(string fileName, const tProblemInfo &info, const vector<CityPosition> &cityPosition, const CityMatrix *cityMatrix, const CityNeighbours *cityNeighbours)
+{
+    long long n = info.dimension;
+    if(n <= 0 || (long long)cityPosition.size() != n)
+        return false;
+    if(cityMatrix != NULL && cityMatrix->GetDimension() != n)
+        return false;
+
+    // Sestaveni hlavicky a rozlozeni souboru
+    tBinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TSP_BINARY_MAGIC, sizeof(header.magic));
+    header.byteOrder = 0x01020304;
+    header.version = binaryVersion;
+    header.dimension = info.dimension;
+    header.neighbourCount = (cityNeighbours != NULL) ? cityNeighbours->GetCount() : 0;
+    header.flags = (cityMatrix != NULL) ? TSP_BINARY_MATRIX : 0;
+    if(cityMatrix != NULL && cityMatrix->GetType() == MATRIX_UINT16)
+        header.flags |= TSP_BINARY_UINT16;
+    else if(cityMatrix != NULL && cityMatrix->GetType() == MATRIX_UINT32)
+        header.flags |= TSP_BINARY_UINT32;
+    header.edgeWeightType = info.edgeWeightType;
+    strncpy(header.name, info.name.c_str(), sizeof(header.name) - 1);
+    strncpy(header.comment, info.comment.c_str(), sizeof(header.comment) - 1);
+    header.coordOffset = AlignOffset(sizeof(header), 64);
+    long long endOffset = header.coordOffset + n * 2 * sizeof(double);
+    if(cityMatrix != NULL)
+    {
+        header.matrixOffset = AlignOffset(endOffset, binaryAlignment);
+        endOffset = header.matrixOffset + n * n * cityMatrix->GetElementSize();
+    }
+    if(header.neighbourCount > 0)
+    {
+        header.neighbourOffset = AlignOffset(endOffset, 64);
+        endOffset = header.neighbourOffset + n * header.neighbourCount * sizeof(int);
+    }
+
+    string tempFileName = fileName + ".tmp";
+    FILE *file = fopen(tempFileName.c_str(), "wb");
+    if(file == NULL)
+        return false;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    // Souradnice
+    vector<double> coords(2 * n);
+    for(int i = 0; i < n; i++)
+    {
+        coords[2 * i] = cityPosition[i].x;
+        coords[2 * i + 1] = cityPosition[i].y;
+    }
+    ok = ok && fseek(file, header.coordOffset, SEEK_SET) == 0;
+    ok = ok && fwrite(&coords[0], sizeof(double), 2 * n, file) == (size_t)(2 * n);
+
+    // Matice (po radcich)
+    if(cityMatrix != NULL)
+    {
+        ok = ok && fseek(file, header.matrixOffset, SEEK_SET) == 0;
+        for(int i = 0; ok && i < n; i++)
+            ok = fwrite(cityMatrix->Row(i), cityMatrix->GetElementSize(), n, file) == (size_t)n;
+    }
+
+    // Seznamy sousedu
+    if(header.neighbourCount > 0)
+    {
+        ok = ok && fseek(file, header.neighbourOffset, SEEK_SET) == 0;
+        for(int i = 0; ok && i < n; i++)
+            ok = fwrite(cityNeighbours->Of(i), sizeof(int), header.neighbourCount, file) == (size_t)header.neighbourCount;
+    }
+
+    ok = (fclose(file) == 0) && ok;
+    if(!ok || rename(tempFileName.c_str(), fileName.c_str()) != 0)
+    {
+        remove(tempFileName.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+unsigned int HilbertIndex(unsigned int x, unsigned int y)
+{
+    const unsigned int n = 1 << 16;
+    unsigned int index = 0;
+    for(unsigned int s = n / 2; s > 0; s /= 2)
+    {
+        unsigned int rx = (x & s) ? 1 : 0;
+        unsigned int ry = (y & s) ? 1 : 0;
+        index += s * s * ((3 * rx) ^ ry);
+
+        // Otoceni kvadrantu
+        if(ry == 0)
+        {
+            if(rx == 1)
+            {
+                x = (n - 1 - x) & (n - 1);
+                y = (n - 1 - y) & (n - 1);
+            }
+            swap(x, y);
+        }
+    }
+    return index;
+}
+
+void RenumberCities(tProblemInfo &info, vector<CityPosition> &cityPosition)
+{
+    int dimension = cityPosition.size();
+    if(dimension == 0)
+        return;
+
+    double minX = cityPosition[0].x, maxX = cityPosition[0].x;
+    double minY = cityPosition[0].y, maxY = cityPosition[0].y;
+    for(int i = 1; i < dimension; i++)
+    {
+        minX = min(minX, cityPosition[i].x);
+        maxX = max(maxX, cityPosition[i].x);
+        minY = min(minY, cityPosition[i].y);
+        maxY = max(maxY, cityPosition[i].y);
+    }
+
+    // Souradnice se (se zachovanim pomeru stran) prevedou do mrizky a mesta se seradi podle poradi na krivce
+    double extent = max(maxX - minX, maxY - minY);
+    double scale = (extent > 0) ? 65535.0 / extent : 0;
+    vector<pair<unsigned int, int> > order(dimension);
+    for(int i = 0; i < dimension; i++)
+    {
+        unsigned int x = (unsigned int)((cityPosition[i].x - minX) * scale);
+        unsigned int y = (unsigned int)((cityPosition[i].y - minY) * scale);
+        order[i] = make_pair(HilbertIndex(x, y), i);
+    }
+    sort(order.begin(), order.end());
+
+    vector<CityPosition> sortedPosition(dimension);
+    info.cityId.resize(dimension);
+    for(int i = 0; i < dimension; i++)
+    {
+        sortedPosition[i] = cityPosition[order[i].second];
+        info.cityId[i] = order[i].second;
+    }
+    cityPosition.swap(sortedPosition);
+}
+
+void BuildCityMatrix(const vector<CityPosition> &cityPosition, E_EDGE_WEIGHT type, CityMatrix &cityMatrix, bool integerDistances, MatrixProgress *progress)
+{
+    MatrixBuilder builder;
+    builder.Build(cityPosition, type, cityMatrix, integerDistances, progress);
+}
+
+bool ConvertProblem(string inputFile, string outputFile, int neighbourCount, bool storeMatrix, bool integerDistances)
+{
+    tProblemInfo info;
+    vector<CityPosition> cityPosition;
+    CityMatrix cityMatrix;
+    CityNeighbours cityNeighbours;
+
+    // Matice se pocita jen tehdy, ma-li se ulozit (sousede se najdou i bez ni ze souradnic)
+    if(!LoadProblem(inputFile, info, cityPosition, cityMatrix, cityNeighbours, integerDistances, 0, false, NULL, storeMatrix))
+        return false;
+
+    if(!storeMatrix && info.edgeWeightType == EXPLICIT)
+    {   // zadanou matici nelze ze souradnic obnovit
+        cerr << "Upozorneni: Uloha je zadana matici vzdalenosti, matice se ulozi." << endl;
+        storeMatrix = true;
+    }
+
+    if(neighbourCount > 0)
+    {
+        NeighbourBuilder builder;
+        builder.Build(cityMatrix, cityPosition, info.edgeWeightType, neighbourCount, cityNeighbours);
+    }
+
+    if(!SaveBinaryProblem(outputFile, info, cityPosition, storeMatrix ? &cityMatrix : NULL, (cityNeighbours.GetCount() > 0) ? &cityNeighbours : NULL))
+    {
+        cerr << "Chyba! Binarni soubor " << outputFile << " nelze zapsat." << endl;
+        return false;
+    }
+
+    cout << "Uloha " << info.name << " (" << info.dimension << " mest) prevedena do souboru " << outputFile << "." << endl;
+    return true;
+}
@@ -0,0 +1,223 @@
+/**
+* \file tspLoader.h
+* Nacitani uloh ze souboru (textovy format TSPLIB a binarni format pro okamzity start).
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef TSPLOADER_H_INCLUDED
+#define TSPLOADER_H_INCLUDED
+
+#include <math.h>
+#include <string>
+#include <vector>
+#include "tsp_evolution.h"
+#include "cityMatrix.h"
+#include "tsplibParser.h"
+#include "matrixBuilder.h"
+
+using namespace std;
+
+/// Identifikace binarniho souboru s ulohou.
+#define TSP_BINARY_MAGIC "TSPBIN\0"
+
+/// Hlavicka binarniho souboru s ulohou (nasleduji souradnice, volitelne matice a seznamy sousedu).
+typedef struct
+{
+    char magic[8];              ///< Identifikace formatu (TSP_BINARY_MAGIC).
+    unsigned int byteOrder;     ///< Kontrola poradi bajtu (0x01020304 v nativnim poradi).
+    unsigned int version;       ///< Verze formatu.
+    int dimension;              ///< Pocet mest.
+    int neighbourCount;         ///< Pocet sousedu v seznamech nejblizsich sousedu (0 = seznamy nejsou ulozeny).
+    unsigned int flags;         ///< Priznaky (TSP_BINARY_MATRIX, TSP_BINARY_UINT16, TSP_BINARY_UINT32).
+    unsigned int edgeWeightType;  ///< Zpusob vypoctu vzdalenosti mest (E_EDGE_WEIGHT).
+    long long coordOffset;      ///< Pozice souradnic mest (dvojice double x, y).
+    long long matrixOffset;     ///< Pozice matice vzdalenosti (float, po radcich, zarovnano na stranku).
+    long long neighbourOffset;  ///< Pozice seznamu sousedu (int, dimension * neighbourCount).
+    char name[128];             ///< Pojmenovani problemu.
+    char comment[256];          ///< Komentar k problemu.
+} tBinaryHeader;
+
+/// Priznak binarniho souboru: soubor obsahuje predpocitanou matici vzdalenosti.
+#define TSP_BINARY_MATRIX 1
+
+/// Priznak binarniho souboru: matice je celociselna s 16bitovymi prvky.
+#define TSP_BINARY_UINT16 2
+
+/// Priznak binarniho souboru: matice je celociselna s 32bitovymi prvky.
+#define TSP_BINARY_UINT32 4
+
+/**
+ * Vypocita vzdalenost dvou mest podle pravidel TSPLIB pro dany typ vzdalenosti.
+ * Typ EUC_2D vraci presnou (nezaokrouhlenou) eukleidovskou vzdalenost.
+ * @param type Zpusob vypoctu vzdalenosti.
+ * @param a Prvni mesto.
+ * @param b Druhe mesto.
+ * @return Vzdalenost mest.
+ */
+inline double CityDistance(E_EDGE_WEIGHT type, const CityPosition &a, const CityPosition &b)
+{
+    double dX = a.x - b.x;
+    double dY = a.y - b.y;
+
+    switch(type)
+    {
+        case CEIL_2D:
+            return ceil(sqrt(dX * dX + dY * dY));
+        case ATT:
+        {
+            double r = sqrt((dX * dX + dY * dY) / 10.0);
+            double t = floor(r + 0.5);
+            return (t < r) ? t + 1 : t;
+        }
+        case GEO:
+        {
+            // Souradnice jsou ve formatu DDD.MM (stupne a minuty), konstanty podle TSPLIB
+            const double pi = 3.141592, rrr = 6378.388;
+            double latA = pi * ((int)a.x + 5.0 * (a.x - (int)a.x) / 3.0) / 180.0;
+            double lonA = pi * ((int)a.y + 5.0 * (a.y - (int)a.y) / 3.0) / 180.0;
+            double latB = pi * ((int)b.x + 5.0 * (b.x - (int)b.x) / 3.0) / 180.0;
+            double lonB = pi * ((int)b.y + 5.0 * (b.y - (int)b.y) / 3.0) / 180.0;
+            double q1 = cos(lonA - lonB);
+            double q2 = cos(latA - latB);
+            double q3 = cos(latA + latB);
+            return (int)(rrr * acos(0.5 * ((1.0 + q1) * q2 - (1.0 - q1) * q3)) + 1.0);
+        }
+        case EUC_2D:
+        default:
+            return sqrt(dX * dX + dY * dY);
+    }
+}
+
+/**
+ * Vypocita poradi bodu na Hilbertove krivce v mrizce 65536 x 65536.
+ * @param x Souradnice X v mrizce.
+ * @param y Souradnice Y v mrizce.
+ * @return Poradi bodu na krivce.
+ */
+unsigned int HilbertIndex(unsigned int x, unsigned int y);
+
+/**
+ * Zdroj radku pro vyrovnavaci pamet: vypocet vzdalenosti ze souradnic mest.
+ */
+class CoordinateRowSource : public DistanceRowSource
+{
+    private:
+    vector<CityPosition> cityPosition;   ///< Pozice mest.
+    E_EDGE_WEIGHT type;                  ///< Zpusob vypoctu vzdalenosti.
+    bool integerDistances;               ///< Udava, zda-li se vzdalenosti zaokrouhluji (nint podle TSPLIB).
+
+    public:
+    /**
+    * Konstruktor.
+    * @param cityPosition Pozice mest.
+    * @param type Zpusob vypoctu vzdalenosti.
+    * @param integerDistances Udava, zda-li se vzdalenosti zaokrouhluji.
+    */
+    CoordinateRowSource(const vector<CityPosition> &cityPosition, E_EDGE_WEIGHT type, bool integerDistances)
+        : cityPosition(cityPosition), type(type), integerDistances(integerDistances) {}
+
+    /**
+     * Naplni radek matice.
+     * @param row Index radku (mesta).
+     * @param target Cil pro vzdalenosti ke vsem mestum.
+     */
+    void FillRow(int row, float *target);
+
+    /**
+     * Vrati jednu vzdalenost primo ze zdroje.
+     * @param i Index prvniho mesta.
+     * @param j Index druheho mesta.
+     * @return Vzdalenost mest.
+     */
+    float Distance(int i, int j);
+};
+
+/**
+ * Nacte ulohu ze souboru; format (textovy TSPLIB nebo binarni) se urci podle obsahu souboru.
+ * @param fileName Cesta k souboru s ulohou.
+ * @param info Informace o problemu.
+ * @param cityPosition Pozice mest na mape.
+ * @param cityMatrix Matice vzdalenosti mest.
+ * @param cityNeighbours Seznamy nejblizsich sousedu (naplni se, obsahuje-li je binarni soubor).
+ * @param integerDistances Urcuje, zda-li se maji pouzit celociselne vzdalenosti (nint podle TSPLIB).
+ * @param memoryLimit Maximalni velikost matice v bajtech (0 = neomezeno); vetsi matice se
+ *        nahradi vyrovnavaci pameti radku teto velikosti.
+ * @param hilbertOrder Urcuje, zda-li se maji mesta precislovat podel Hilbertovy krivky
+ *        (jen u matice pocitane ze souradnic).
+ * @param progress Prijemce informaci o prubehu vypoctu matice (muze byt NULL); zrusi-li vypocet
+ *        matice, nacteni selze.
+ * @param buildMatrix Urcuje, zda-li se ma matice dopocitat ze souradnic (jinak zustane prazdna,
+ *        neni-li zadana v souboru).
+ * @return Urcuje, zda-li se ulohu podarilo nacist.
+ */
+bool LoadProblem(string fileName, tProblemInfo &info, vector<CityPosition> &cityPosition, CityMatrix &cityMatrix, CityNeighbours &cityNeighbours, bool integerDistances = false, long long memoryLimit = 0, bool hilbertOrder = false, MatrixProgress *progress = NULL, bool buildMatrix = true);
+
+/**
+ * Nacte ulohu z textoveho souboru ve formatu TSPLIB (soubor se cte proudove, souradnice
+ * jsou realna cisla oddelena libovolnymi bilymi znaky).
+ * @param fileName Cesta k souboru s ulohou.
+ * @param info Informace o problemu.
+ * Vzdalenosti zadane sekci EDGE_WEIGHT_SECTION se ctou primo do matice; nema-li takova
+ * uloha souradnice pro zobrazeni, mesta se rozmisti na kruznici.
+ * @param cityPosition Pozice mest na mape.
+ * @param cityMatrix Matice vzdalenosti (naplni se jen u uloh typu EXPLICIT).
+ * @param integerDistances Urcuje, zda-li se ma zadana matice ulozit celociselne.
+ * @return Urcuje, zda-li se ulohu podarilo nacist.
+ */
+bool LoadTextProblem(string fileName, tProblemInfo &info, vector<CityPosition> &cityPosition, CityMatrix &cityMatrix, bool integerDistances = false);
+
+/**
+ * Nacte ulohu z binarniho souboru; soubor je namapovan do pameti a matice i seznamy sousedu
+ * se pouzivaji primo z namapovane oblasti (vice procesu tak sdili jednu kopii v page cache).
+ * @param fileName Cesta k souboru s ulohou.
+ * @param info Informace o problemu.
+ * @param cityPosition Pozice mest na mape.
+ * @param cityMatrix Matice vzdalenosti (prazdna, neni-li v souboru ulozena nebo nema-li
+ *        pozadovany typ a lze ji dopocitat ze souradnic).
+ * @param cityNeighbours Seznamy nejblizsich sousedu (prazdne, nejsou-li v souboru ulozeny).
+ * @return Urcuje, zda-li se ulohu podarilo nacist.
+ */
+bool LoadBinaryProblem(string fileName, tProblemInfo &info, vector<CityPosition> &cityPosition, CityMatrix &cityMatrix, CityNeighbours &cityNeighbours, bool integerDistances = false);
+
+/**
+ * Ulozi ulohu do binarniho souboru.
+ * @param fileName Cesta k vystupnimu souboru.
+ * @param info Informace o problemu.
+ * @param cityPosition Pozice mest na mape.
+ * @param cityMatrix Matice vzdalenosti (NULL = matice se neuklada).
+ * @param cityNeighbours Seznamy nejblizsich sousedu (NULL = seznamy se neukladaji).
+ * @return Urcuje, zda-li se ulozeni podarilo.
+ */
+bool SaveBinaryProblem(string fileName, const tProblemInfo &info, const vector<CityPosition> &cityPosition, const CityMatrix *cityMatrix, const CityNeighbours *cityNeighbours);
+
+/**
+ * Precisluje mesta v poradi podel Hilbertovy krivky, takze blizka mesta maji blizke indexy
+ * (radky matice pouzivane pri ohodnocovani dobrych cest jsou pak blizko sebe v pameti).
+ * Puvodni cisla mest se ulozi do info.cityId.
+ * @param info Informace o problemu.
+ * @param cityPosition Pozice mest (preusporadaji se).
+ */
+void RenumberCities(tProblemInfo &info, vector<CityPosition> &cityPosition);
+
+/**
+ * Vypocita matici vzdalenosti z pozic mest.
+ * @param cityPosition Pozice mest.
+ * @param type Zpusob vypoctu vzdalenosti.
+ * @param cityMatrix Vypoctena matice vzdalenosti.
+ * @param integerDistances Urcuje, zda-li se ma vypocitat celociselna matice.
+ * @param progress Prijemce informaci o prubehu vypoctu (muze byt NULL).
+ */
+void BuildCityMatrix(const vector<CityPosition> &cityPosition, E_EDGE_WEIGHT type, CityMatrix &cityMatrix, bool integerDistances = false, MatrixProgress *progress = NULL);
+
+/**
+ * Prevede ulohu do binarniho formatu (prikaz --convert).
+ * @param inputFile Vstupni soubor (TSPLIB).
+ * @param outputFile Vystupni binarni soubor.
+ * @param neighbourCount Pocet ukladanych nejblizsich sousedu (0 = neukladaji se).
+ * @param storeMatrix Udava, zda-li se ma ulozit predpocitana matice vzdalenosti.
+ * @param integerDistances Udava, zda-li se ma matice ulozit celociselne.
+ * @return Urcuje, zda-li se prevod podaril.
+ */
+bool ConvertProblem(string inputFile, string outputFile, int neighbourCount, bool storeMatrix, bool integerDistances = false);
+
+#endif // TSPLOADER_H_INCLUDED
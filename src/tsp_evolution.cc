@@ -1,16 +1,46 @@
 #include "tsp_evolution.h"
+#include "populationSeeder.h"
+#include "localSearch.h"
+#include "neighbourBuilder.h"
+
+/// Maximalni pocet bodu historie cen (sude cislo).
+static const int maxHistorySize = 4096;
+
+/// Pocet generaci mezi upravami parametru pri samoadaptaci.
+static const int adaptationPeriod = 10;
+
+/// Koeficient zmeny parametru pri samoadaptaci (pravidlo 1/5).
+static const double adaptationFactor = 0.85;
+
+/// Dolni mez pravdepodobnosti mutace pri samoadaptaci.
+static const double minMutationRate = 0.01;
+
+/// Pocet pokusu o doplneni populace ruznymi cestami (na jednoho jedince populace).
+static const int surviveAttempts = 10;
+
+/// Dolni mez doby behu operatoru pro adaptivni vyber [us] (chrani pred delenim temer nulou).
+static const double minOperatorTime = 0.01;
+
+/// Nazvy operatoru krizeni (podle E_CROSSOVER).
+static const char *crossoverNames[] = {"PMX", "ERX", "OX", "CX"};
+
+/// Nazvy operatoru mutace (podle E_MUTATION).
+static const char *mutationNames[] = {"SWAP", "2-OPT", "3-OPT", "INVERSION"};
 
 TSPEvolution::TSPEvolution(QObject *) : QThread()
 {
-    // Nastaveni priznaku ukonceni a uspani
-    abortFlag = false;
-    sleepFlag = false;
+    memset(&metrics, 0, sizeof(metrics));
 }
 
-void TSPEvolution::FindSolution(vector<CityMatrixRow> &cityMatrix, tProblemInfo info)
+void TSPEvolution::FindSolution(CityMatrix &cityMatrix, const vector<CityPosition> &cityPosition, const CityNeighbours &cityNeighbours, tProblemInfo info)
 {
+    // Predchozi vypocet musi dobehnout, nez se jeho data prepisou
+    wait();
+
     // Zpracovani predanych parametru
     this->cityMatrix = cityMatrix;
+    this->cityPosition = cityPosition;
+    this->cityNeighbours = cityNeighbours;
     this->info = info;
 
     // Priprava pouzivanych vektoru ve vypoctu
@@ -18,171 +48,267 @@ void TSPEvolution::FindSolution(vector<CityMatrixRow> &cityMatrix, tProblemInfo
     childPop.clear();
     tempPop.clear();
     actGeneration  = 0;
-
-    result.minPathPrice = result.minInitialPathPrice = result.minCurrentPathPrice = FLT_MAX;
+    resultPath.genome.clear();
+    resultPath.price = 0;
+    bestPathChannel.Reset();
+    tempMinPathPrice.clear();
+    tempAvgPathPrice.clear();
+    tempMaxPathPrice.clear();
+    historyStride = 1;
+    historyCount = 0;
+    rng.Seed(((unsigned long long)rand() << 31) ^ rand() ^ (unsigned long long)time(NULL));
+    profiler.Reset(Config::GetInstance()->profiling || Config::GetInstance()->perfCounters);
+
+    result.minPathPrice = result.minInitialPathPrice = result.minCurrentPathPrice = DBL_MAX;
+    result.termination = TERMINATION_NONE;
+    result.restartCount = 0;
+    result.duplicateCount = 0;
+    result.localSearchCount = result.localSearchMoves = 0;
+    result.localSearchGain = result.polishTime = result.polishGain = 0;
+    eliteArchive.clear();
+    convergedGenerations = 0;
+    convergedBestPrice = DBL_MAX;
     result.crossoverCount = result.mutationCount = result.genomeEvaluationCount =
          result.avgPathPrice = result.avgInitialPathPrice = result.avgCurrentPathPrice =
          result.maxPathPrice = result.maxInitialPathPrice = result.maxCurrentPathPrice = 0;
 
+    // Adaptivni vyber operatoru
+    Config *config = Config::GetInstance();
+    adaptiveOperators = (config->tCrossover == ADAPTIVE_CROSSOVER || config->tMutation == ADAPTIVE_MUTATION);
+    crossoverBandit.Reset(ADAPTIVE_CROSSOVER, config->adaptiveWindow, config->adaptiveExploration);
+    mutationBandit.Reset(ADAPTIVE_MUTATION, config->adaptiveWindow, config->adaptiveExploration);
+    childOperators.clear();
+
+    // Hashovani cest pro vyrovnavaci pamet cen a zakaz duplicit; hash nerozlisuje smer cesty,
+    // u nesymetricke matice by tedy opacne cesty s ruznou cenou splyvaly
+    int fitnessCacheSize = info.symmetric ? config->fitnessCacheSize : 0;
+    noDuplicates = (config->noDuplicates && info.symmetric);
+    if(!info.symmetric && (config->fitnessCacheSize > 0 || config->noDuplicates))
+        cout << "Upozorneni: Matice vzdalenosti neni symetricka, FITNESS_CACHE a NO_DUPLICATES se nepouziji." << endl;
+    tourHashing = (fitnessCacheSize > 0 || noDuplicates);
+    if(tourHashing || config->restartGenerations > 0)
+        tourHash.Init(info.dimension);
+    fitnessCache.Reset(fitnessCacheSize);
+
+    // Zisky tahu lokalniho prohledavani predpokladaji symetrickou vzdalenost (obraceny usek ma stejnou delku)
+    useLocalSearch = (config->localSearch > 0 && info.symmetric);
+    if(!info.symmetric && config->localSearch > 0)
+        cout << "Upozorneni: Matice vzdalenosti neni symetricka, LOCAL_SEARCH se nepouzije." << endl;
+    if(!info.symmetric && config->polishTime > 0)
+        cout << "Upozorneni: Matice vzdalenosti neni symetricka, POLISH_TIME se nepouzije." << endl;
+
+    // Vychozi hodnoty samoadaptivnich parametru
+    mutationRate = config->pMutation;
+    tournamentLevel = config->sTournament;
+    tournamentSize = config->sTournament;
+    adaptationChildren = adaptationSuccesses = 0;
+    checkpointFingerprint = -1;
+
     // Nastaveni priznaku ukonceni a uspani
-    this->abortFlag = false;
-    this->sleepFlag = false;
+    cancelToken.Reset();
+    sleepFlag.fetchAndStoreRelease(0);
 
     // Spusteni evoluce
-    if(!isRunning())
-        start();
+    start();
 }
 
 void TSPEvolution::run()
 {
-    GenerateInitPopulation();      // vytvori pocatecni populaci jedincu
+    // Casovy limit zahrnuje i tvorbu pocatecni populace (obnova z kontrolniho bodu cas posune)
+    startTime = PhaseProfiler::Now();
+
+    // Inicializace prubeznych metrik
+    metricsStartTime = metricsLastTime = PhaseProfiler::Now();
+
+    // Hardwarove citace se oteviraji pro vlakno vypoctu (pri jejich nedostupnosti se meri jen cas)
+    if(Config::GetInstance()->perfCounters)
+        profiler.OpenCounters();
+
+    // Obnova z kontrolniho bodu, jinak vytvoreni pocatecni populace jedincu
+    bool resumed = false;
+    if(Config::GetInstance()->resume && !Config::GetInstance()->checkpointFile.empty())
+        resumed = RestoreCheckpoint();
+    if(!Config::GetInstance()->statisticsFile.empty())
+        statisticsLog.Open(Config::GetInstance()->statisticsFile, resumed);
+    if(!resumed)
+        GenerateInitPopulation();
+
+    // Vychozi stav pro sledovani stagnace
+    bestSeenPrice = result.minPathPrice;
+    for(int i = 0; i < (int)parentPop.size(); i++)
+        bestSeenPrice = min(bestSeenPrice, parentPop[i].price);
+    lastImprovementGeneration = actGeneration;
+    metricsLastGeneration = actGeneration;
+    metricsLastEvaluationCount = result.genomeEvaluationCount;
 
-    while(!Done())
+    while(!cancelToken.IsCancelled() && !Done())
     {
         Step();
+        PublishMetrics(true, false);
 
-        if(actGeneration % Config::GetInstance()->logInterval == 0)
-        {   // prubezne vypisovani aktualni generace vypoctu
+        bool logGeneration = (actGeneration % Config::GetInstance()->logInterval == 0);
+        bool statisticsGeneration = statisticsLog.IsOpen() && (actGeneration % Config::GetInstance()->statisticsInterval == 0);
+        bool restartGeneration = (Config::GetInstance()->restartGenerations > 0);
+        if(logGeneration || statisticsGeneration || restartGeneration)
             SetGenerationStatistics();
+        if(statisticsGeneration)
+            LogStatistics(result.minCurrentPathPrice, result.avgCurrentPathPrice, result.maxCurrentPathPrice);
+
+        if(logGeneration)
+        {   // prubezne vypisovani aktualni generace vypoctu
+            AppendHistory(result.minCurrentPathPrice, result.avgCurrentPathPrice, result.maxCurrentPathPrice);
+            if(profiler.HasCounters())
+                cout << actGeneration << ": " << profiler.GenerationCounterReport() << "\n";
             cout.flush();
 
-            mutex.lock();
-            if(!abortFlag)
-                emit CurrentPathGenerated(resultPath, actGeneration, result.minCurrentPathPrice, result.avgCurrentPathPrice, result.maxCurrentPathPrice);
-            mutex.unlock();
+            if(!cancelToken.IsCancelled())
+                emit CurrentPathGenerated(actGeneration, result.minCurrentPathPrice, result.avgCurrentPathPrice, result.maxCurrentPathPrice);
         }
 
-        // Uspani pri nastaveni priznaku uspani
-        mutex.lock();
-        if(sleepFlag)
+        // Restart populace po jeji konvergenci (az po zaznamu statistik, ty popisuji zkonvergovanou populaci)
+        if(restartGeneration)
+            CheckRestart();
+
+        // Prubezne ukladani kontrolniho bodu
+        if(!Config::GetInstance()->checkpointFile.empty() && Config::GetInstance()->checkpointInterval > 0 &&
+           actGeneration % Config::GetInstance()->checkpointInterval == 0)
+            SaveCheckpoint();
+
+        // Uspani pri nastaveni priznaku uspani (zamek se pouziva jen ve stavu pozastaveni)
+        if((int)sleepFlag != 0)
         {
-            condition.wait(&mutex);
-            sleepFlag = false;
+            mutex.lock();
+            while((int)sleepFlag != 0 && !cancelToken.IsCancelled())
+                condition.wait(&mutex);
+            mutex.unlock();
         }
-        mutex.unlock();
+    }
 
-        // Ukonceni pri nastaveni priznaku ukonceni
-        mutex.lock();
-        if(abortFlag)
+    // Ukonceni pri nastaveni priznaku ukonceni
+    if(cancelToken.IsCancelled())
+    {
+        StoreRunningTime();
+        result.termination = TERMINATION_ABORT;
+        if(profiler.IsEnabled())
+            cout << profiler.Report() << flush;
+        profiler.CloseCounters();
+        PublishMetrics(false, true);
+        statisticsLog.Close();
+
+        // Pri preruseni se ulozi kontrolni bod, aby bylo mozne ve vypoctu pokracovat
+        // (ne vsak pri preruseni tvorby pocatecni populace)
+        if(!Config::GetInstance()->checkpointFile.empty() && !parentPop.empty())
         {
-            // Vypocet a ulozeni doby behu
-            struct timeval endTime;
-            gettimeofday(&endTime, NULL);
-            result.runningTime.tv_sec = endTime.tv_sec - startTime.tv_sec;
-            if((endTime.tv_usec - startTime.tv_usec) < 0)
-            {
-                result.runningTime.tv_sec--;
-                result.runningTime.tv_usec = (startTime.tv_usec - endTime.tv_usec) + 1;
-            }
-            else
-            {
-                result.runningTime.tv_usec = endTime.tv_usec - startTime.tv_usec;
-            }
-            mutex.unlock();
-            return;
+            SaveCheckpoint();
+            checkpointWriter.Flush();
         }
-        mutex.unlock();
+
+        // Oznameni dokonceni preruseni
+        emit EvolutionAborted(resultPath);
+        return;
     }
 
+    // Zaverecne doladeni nejlepsi cesty (tahy LK predpokladaji symetrickou vzdalenost)
+    if(Config::GetInstance()->polishTime > 0 && info.symmetric)
+        PolishResult();
+
+    // Vypis doby behu jednotlivych fazi na standardni vystup
+    if(profiler.IsEnabled())
+        cout << profiler.Report() << flush;
+    profiler.CloseCounters();
+    PublishMetrics(false, true);
+    statisticsLog.Close();
+    checkpointWriter.Flush();
+
     // Vygenerovani signalu; zasilame nejlepsi nalezenou cestu pro problem obchodniho cestujiciho
     emit PathGenerated(resultPath);
 }
 
 void TSPEvolution::StopEvolution()
 {
-    if(sleepFlag)
-    {   // Obnoveni prehravani
+    if((int)sleepFlag != 0)
+    {   // Obnoveni prehravani (pod zamkem, aby se probuzeni nemohlo minout s usinanim)
         mutex.lock();
-        sleepFlag = false;
+        sleepFlag.fetchAndStoreRelease(0);
         condition.wakeOne();
         mutex.unlock();
     }
     else
-    {   // Pozastaveni prehravani
-        mutex.lock();
-        sleepFlag = true;
-        mutex.unlock();
+    {   // Pozastaveni prehravani (vlakno vypoctu usne na konci generace)
+        sleepFlag.fetchAndStoreRelease(1);
     }
 }
 
 void TSPEvolution::AbortEvolution()
 {
+    cancelToken.Cancel();  // Nastaveni priznaku pro ukonceni
+
     mutex.lock();
-    abortFlag = true;      // Nastaveni priznaku pro ukonceni
     condition.wakeOne();   // Probuzeni spiciho vlakna
     mutex.unlock();
-
-    wait();                // Pockani na dobehnuti vlakna
 }
 
 TSPEvolution::~TSPEvolution()
 {
-    mutex.lock();
-    abortFlag = true;      // Nastaveni priznaku pro ukonceni
-    condition.wakeOne();   // Probuzeni spiciho vlakna
-    mutex.unlock();
-
+    AbortEvolution();
     wait();                // Pockani na dobehnuti vlakna
 }
 
 void TSPEvolution::GenerateInitPopulation()
 {
-    vector<int> cityPattern, cityPermutation;
-    for(int i = 0; i < info.dimension; i++)
-        cityPattern.push_back(i);
-
-    // Alokace prostoru pro rodice i potomky (sdileji stejne pole)
-    int randIndex;
-    tIndividual actCity;
-    for(int i = 0; i < Config::GetInstance()->sPopulation; i++)
-    {
-        actCity.price = 0;
-        actCity.genome.clear();
-        cityPermutation = cityPattern;
-        if(i < Config::GetInstance()->sPopulation)
-        {   // generovani genomu probiha pouze pro rodice
-            for(int j = 0; j < info.dimension; j++)
-            {
-                randIndex = rand() % cityPermutation.size();
-                actCity.genome.push_back(cityPermutation[randIndex]);
-                cityPermutation.erase(cityPermutation.begin() + randIndex);
-            }
-        }
-        parentPop.push_back(actCity);
+    // Vytvoreni genomu (nahodne cesty a cesty z konstrukcnich heuristik v zadanych podilech)
+    Config *config = Config::GetInstance();
+    double weights[SEEDING_COUNT];
+    weights[SEEDING_RANDOM] = config->initRandom;
+    weights[SEEDING_NEAREST] = config->initNearest;
+    weights[SEEDING_GREEDY] = config->initGreedy;
+    weights[SEEDING_CURVE] = config->initCurve;
+    PopulationSeeder seeder;
+    seeder.Generate(cityMatrix, cityPosition, info.edgeWeightType, cityNeighbours, weights, config->sPopulation,
+                   ((unsigned long long)rng.Next() << 32) | rng.Next(), cancelToken, parentPop);
+    if(cancelToken.IsCancelled())
+    {   // neuplna populace se zahodi
+        parentPop.clear();
+        return;
     }
 
     // Ohodnoceni pocatecni populace jedincu
     EvaluatePopulation(parentPop);
 
     // Ulozeni statistik pocatecni populace jedincu
-    result.minInitialPathPrice = FLT_MAX;
+    result.minInitialPathPrice = DBL_MAX;
     result.maxInitialPathPrice = 0;
     result.avgInitialPathPrice = 0;
+    int bestIndex = 0;
     for(int i = 0; i < (int)parentPop.size(); i++)
     {
         if(parentPop[i].price > result.maxInitialPathPrice)
             result.maxInitialPathPrice = parentPop[i].price;
         if(parentPop[i].price < result.minInitialPathPrice)
+        {
             result.minInitialPathPrice = parentPop[i].price;
+            bestIndex = i;
+        }
         result.avgInitialPathPrice += parentPop[i].price;
     }
+    if(!parentPop.empty())
+        PublishPath(parentPop[bestIndex]);
     result.avgInitialPathPrice = result.avgInitialPathPrice / parentPop.size();
-    tempMinPathPrice.push_back(result.minInitialPathPrice);
-    tempAvgPathPrice.push_back(result.avgInitialPathPrice);
-    tempMaxPathPrice.push_back(result.maxInitialPathPrice);
+    AppendHistory(result.minInitialPathPrice, result.avgInitialPathPrice, result.maxInitialPathPrice);
+    if(statisticsLog.IsOpen())
+        LogStatistics(result.minInitialPathPrice, result.avgInitialPathPrice, result.maxInitialPathPrice);
 
-    mutex.lock();
-    if(!abortFlag)
-        emit CurrentPathGenerated(resultPath, 0, result.minInitialPathPrice, result.avgInitialPathPrice, result.maxInitialPathPrice);
-    mutex.unlock();
+    if(!cancelToken.IsCancelled())
+        emit CurrentPathGenerated(0, result.minInitialPathPrice, result.avgInitialPathPrice, result.maxInitialPathPrice);
 }
 
 void TSPEvolution::SetGenerationStatistics()
 {
-    result.minCurrentPathPrice = INT_MAX;
+    result.minCurrentPathPrice = DBL_MAX;
     result.maxCurrentPathPrice = 0;
     result.avgCurrentPathPrice = 0;
 
+    int bestIndex = -1;
     for(int i = 0; i < (int)parentPop.size(); i++)
     {
         if(parentPop[i].price > result.maxCurrentPathPrice)
@@ -194,14 +320,67 @@ void TSPEvolution::SetGenerationStatistics()
         if(parentPop[i].price < result.minPathPrice)
         {
             result.minPathPrice = parentPop[i].price;
-            resultPath = parentPop[i];
+            bestIndex = i;
         }
         result.avgCurrentPathPrice += parentPop[i].price;
     }
     result.avgCurrentPathPrice = result.avgCurrentPathPrice / parentPop.size();
-    tempAvgPathPrice.push_back(result.avgCurrentPathPrice);
-    tempMinPathPrice.push_back(result.minCurrentPathPrice);
-    tempMaxPathPrice.push_back(result.maxCurrentPathPrice);
+
+    // Zlepsene reseni se zverejni pro zobrazeni
+    if(bestIndex >= 0)
+    {
+        resultPath = parentPop[bestIndex];
+        PublishPath(resultPath);
+    }
+}
+
+void TSPEvolution::PublishPath(const tIndividual &path)
+{
+    tIndividual &snapshot = bestPathChannel.Back();
+    snapshot.genome.assign(path.genome.begin(), path.genome.end());
+    snapshot.price = path.price;
+    bestPathChannel.Publish();
+}
+
+void TSPEvolution::AppendHistory(double minPrice, double avgPrice, double maxPrice)
+{
+    // Prumerna cena od inicializace se pocita ze vsech intervalu, i tech vynechanych z historie
+    historyCount++;
+    result.avgPathPrice += (avgPrice - result.avgPathPrice) / historyCount;
+
+    if((historyCount - 1) % historyStride != 0)
+        return;
+    tempMinPathPrice.push_back(minPrice);
+    tempAvgPathPrice.push_back(avgPrice);
+    tempMaxPathPrice.push_back(maxPrice);
+
+    // Zaplnena historie se prorece na polovinu (zustanou body na nasobcich dvojnasobneho intervalu)
+    if((int)tempMinPathPrice.size() >= maxHistorySize)
+    {
+        for(int i = 0; i < maxHistorySize / 2; i++)
+        {
+            tempMinPathPrice[i] = tempMinPathPrice[2 * i];
+            tempAvgPathPrice[i] = tempAvgPathPrice[2 * i];
+            tempMaxPathPrice[i] = tempMaxPathPrice[2 * i];
+        }
+        tempMinPathPrice.resize(maxHistorySize / 2);
+        tempAvgPathPrice.resize(maxHistorySize / 2);
+        tempMaxPathPrice.resize(maxHistorySize / 2);
+        historyStride *= 2;
+    }
+}
+
+void TSPEvolution::LogStatistics(double minPrice, double avgPrice, double maxPrice)
+{
+    tGenerationRecord record;
+    record.generation = actGeneration;
+    record.minPrice = minPrice;
+    record.avgPrice = avgPrice;
+    record.maxPrice = maxPrice;
+    record.bestPrice = (result.minPathPrice < minPrice) ? result.minPathPrice : minPrice;
+    record.evaluationCount = result.genomeEvaluationCount;
+    record.elapsedTime = ElapsedTime();
+    statisticsLog.Push(record);
 }
 
 void TSPEvolution::EvaluatePopulation(vector<tIndividual> &population)
@@ -212,156 +391,943 @@ void TSPEvolution::EvaluatePopulation(vector<tIndividual> &population)
     }
 }
 
-void TSPEvolution::EvaluateGenome(tIndividual &individual)
+/**
+ * Secte delku okruzni cesty.
+ * Celociselne vzdalenosti se scitaji presne do 64bitoveho celeho cisla, realne do double.
+ * @param matrix Prvky matice vzdalenosti.
+ * @param dimension Pocet mest.
+ * @param genome Permutace mest.
+ * @return Delka cesty.
+ */
+template <class T, class S> static S TourLength(const T *matrix, int dimension, const vector<int> &genome)
 {
-    individual.price = 0;
-    for(int i = 0; i < info.dimension; i++)
+    S length = 0;
+    for(int i = 0; i < dimension - 1; i++)
     {   // ohodnoti se prechod mezi kazdymi dvema mesty
-        individual.price += cityMatrix[individual.genome[i]][individual.genome[(i + 1) % info.dimension]];
+        length += matrix[(size_t)genome[i] * dimension + genome[i + 1]];
+    }
+    length += matrix[(size_t)genome[dimension - 1] * dimension + genome[0]];
+
+    return length;
+}
+
+void TSPEvolution::EvaluateGenome(tIndividual &individual)
+{
+    if(fitnessCache.IsEnabled() && fitnessCache.Lookup(TourHashOf(individual), individual.price))
+        return;
+
+    switch(cityMatrix.GetType())
+    {
+        case MATRIX_UINT16:
+            individual.price = TourLength<unsigned short, long long>(cityMatrix.Elements<unsigned short>(), info.dimension, individual.genome);
+            break;
+        case MATRIX_UINT32:
+            individual.price = TourLength<unsigned int, long long>(cityMatrix.Elements<unsigned int>(), info.dimension, individual.genome);
+            break;
+        case MATRIX_CACHED:
+            individual.price = 0;
+            for(int i = 0; i < info.dimension; i++)
+                individual.price += cityMatrix.Distance(individual.genome[i], individual.genome[(i + 1) % info.dimension]);
+            break;
+        default:
+            individual.price = TourLength<float, double>(cityMatrix.Elements<float>(), info.dimension, individual.genome);
+            break;
     }
 
     result.genomeEvaluationCount++;
+    if(fitnessCache.IsEnabled())
+        fitnessCache.Store(individual.hash, individual.price);
+}
+
+unsigned long long TSPEvolution::TourHashOf(tIndividual &individual)
+{
+    if(individual.hash == 0)
+        individual.hash = tourHash.Compute(individual.genome);
+    return individual.hash;
+}
+
+void TSPEvolution::RemoveDuplicates(vector<tIndividual> &population)
+{
+    // Stejne cesty maji stejnou cenu, porovnavaji se tedy jen s ponechanymi jedinci se stejnou cenou
+    // (hash se pocita jen pri shode cen)
+    int kept = 0;
+    for(int i = 0; i < (int)population.size(); i++)
+    {
+        bool duplicate = false;
+        for(int j = kept - 1; j >= 0 && population[j].price == population[i].price && !duplicate; j--)
+            duplicate = (TourHashOf(population[j]) == TourHashOf(population[i]));
+
+        if(duplicate)
+        {
+            result.duplicateCount++;
+            continue;
+        }
+        if(kept != i)
+            population[kept] = population[i];
+        kept++;
+    }
+    population.resize(kept);
+}
+
+bool TSPEvolution::ContainsTour(vector<tIndividual> &population, tIndividual &individual)
+{
+    for(int i = 0; i < (int)population.size(); i++)
+    {
+        if(population[i].price == individual.price && TourHashOf(population[i]) == TourHashOf(individual))
+            return true;
+    }
+    return false;
+}
+
+void TSPEvolution::PublishMetrics(bool running, bool force)
+{
+    long long now = PhaseProfiler::Now();
+    if(!force && (now - metricsLastTime) < 250000000LL)
+        return;
+
+    // Statistiky aktualni populace (nezavisle na intervalu logovani)
+    double minPrice = DBL_MAX, maxPrice = 0, avgPrice = 0;
+    for(int i = 0; i < (int)parentPop.size(); i++)
+    {
+        if(parentPop[i].price < minPrice)
+            minPrice = parentPop[i].price;
+        if(parentPop[i].price > maxPrice)
+            maxPrice = parentPop[i].price;
+        avgPrice += parentPop[i].price;
+    }
+    if(!parentPop.empty())
+        avgPrice /= parentPop.size();
+    else
+        minPrice = 0;
+
+    double interval = (now - metricsLastTime) / 1e9;
+
+    metricsMutex.lock();
+    metrics.running = running;
+    metrics.generation = actGeneration;
+    metrics.nGenerations = Config::GetInstance()->nGenerations;
+    metrics.minPrice = minPrice;
+    metrics.avgPrice = avgPrice;
+    metrics.maxPrice = maxPrice;
+    metrics.bestPrice = (result.minPathPrice < minPrice) ? result.minPathPrice : minPrice;
+    metrics.evaluationCount = result.genomeEvaluationCount;
+    metrics.crossoverCount = result.crossoverCount;
+    metrics.mutationCount = result.mutationCount;
+    if(interval > 0)
+    {
+        metrics.evaluationsPerSecond = (result.genomeEvaluationCount - metricsLastEvaluationCount) / interval;
+        metrics.generationsPerSecond = (actGeneration - metricsLastGeneration) / interval;
+    }
+    metrics.elapsedSeconds = (now - metricsStartTime) / 1e9;
+    for(int i = 0; i < PHASE_COUNT; i++)
+        metrics.phaseTime[i] = profiler.GetTotal((E_PHASE)i);
+    DistanceRowCache *cache = cityMatrix.GetCache();
+    metrics.mutationRate = mutationRate;
+    metrics.tournamentSize = tournamentSize;
+    metrics.fitnessCache = fitnessCache.IsEnabled();
+    metrics.fitnessCacheHits = fitnessCache.GetHits();
+    metrics.fitnessCacheMisses = fitnessCache.GetMisses();
+    metrics.localSearchMoves = result.localSearchMoves;
+    metrics.distanceCache = (cache != NULL);
+    metrics.distanceCacheHits = (cache != NULL) ? cache->GetHits() : 0;
+    metrics.distanceCacheMisses = (cache != NULL) ? cache->GetMisses() : 0;
+    metricsMutex.unlock();
+
+    metricsLastTime = now;
+    metricsLastGeneration = actGeneration;
+    metricsLastEvaluationCount = result.genomeEvaluationCount;
+}
+
+tMetrics TSPEvolution::GetMetrics()
+{
+    metricsMutex.lock();
+    tMetrics actMetrics = metrics;
+    metricsMutex.unlock();
+
+    return actMetrics;
+}
+
+void TSPEvolution::StoreRunningTime()
+{
+    long long elapsed = (PhaseProfiler::Now() - startTime) / 1000;
+    result.runningTime.tv_sec = elapsed / 1000000;
+    result.runningTime.tv_usec = elapsed % 1000000;
+}
+
+double TSPEvolution::ElapsedTime()
+{
+    return (PhaseProfiler::Now() - startTime) / 1e9;
+}
+
+double TSPEvolution::DistanceFingerprint()
+{
+    // Mesta v poradi souboru (nezavisle na jejich precislovani)
+    vector<int> order(info.dimension);
+    for(int i = 0; i < info.dimension; i++)
+        order[info.cityId.empty() ? i : info.cityId[i]] = i;
+
+    double fingerprint = 0;
+    for(int i = 0; i < info.dimension; i++)
+        fingerprint += cityMatrix.Distance(order[i], order[(i + 1) % info.dimension]);
+    return fingerprint;
+}
+
+void TSPEvolution::SaveCheckpoint()
+{
+    tCheckpoint &state = checkpointState;
+    int dimension = info.dimension;
+
+    if(checkpointFingerprint < 0)
+        checkpointFingerprint = DistanceFingerprint();
+    state.name = info.name;
+    state.edgeWeightType = info.edgeWeightType;
+    state.integerDistances = Config::GetInstance()->integerDistances ? 1 : 0;
+    state.fingerprint = checkpointFingerprint;
+    state.dimension = dimension;
+    state.sPopulation = parentPop.size();
+    state.actGeneration = actGeneration;
+    state.rngState = rng.GetState();
+    state.crossoverCount = result.crossoverCount;
+    state.mutationCount = result.mutationCount;
+    state.genomeEvaluationCount = result.genomeEvaluationCount;
+    state.elapsedTime = ElapsedTime();
+    state.prices[0] = result.minPathPrice;
+    state.prices[1] = result.maxPathPrice;
+    state.prices[2] = result.avgPathPrice;
+    state.prices[3] = result.minInitialPathPrice;
+    state.prices[4] = result.maxInitialPathPrice;
+    state.prices[5] = result.avgInitialPathPrice;
+    state.prices[6] = result.minCurrentPathPrice;
+    state.prices[7] = result.maxCurrentPathPrice;
+    state.prices[8] = result.avgCurrentPathPrice;
+
+    // Populace se uklada jako souvisle pole puvodnich cisel mest (nezavisle na jejich precislovani)
+    state.genomes.resize((size_t)state.sPopulation * dimension);
+    state.genomePrices.resize(state.sPopulation);
+    for(int i = 0; i < state.sPopulation; i++)
+    {
+        for(int j = 0; j < dimension; j++)
+            state.genomes[(size_t)i * dimension + j] = OriginalCityId(info, parentPop[i].genome[j]);
+        state.genomePrices[i] = parentPop[i].price;
+    }
+    state.resultGenome.resize(resultPath.genome.size());
+    for(int i = 0; i < (int)resultPath.genome.size(); i++)
+        state.resultGenome[i] = OriginalCityId(info, resultPath.genome[i]);
+    state.resultPrice = resultPath.price;
+    state.historyMin = tempMinPathPrice;
+    state.historyAvg = tempAvgPathPrice;
+    state.historyMax = tempMaxPathPrice;
+    state.historyStride = historyStride;
+    state.historyCount = historyCount;
+    state.restartCount = result.restartCount;
+    state.mutationRate = mutationRate;
+    state.tournamentLevel = tournamentLevel;
+    state.convergedGenerations = convergedGenerations;
+    state.archiveGenomes.resize(eliteArchive.size() * dimension);
+    state.archivePrices.resize(eliteArchive.size());
+    for(int i = 0; i < (int)eliteArchive.size(); i++)
+    {
+        for(int j = 0; j < dimension; j++)
+            state.archiveGenomes[(size_t)i * dimension + j] = OriginalCityId(info, eliteArchive[i].genome[j]);
+        state.archivePrices[i] = eliteArchive[i].price;
+    }
+
+    checkpointWriter.Submit(Config::GetInstance()->checkpointFile, state);
+}
+
+/**
+ * Overi, ze genom je permutaci mest (kazde mesto v rozsahu a prave jednou).
+ * @param genome Zacatek genomu.
+ * @param dimension Pocet mest.
+ * @param seen Pomocny vektor priznaku (velikost alespon dimension).
+ * @return True, je-li genom platnou cestou.
+ */
+static bool IsPermutation(const int *genome, int dimension, vector<char> &seen)
+{
+    fill(seen.begin(), seen.begin() + dimension, 0);
+    for(int i = 0; i < dimension; i++)
+    {
+        if(genome[i] < 0 || genome[i] >= dimension || seen[genome[i]])
+            return false;
+        seen[genome[i]] = 1;
+    }
+    return true;
+}
+
+bool TSPEvolution::RestoreCheckpoint()
+{
+    tCheckpoint state;
+    string fileName = Config::GetInstance()->checkpointFile;
+
+    if(!CheckpointWriter::Load(fileName, state, maxHistorySize, Config::GetInstance()->archiveSize))
+    {
+        cerr << "Upozorneni: Kontrolni bod " << fileName << " nelze nacist, vypocet zacina od pocatku." << endl;
+        return false;
+    }
+
+    // Ulozene ceny plati jen pro tutez ulohu se stejne pocitanymi vzdalenostmi
+    bool sameProblem = state.dimension == info.dimension && state.name == info.name && state.edgeWeightType == (int)info.edgeWeightType &&
+                       state.integerDistances == (Config::GetInstance()->integerDistances ? 1 : 0);
+    if(sameProblem)
+    {
+        checkpointFingerprint = DistanceFingerprint();
+        sameProblem = fabs(state.fingerprint - checkpointFingerprint) <= 1e-6 * max(1.0, fabs(checkpointFingerprint));
+    }
+    if(!sameProblem)
+    {
+        cerr << "Upozorneni: Kontrolni bod " << fileName << " neodpovida resenemu problemu, vypocet zacina od pocatku." << endl;
+        return false;
+    }
+    if(state.sPopulation != Config::GetInstance()->sPopulation)
+    {
+        cerr << "Upozorneni: Kontrolni bod " << fileName << " ma jinou velikost populace (" << state.sPopulation << ") nez S_POPULATION, vypocet zacina od pocatku." << endl;
+        return false;
+    }
+
+    // Vsechny ulozene cesty musi byt permutacemi mest (operatory krizeni s jinymi nepocitaji)
+    bool valid = state.resultGenome.empty() || (int)state.resultGenome.size() == state.dimension;
+    vector<char> seen(state.dimension);
+    for(int i = 0; valid && i < state.sPopulation; i++)
+        valid = IsPermutation(&state.genomes[(size_t)i * state.dimension], state.dimension, seen);
+    if(valid && !state.resultGenome.empty())
+        valid = IsPermutation(&state.resultGenome[0], state.dimension, seen);
+    for(int i = 0; valid && i < (int)state.archivePrices.size(); i++)
+        valid = IsPermutation(&state.archiveGenomes[(size_t)i * state.dimension], state.dimension, seen);
+    if(!valid)
+    {
+        cerr << "Upozorneni: Kontrolni bod " << fileName << " je poskozen, vypocet zacina od pocatku." << endl;
+        return false;
+    }
+
+    // Prevod puvodnich cisel mest na indexy (mesta mohou byt precislovana)
+    if(!info.cityId.empty())
+    {
+        vector<int> cityIndex(info.dimension);
+        for(int i = 0; i < info.dimension; i++)
+            cityIndex[info.cityId[i]] = i;
+        for(int i = 0; i < (int)state.genomes.size(); i++)
+            state.genomes[i] = cityIndex[state.genomes[i]];
+        for(int i = 0; i < (int)state.resultGenome.size(); i++)
+            state.resultGenome[i] = cityIndex[state.resultGenome[i]];
+        for(int i = 0; i < (int)state.archiveGenomes.size(); i++)
+            state.archiveGenomes[i] = cityIndex[state.archiveGenomes[i]];
+    }
+
+    // Obnova populace rodicu
+    parentPop.resize(state.sPopulation);
+    for(int i = 0; i < state.sPopulation; i++)
+    {
+        parentPop[i].genome.assign(state.genomes.begin() + (size_t)i * state.dimension, state.genomes.begin() + (size_t)(i + 1) * state.dimension);
+        parentPop[i].price = state.genomePrices[i];
+        parentPop[i].hash = 0;
+    }
+    eliteArchive.resize(state.archivePrices.size());
+    for(int i = 0; i < (int)eliteArchive.size(); i++)
+    {
+        eliteArchive[i].genome.assign(state.archiveGenomes.begin() + (size_t)i * state.dimension, state.archiveGenomes.begin() + (size_t)(i + 1) * state.dimension);
+        eliteArchive[i].price = state.archivePrices[i];
+        eliteArchive[i].hash = 0;
+    }
+    resultPath.genome = state.resultGenome;
+    resultPath.price = state.resultPrice;
+    if(!resultPath.genome.empty())
+        PublishPath(resultPath);
+
+    // Obnova citacu, statistik a generatoru nahodnych cisel
+    actGeneration = state.actGeneration;
+    rng.SetState(state.rngState);
+    result.crossoverCount = state.crossoverCount;
+    result.mutationCount = state.mutationCount;
+    result.genomeEvaluationCount = state.genomeEvaluationCount;
+    result.minPathPrice = state.prices[0];
+    result.maxPathPrice = state.prices[1];
+    result.avgPathPrice = state.prices[2];
+    result.minInitialPathPrice = state.prices[3];
+    result.maxInitialPathPrice = state.prices[4];
+    result.avgInitialPathPrice = state.prices[5];
+    result.minCurrentPathPrice = state.prices[6];
+    result.maxCurrentPathPrice = state.prices[7];
+    result.avgCurrentPathPrice = state.prices[8];
+    tempMinPathPrice = state.historyMin;
+    tempAvgPathPrice = state.historyAvg;
+    tempMaxPathPrice = state.historyMax;
+    historyStride = state.historyStride;
+    historyCount = state.historyCount;
+    result.restartCount = state.restartCount;
+    if(Config::GetInstance()->selfAdaptive)
+    {   // samoadaptivni parametry pokracuji z ulozenych hodnot
+        mutationRate = state.mutationRate;
+        tournamentLevel = state.tournamentLevel;
+        tournamentSize = (int)(tournamentLevel + 0.5);
+    }
+    convergedGenerations = state.convergedGenerations;
+    convergedBestPrice = result.minCurrentPathPrice;
+
+    // Doba behu pokracuje od okamziku ulozeni kontrolniho bodu
+    startTime -= (long long)(state.elapsedTime * 1e9);
+
+    cout << "Vypocet obnoven z kontrolniho bodu " << fileName << " (generace " << actGeneration << ")." << endl;
+
+    if(!cancelToken.IsCancelled())
+        emit CurrentPathGenerated(actGeneration, result.minCurrentPathPrice, result.avgCurrentPathPrice, result.maxCurrentPathPrice);
+
+    return true;
 }
 
 bool TSPEvolution::Done()
 {
-    bool done = (actGeneration == Config::GetInstance()->nGenerations);
+    Config *config = Config::GetInstance();
+    E_TERMINATION termination = TERMINATION_NONE;
+
+    // Cas zaverecneho doladeni je soucasti casoveho limitu
+    double polishReserve = (config->polishTime > 0 && info.symmetric) ? config->polishTime : 0;
+
+    // Podminky jsou serazeny od nejlevnejsi (diverzita vyzaduje pruchod populaci)
+    if(actGeneration >= config->nGenerations)
+        termination = TERMINATION_GENERATIONS;
+    else if(config->targetPrice > 0 && bestSeenPrice <= config->targetPrice)
+        termination = TERMINATION_TARGET_PRICE;
+    else if(config->stagnationGenerations > 0 && (actGeneration - lastImprovementGeneration) >= config->stagnationGenerations)
+        termination = TERMINATION_STAGNATION;
+    else if(config->timeLimit > 0 && ElapsedTime() >= config->timeLimit - polishReserve)
+        termination = TERMINATION_TIME_LIMIT;
+    else if(config->minDiversity > 0 && actGeneration > 0 && PopulationDiversity() < config->minDiversity)
+        termination = TERMINATION_DIVERSITY;
+    bool done = (termination != TERMINATION_NONE);
 
     // Akce po skonceni vypoctu
     if(done)
     {
-        // Vypocet a ulozeni doby behu
-        struct timeval endTime;
-        gettimeofday(&endTime, NULL);
-        result.runningTime.tv_sec = endTime.tv_sec - startTime.tv_sec;
-        if((endTime.tv_usec - startTime.tv_usec) < 0)
-        {
-            result.runningTime.tv_sec--;
-            result.runningTime.tv_usec = (startTime.tv_usec - endTime.tv_usec) + 1;
-        }
-        else
-        {
-            result.runningTime.tv_usec = endTime.tv_usec - startTime.tv_usec;
-        }
+        result.termination = termination;
+        cout << "Vypocet ukoncen v generaci " << actGeneration << ": " << TerminationName(termination) << "." << endl;
+        StoreRunningTime();
     }
 
     return done;
 }
 
+double TSPEvolution::PopulationDiversity()
+{
+    if(parentPop.empty())
+        return 0;
+
+    diversityPrices.resize(parentPop.size());
+    for(int i = 0; i < (int)parentPop.size(); i++)
+        diversityPrices[i] = parentPop[i].price;
+    sort(diversityPrices.begin(), diversityPrices.end());
+
+    int distinct = 1;
+    for(int i = 1; i < (int)diversityPrices.size(); i++)
+    {
+        if(diversityPrices[i] != diversityPrices[i - 1])
+            distinct++;
+    }
+    return (double)distinct / diversityPrices.size();
+}
+
+const char *TSPEvolution::TerminationName(E_TERMINATION termination)
+{
+    switch(termination)
+    {
+        case TERMINATION_GENERATIONS: return "dosazen pocet generaci";
+        case TERMINATION_TIME_LIMIT: return "vycerpan casovy limit";
+        case TERMINATION_TARGET_PRICE: return "dosazena cilova cena";
+        case TERMINATION_STAGNATION: return "stagnace nejlepsi ceny";
+        case TERMINATION_DIVERSITY: return "nizka diverzita populace";
+        case TERMINATION_ABORT: return "preruseno uzivatelem";
+        default: return "neukonceno";
+    }
+}
+
 void TSPEvolution::Step()
 {
-    // Nastartovani casovace (pokud jde o prvni generaci)
-    if(actGeneration == 0)
-        gettimeofday(&startTime, NULL);
+    if(Config::GetInstance()->steadyStateChildren > 0)
+    {
+        StepSteadyState();
+        return;
+    }
 
     int pIndex1, pIndex2;
+    long long phaseStart;
     childPop.clear();
+    childOperators.clear();
     tempPop.clear();
 
     // Vytvoreni mnoziny potomku
+    profiler.StartBreeding();
     while((int)childPop.size() < Config::GetInstance()->sPopulation)
     {
+        // Pri preruseni se rozpracovana generace zahodi (populace rodicu zustava nezmenena)
+        if(cancelToken.IsCancelled())
+            return;
+
         // Vyber rodicu
+        phaseStart = profiler.Start(false);
         pIndex1 = TournamentSelection(parentPop);
         pIndex2 = TournamentSelection(parentPop);
+        profiler.Stop(PHASE_SELECTION, phaseStart, false);
 
         // Tvorba novych potomku z vybranych potomku pomoci operatoru krizeni a mutace
         CreateNewIndividuals(parentPop[pIndex1], parentPop[pIndex2]);
     }
+    profiler.StopBreeding();
+
+    // Lokalni prohledavani potomku
+    if(useLocalSearch)
+    {
+        phaseStart = profiler.Start();
+        ImproveChildren();
+        profiler.Stop(PHASE_LOCAL_SEARCH, phaseStart);
+        if(cancelToken.IsCancelled())
+            return;
+    }
 
     // Ohodnoceni mnoziny potomku
+    phaseStart = profiler.Start();
+    long long evaluationStart = adaptiveOperators ? PhaseProfiler::Now() : 0;
     EvaluatePopulation(childPop);
+    profiler.Stop(PHASE_EVALUATION, phaseStart);
+    if(Config::GetInstance()->selfAdaptive)
+        AdaptParameters();
+    if(adaptiveOperators && !childPop.empty())
+        RewardOperators((PhaseProfiler::Now() - evaluationStart) / 1000.0 / childPop.size());
+
+    phaseStart = profiler.Start();
     tempPop.resize(childPop.size() + parentPop.size());
     copy(parentPop.begin(), parentPop.end(), tempPop.begin());
     copy(childPop.begin(), childPop.end(), (tempPop.begin() + parentPop.size()));
     parentPop.clear();
 
     // Aplikace elitismu - nejlepsi potomci jsou automaticky zkopirovani do nove populace
-    parentPop.resize(Config::GetInstance()->sElitism);
     sort(tempPop.begin(), tempPop.end(), FitnessSort);
-    copy(tempPop.begin(), (tempPop.begin() + Config::GetInstance()->sElitism), parentPop.begin());
+    if(noDuplicates)
+        RemoveDuplicates(tempPop);
+    parentPop.resize(min(Config::GetInstance()->sElitism, (int)tempPop.size()));
+    copy(tempPop.begin(), (tempPop.begin() + parentPop.size()), parentPop.begin());
+    profiler.Stop(PHASE_ELITISM, phaseStart);
+
+    // Sledovani zlepseni pro ukonceni pri stagnaci (populace je serazena, nejlepsi je prvni)
+    if(!tempPop.empty() && tempPop[0].price < bestSeenPrice)
+    {
+        bestSeenPrice = tempPop[0].price;
+        lastImprovementGeneration = actGeneration + 1;
+    }
 
     // Obnova populace
+    phaseStart = profiler.Start();
     Survive(parentPop, tempPop);
+    profiler.Stop(PHASE_SURVIVE, phaseStart);
+
+    profiler.EndGeneration();
+    this->actGeneration++;
+}
+
+void TSPEvolution::StepSteadyState()
+{
+    int sPopulation = Config::GetInstance()->sPopulation;
+    int batchSize = Config::GetInstance()->steadyStateChildren;
+    long long phaseStart;
+
+    // Halda se sestavuje na zacatku kazde generace (populaci mohl mezitim zmenit restart nebo obnova)
+    phaseStart = profiler.Start();
+    heapPrices.resize(parentPop.size());
+    int bestIndex = 0;
+    for(int i = 0; i < (int)parentPop.size(); i++)
+    {
+        heapPrices[i] = parentPop[i].price;
+        if(parentPop[i].price < parentPop[bestIndex].price)
+            bestIndex = i;
+    }
+    worstHeap.Build(heapPrices);
+    profiler.Stop(PHASE_SURVIVE, phaseStart);
+
+    int created = 0;
+    while(created < sPopulation)
+    {
+        // Pri preruseni se rozpracovana davka zahodi (nahrazeni jedinci uz v populaci zustavaji)
+        if(cancelToken.IsCancelled())
+            return;
+
+        // Vytvoreni davky potomku
+        childPop.clear();
+        childOperators.clear();
+        profiler.StartBreeding();
+        while((int)childPop.size() < batchSize && !cancelToken.IsCancelled())
+        {
+            phaseStart = profiler.Start(false);
+            int pIndex1 = TournamentSelection(parentPop);
+            int pIndex2 = TournamentSelection(parentPop);
+            profiler.Stop(PHASE_SELECTION, phaseStart, false);
+
+            CreateNewIndividuals(parentPop[pIndex1], parentPop[pIndex2]);
+        }
+        profiler.StopBreeding();
+        if(cancelToken.IsCancelled())
+            return;
+        created += childPop.size();
+
+        // Lokalni prohledavani davky
+        if(useLocalSearch)
+        {
+            phaseStart = profiler.Start();
+            ImproveChildren();
+            profiler.Stop(PHASE_LOCAL_SEARCH, phaseStart);
+            if(cancelToken.IsCancelled())
+                return;
+        }
 
+        // Ohodnoceni davky
+        phaseStart = profiler.Start();
+        long long evaluationStart = adaptiveOperators ? PhaseProfiler::Now() : 0;
+        EvaluatePopulation(childPop);
+        profiler.Stop(PHASE_EVALUATION, phaseStart);
+        if(Config::GetInstance()->selfAdaptive)
+            AdaptParameters();
+        if(adaptiveOperators && !childPop.empty())
+            RewardOperators((PhaseProfiler::Now() - evaluationStart) / 1000.0 / childPop.size());
+
+        // Nahrazeni nejhorsich jedincu lepsimi potomky (nejlepsi jedinec se tak nikdy nenahradi)
+        phaseStart = profiler.Start();
+        for(int i = 0; i < (int)childPop.size(); i++)
+        {
+            int worstIndex = worstHeap.Top();
+            if(childPop[i].price >= parentPop[worstIndex].price)
+                continue;
+            if(noDuplicates && ContainsTour(parentPop, childPop[i]))
+            {   // cesta uz v populaci je (hash se porovnava jen pri shode ceny)
+                result.duplicateCount++;
+                continue;
+            }
+
+            parentPop[worstIndex] = childPop[i];
+            worstHeap.Update(worstIndex, childPop[i].price);
+            if(childPop[i].price < parentPop[bestIndex].price)
+                bestIndex = worstIndex;
+        }
+        profiler.Stop(PHASE_SURVIVE, phaseStart);
+    }
+
+    // Sledovani zlepseni pro ukonceni pri stagnaci
+    if(!parentPop.empty() && parentPop[bestIndex].price < bestSeenPrice)
+    {
+        bestSeenPrice = parentPop[bestIndex].price;
+        lastImprovementGeneration = actGeneration + 1;
+    }
+
+    profiler.EndGeneration();
     this->actGeneration++;
 }
 
 void TSPEvolution::CreateNewIndividuals(tIndividual &parent1, tIndividual &parent2)
 {
     tIndividual child1, child2;
+    tOperatorRecord record;
+    record.localSearchGain = 0;
+
+    // Krizenim dvou stejnych cest vznikne opet tataz cesta; potomkem je kopie rodice (vcetne hashe)
+    if(tourHashing && parent1.price == parent2.price && TourHashOf(parent1) == TourHashOf(parent2))
+    {
+        record.crossover = -1;
+        record.parentPrice = parent1.price;
+        record.crossoverTime = 0;
+        child1 = parent1;
+        AddChild(child1, record);
+        return;
+    }
 
-    switch(Config::GetInstance()->tCrossover)
+    // V adaptivnim rezimu operator krizeni vybira bandita
+    E_CROSSOVER crossover = Config::GetInstance()->tCrossover;
+    record.crossover = -1;
+    if(crossover == ADAPTIVE_CROSSOVER)
+    {
+        crossover = (E_CROSSOVER)crossoverBandit.Select(rng);
+        record.crossover = crossover;
+    }
+    record.parentPrice = min(parent1.price, parent2.price);
+    record.crossoverTime = 0;
+    long long operatorStart = adaptiveOperators ? PhaseProfiler::Now() : 0;
+    long long phaseStart = profiler.Start(false);
+
+    switch(crossover)
     {
         case PMX:
             CrossoverPMX(parent1, parent2, child1);  // krizeni rodicu -> vznik potomku
-            Mutation(child1);            // mutace potomku
-            childPop.push_back(child1);  // zarazeni novych jedincu do populace potomku
             break;
         case ERX:
             CrossoverERX(parent1, parent2, child1);
-            Mutation(child1);
-            childPop.push_back(child1);
             break;
         case OX:
             CrossoverOX(parent1, parent2, child1);
-            Mutation(child1);
-            childPop.push_back(child1);
             break;
         case CX:
             CrossoverCX(parent1, parent2, child1, child2);
-            Mutation(child1);
-            Mutation(child2);
-            childPop.push_back(child1);
-            childPop.push_back(child2);
             break;
+        default:
+            break;
+    }
+    profiler.Stop(PHASE_CROSSOVER, phaseStart, false);
+    if(cancelToken.IsCancelled())   // potomek muze byt po preruseni neuplny
+        return;
+    child1.hash = child2.hash = 0;
+
+    // Doba krizeni pripadajici na jednoho potomka
+    if(adaptiveOperators)
+        record.crossoverTime = (PhaseProfiler::Now() - operatorStart) / (child2.genome.empty() ? 1000.0 : 2000.0);
+
+    // Mutace potomku a zarazeni novych jedincu do populace potomku
+    AddChild(child1, record);
+    if(!child2.genome.empty())
+        AddChild(child2, record);
+}
+
+void TSPEvolution::AddChild(tIndividual &child, tOperatorRecord record)
+{
+    Mutation(child, record);
+    childPop.push_back(child);
+    if(adaptiveOperators || Config::GetInstance()->selfAdaptive)
+        childOperators.push_back(record);
+}
+
+int TSPEvolution::PrepareNeighbours()
+{
+    int neighbourCount = min(Config::GetInstance()->localSearchNeighbours, info.dimension - 1);
+    if(cityNeighbours.GetCount() < neighbourCount)
+    {
+        NeighbourBuilder builder;
+        builder.Build(cityMatrix, cityPosition, info.edgeWeightType, neighbourCount, cityNeighbours);
     }
+    return neighbourCount;
 }
 
-void TSPEvolution::Mutation(tIndividual &individual)
+void TSPEvolution::ImproveChildren()
 {
-    double randomValue = (double)rand() / RAND_MAX;
+    Config *config = Config::GetInstance();
+    int neighbourCount = PrepareNeighbours();
+
+    // Vyber potomku (pri podilu 1 vsichni)
+    vector<int> selected;
+    for(int i = 0; i < (int)childPop.size(); i++)
+    {
+        if(config->localSearch >= 1 || rng.Real() < config->localSearch)
+            selected.push_back(i);
+    }
+
+    // Zkraceni potomku se zaznamena, aby se operatorum pripisovalo jen jejich vlastni zlepseni
+    LocalSearch localSearch;
+    bool recordGains = (childOperators.size() == childPop.size());
+    vector<double> gains;
+    localSearch.Improve(cityMatrix, cityNeighbours, neighbourCount, childPop, selected, cancelToken, config->localSearchMethod,
+                        0, recordGains ? &gains : NULL);
+    if(recordGains)
+    {
+        for(int i = 0; i < (int)selected.size(); i++)
+            childOperators[selected[i]].localSearchGain = gains[i];
+    }
+    result.localSearchCount += localSearch.GetImproved();
+    result.localSearchMoves += localSearch.GetMoves();
+    result.localSearchGain += localSearch.GetGain();
+}
+
+void TSPEvolution::PolishResult()
+{
+    // Nejlepsi jedinec posledni populace jeste nemusel byt do vysledne cesty prevzat
+    SetGenerationStatistics();
+    if(resultPath.genome.empty())
+        return;
+
+    // Doladeni se vejde do zbytku casoveho limitu
+    double polishTime = Config::GetInstance()->polishTime;
+    if(Config::GetInstance()->timeLimit > 0)
+        polishTime = min(polishTime, Config::GetInstance()->timeLimit - ElapsedTime());
+    if(polishTime <= 0)
+        return;
+
+    long long start = PhaseProfiler::Now();
+    int neighbourCount = PrepareNeighbours();
+    tIndividual polished = resultPath;
+    LocalSearch localSearch;
+    int kicks = localSearch.Polish(cityMatrix, cityNeighbours, neighbourCount, polished.genome, cancelToken,
+                                   polishTime, rng);
+    polished.hash = 0;
+    EvaluateGenome(polished);
+    result.polishTime = (PhaseProfiler::Now() - start) / 1e9;
+
+    if(polished.price < resultPath.price)
+    {
+        result.polishGain = resultPath.price - polished.price;
+        resultPath = polished;
+        result.minPathPrice = min(result.minPathPrice, resultPath.price);
+        PublishPath(resultPath);
+    }
+    cout << "Zaverecne doladeni: " << result.polishTime << " s, zkraceni cesty o " << result.polishGain
+         << " (" << localSearch.GetMoves() << " tahu, " << kicks << " naruseni)." << endl;
+}
 
-    if(randomValue < Config::GetInstance()->pMutation)
+void TSPEvolution::AdaptParameters()
+{
+    for(int i = 0; i < (int)childOperators.size(); i++)
+    {
+        if(childPop[i].price + childOperators[i].localSearchGain < childOperators[i].parentPrice)
+            adaptationSuccesses++;
+    }
+    adaptationChildren += childOperators.size();
+
+    if(adaptationChildren < adaptationPeriod * Config::GetInstance()->sPopulation)
+        return;
+
+    // Pravidlo 1/5: pri nizke uspesnosti se vice mutuje a prisneji vybira, pri vysoke naopak
+    int sPopulation = Config::GetInstance()->sPopulation;
+    double factor = (adaptationSuccesses * 5 < adaptationChildren) ? (1 / adaptationFactor) : adaptationFactor;
+    mutationRate = min(1.0, max(minMutationRate, mutationRate * factor));
+    tournamentLevel = min((double)max(2, sPopulation / 2), max(2.0, tournamentLevel * factor));
+    tournamentSize = (int)(tournamentLevel + 0.5);
+    adaptationChildren = adaptationSuccesses = 0;
+}
+
+void TSPEvolution::RewardOperators(double evaluationTime)
+{
+    // Zlepseni se vztahuje u krizeni k lepsimu z rodicu, u mutace k potomkovi pred mutaci
+    // (potomek se bere v podobe pred lokalnim prohledavanim a krizeni v podobe pred mutaci);
+    // cenou je doba behu operatoru a ohodnoceni potomka, ktery vytvoril
+    for(int i = 0; i < (int)childOperators.size(); i++)
+    {
+        const tOperatorRecord &record = childOperators[i];
+        double price = childPop[i].price + record.localSearchGain;
+        double mutationPrice = price - record.mutationChange;
+        if(record.crossover >= 0)
+        {
+            double gain = (record.parentPrice > 0) ? max(0.0, (record.parentPrice - mutationPrice) / record.parentPrice) : 0;
+            crossoverBandit.Reward(record.crossover, gain, max(record.crossoverTime + evaluationTime, minOperatorTime));
+        }
+        if(record.mutation >= 0)
+        {
+            double gain = (mutationPrice > 0) ? max(0.0, -record.mutationChange / mutationPrice) : 0;
+            mutationBandit.Reward(record.mutation, gain, max(record.mutationTime + evaluationTime, minOperatorTime));
+        }
+    }
+    childOperators.clear();
+}
+
+void TSPEvolution::Mutation(tIndividual &individual, tOperatorRecord &record)
+{
+    long long phaseStart = profiler.Start(false);
+    double randomValue = rng.Real();
+
+    record.mutation = -1;
+    record.mutationTime = 0;
+    record.mutationChange = 0;
+    if(randomValue < mutationRate)
     {   // mutace je provadena pouze s urcitou pravdepodobnosti
-        switch(Config::GetInstance()->tMutation)
+        E_MUTATION mutation = Config::GetInstance()->tMutation;
+        long long operatorStart = 0;
+
+        // Zmena ceny mutaci se spocita jen ze zmenenych hran; potrebuji ji adaptivni operatory
+        // (krizeni se hodnoti na potomkovi pred mutaci)
+        double *priceChange = NULL;
+        if(mutation == ADAPTIVE_MUTATION || Config::GetInstance()->tCrossover == ADAPTIVE_CROSSOVER)
+            priceChange = &record.mutationChange;
+        if(mutation == ADAPTIVE_MUTATION)
+        {   // v adaptivnim rezimu operator mutace vybira bandita; zlepseni se meri proti potomkovi pred mutaci
+            // (zmena ceny se zapocita do doby mutace)
+            mutation = (E_MUTATION)mutationBandit.Select(rng);
+            record.mutation = mutation;
+            operatorStart = PhaseProfiler::Now();
+        }
+
+        // U nesymetricke vzdalenosti meni obraceni useku delku jeho vnitrnich hran, zmena ceny se
+        // proto spocita z cele cesty pred mutaci a po ni (vymena mest smer hran nemeni)
+        bool wholeTour = (priceChange != NULL && !info.symmetric && mutation != SWAP);
+        double lengthBefore = 0;
+        if(wholeTour)
+        {
+            lengthBefore = GenomeLength(individual.genome);
+            priceChange = NULL;
+        }
+
+        switch(mutation)
         {
             case SWAP:
-                MutationSwap(individual);
+                MutationSwap(individual, priceChange);
                 break;
             case INVERSION:
-                MutationInversion(individual);
+                MutationInversion(individual, priceChange);
                 break;
             case OPT_2:
-                MutationOpt2(individual);
+                MutationOpt2(individual, priceChange);
                 break;
             case OPT_3:
-                MutationOpt3(individual);
+                MutationOpt3(individual, priceChange);
+                break;
+            default:
                 break;
         }
+
+        if(wholeTour)
+            record.mutationChange = GenomeLength(individual.genome) - lengthBefore;
+        if(record.mutation >= 0)
+            record.mutationTime = (PhaseProfiler::Now() - operatorStart) / 1000.0;
     }
+
+    profiler.Stop(PHASE_MUTATION, phaseStart, false);
+}
+
+double TSPEvolution::EdgesLength(const vector<int> &genome, const int *positions, int count)
+{
+    double length = 0;
+    for(int i = 0; i < count; i++)
+    {
+        bool repeated = false;
+        for(int j = 0; j < i; j++)
+            repeated = repeated || (positions[j] == positions[i]);
+        if(repeated)
+            continue;
+
+        int next = (positions[i] + 1 < (int)genome.size()) ? positions[i] + 1 : 0;
+        length += cityMatrix.Distance(genome[positions[i]], genome[next]);
+    }
+    return length;
 }
 
-void TSPEvolution::MutationSwap(tIndividual &individual)
+double TSPEvolution::GenomeLength(const vector<int> &genome)
+{
+    double length = 0;
+    for(int i = 0; i < (int)genome.size(); i++)
+        length += cityMatrix.Distance(genome[i], genome[(i + 1 < (int)genome.size()) ? i + 1 : 0]);
+    return length;
+}
+
+void TSPEvolution::MutationSwap(tIndividual &individual, double *priceChange)
 {
     // Nahodne vygenerovani indexu dvou mest, ve kterych dojde k zamene
-    int randCity1 = rand() % info.dimension;
-    int randCity2 = rand() % info.dimension;
+    int randCity1 = rng.Int(info.dimension);
+    int randCity2 = rng.Int(info.dimension);
     int tempCity;
 
+    // Hrany vychazejici z mest a z jejich predchudcu (pro prubeznou aktualizaci hashe)
+    int positions[] = {(randCity1 + info.dimension - 1) % info.dimension, randCity1,
+                       (randCity2 + info.dimension - 1) % info.dimension, randCity2};
+    if(individual.hash != 0)
+        individual.hash ^= tourHash.EdgesAt(individual.genome, positions, 4);
+    double removedLength = (priceChange != NULL) ? EdgesLength(individual.genome, positions, 4) : 0;
+
     // Zamena vybranych mest
     tempCity = individual.genome[randCity1];
     individual.genome[randCity1] = individual.genome[randCity2];
     individual.genome[randCity2] = tempCity;
 
+    if(individual.hash != 0)
+        individual.hash ^= tourHash.EdgesAt(individual.genome, positions, 4);
+    if(priceChange != NULL)
+        *priceChange = EdgesLength(individual.genome, positions, 4) - removedLength;
+
     result.mutationCount++;
 }
 
-void TSPEvolution::MutationInversion(tIndividual &individual)
+void TSPEvolution::MutationInversion(tIndividual &individual, double *priceChange)
 {
     // Nahodne vygenerovani indexu dvou mest, mezi kterymi bude provedena inverze
-    int randCity1 = rand() % info.dimension;
-    int randCity2 = rand() % info.dimension;
+    int randCity1 = rng.Int(info.dimension);
+    int randCity2 = rng.Int(info.dimension);
     int tempCity;
     if(randCity1 > randCity2)
     {
@@ -370,6 +1336,12 @@ void TSPEvolution::MutationInversion(tIndividual &individual)
         randCity2 = tempCity;
     }
 
+    // Zmeni se jen hrany na okrajich obraceneho useku
+    int positions[] = {(randCity1 + info.dimension - 1) % info.dimension, randCity2};
+    if(individual.hash != 0)
+        individual.hash ^= tourHash.EdgesAt(individual.genome, positions, 2);
+    double removedLength = (priceChange != NULL) ? EdgesLength(individual.genome, positions, 2) : 0;
+
     // Inverze mezi nahodne vygenerovanymi body
     vector<int> dummyVector;
     dummyVector.resize(randCity2 - randCity1 + 1);
@@ -378,19 +1350,30 @@ void TSPEvolution::MutationInversion(tIndividual &individual)
     individual.genome.erase((individual.genome.begin() + randCity1), (individual.genome.begin() + randCity2 + 1));
     individual.genome.insert((individual.genome.begin() + randCity1), dummyVector.begin(), dummyVector.end());
 
+    if(individual.hash != 0)
+        individual.hash ^= tourHash.EdgesAt(individual.genome, positions, 2);
+    if(priceChange != NULL)
+        *priceChange = EdgesLength(individual.genome, positions, 2) - removedLength;
+
     result.mutationCount++;
 }
 
-void TSPEvolution::MutationOpt2(tIndividual &individual)
+void TSPEvolution::MutationOpt2(tIndividual &individual, double *priceChange)
 {
     // Nahodne vygenerovani indexu dvou mest, mezi bude provedena 2-zamena
     int randCity1, randCity2;
     do
     {
-        randCity1 = rand() % info.dimension;
-        randCity2 = rand() % info.dimension;
+        randCity1 = rng.Int(info.dimension);
+        randCity2 = rng.Int(info.dimension);
     } while(randCity1 == randCity2);
 
+    // Zmeni se jen hrany vychazejici z obou bodu 2-zameny
+    int positions[] = {randCity1, randCity2};
+    if(individual.hash != 0)
+        individual.hash ^= tourHash.EdgesAt(individual.genome, positions, 2);
+    double removedLength = (priceChange != NULL) ? EdgesLength(individual.genome, positions, 2) : 0;
+
     // Vytvoreni pomocneho vektoru s obracenym poradim mest vybraneho useku
     vector<int> dummyVector;
     int actIndex = randCity2;
@@ -416,24 +1399,35 @@ void TSPEvolution::MutationOpt2(tIndividual &individual)
         individual.genome.insert(individual.genome.begin(), dummyVector.begin() + info.dimension - 1 - randCity1, dummyVector.end());
     }
 
+    if(individual.hash != 0)
+        individual.hash ^= tourHash.EdgesAt(individual.genome, positions, 2);
+    if(priceChange != NULL)
+        *priceChange = EdgesLength(individual.genome, positions, 2) - removedLength;
+
     result.mutationCount++;
 }
 
-void TSPEvolution::MutationOpt3(tIndividual &individual)
+void TSPEvolution::MutationOpt3(tIndividual &individual, double *priceChange)
 {
     // Nahodne vygenerovani indexu tri ruznych mest tak, aby platila nerovnost randCity1 < randCity2 < randCity3
     int randCity1, randCity2, randCity3;
     while(true)
     {
-        randCity1 = rand() % info.dimension;
-        randCity2 = rand() % info.dimension;
-        randCity3 = rand() % info.dimension;
+        randCity1 = rng.Int(info.dimension);
+        randCity2 = rng.Int(info.dimension);
+        randCity3 = rng.Int(info.dimension);
         if((randCity1 < randCity3) && (randCity2 > randCity1) && (randCity2 < randCity3))
             break;
         if((randCity1 > randCity3) && ((randCity2 > randCity1) || (randCity2 < randCity3)))
             break;
     }
 
+    // Zmeni se jen hrany vychazejici ze tri bodu 3-zameny
+    int positions[] = {randCity1, randCity2, randCity3};
+    if(individual.hash != 0)
+        individual.hash ^= tourHash.EdgesAt(individual.genome, positions, 3);
+    double removedLength = (priceChange != NULL) ? EdgesLength(individual.genome, positions, 3) : 0;
+
     // Naplneni pomocneho vektoru s obracenym poradim mest vybraneho useku mezi naslednikem 1.bodu 3-vymeny a 2.bodem 3-vymeny
     vector<int> dummyVector;
     int actIndex = randCity2;
@@ -484,6 +1478,11 @@ void TSPEvolution::MutationOpt3(tIndividual &individual)
         individual.genome.insert(individual.genome.begin(), dummyVector.begin() + info.dimension - 1 - randCity2, dummyVector.end());
     }
 
+    if(individual.hash != 0)
+        individual.hash ^= tourHash.EdgesAt(individual.genome, positions, 3);
+    if(priceChange != NULL)
+        *priceChange = EdgesLength(individual.genome, positions, 3) - removedLength;
+
     result.mutationCount++;
 }
 
@@ -529,7 +1528,7 @@ void TSPEvolution::CrossoverERX(tIndividual &parent1, tIndividual &parent2, tInd
     }
 
     // Vlozeni prvniho mesta do genomu potomka (nahodne se vybere prvni mesto bud z prvniho nebo z druheho rodice)
-    int actCity = ((rand() % 2) == 0) ? parent1.genome[0] : parent2.genome[0];
+    int actCity = (rng.Int(2) == 0) ? parent1.genome[0] : parent2.genome[0];
     child.genome.push_back(actCity);
 
     // Smazani prvniho mesta ze seznamu sousedu ostatnich mest
@@ -555,6 +1554,10 @@ void TSPEvolution::CrossoverERX(tIndividual &parent1, tIndividual &parent2, tInd
     vector<int> edgeTableOption;
     while((int)child.genome.size() < info.dimension)
     {
+        // Krok je linearni v poctu mest, takze overeni preruseni je proti nemu zanedbatelne
+        if(cancelToken.IsCancelled())
+            return;
+
         isNeighbour = !edgeTable[actCity].neighbourCity.empty();  // pomucka pro urceni, ze uzel jiz nema zadneho souseda
 
         // Nalezeni sousedu aktualniho mesta s nejmensim poctem jinych sousedu
@@ -585,9 +1588,9 @@ void TSPEvolution::CrossoverERX(tIndividual &parent1, tIndividual &parent2, tInd
 
         // Urceni noveho aktualniho mesta
         if(!isNeighbour)  // pokud dosavadni mesto nema zadneho souseda, je vybran nahodny, jeste neprirazany, uzel z tabulky
-            actCity = rand() % edgeTable.size();
+            actCity = rng.Int(edgeTable.size());
         else              // jinak je vybrano mesto, ktery ma nejmensi pocet sousedu (je-li jich vice, bere se nahodne jeden z nich)
-            actCity = edgeTableOption[rand() % edgeTableOption.size()];
+            actCity = edgeTableOption[rng.Int(edgeTableOption.size())];
 
         // Vybrane mesto se umisti do genomu potomka
         child.genome.push_back(edgeTable[actCity].cityIndex);
@@ -615,8 +1618,8 @@ void TSPEvolution::CrossoverOX(tIndividual &parent1, tIndividual &parent2, tIndi
     vector<int> usedCities;
 
     // Ziskani indexu pro body krizeni
-    int crossPoint1 = rand() % info.dimension;
-    int crossPoint2 = rand() % info.dimension;
+    int crossPoint1 = rng.Int(info.dimension);
+    int crossPoint2 = rng.Int(info.dimension);
     int tempPoint;
     if(crossPoint1 > crossPoint2)
     {
@@ -731,8 +1734,8 @@ void TSPEvolution::CrossoverCX(tIndividual &parent1, tIndividual &parent2, tIndi
 void TSPEvolution::CrossoverPMX(tIndividual &parent1, tIndividual &parent2, tIndividual &child)
 {
     // Ziskani indexu pro body krizeni
-    int crossPoint1 = rand() % info.dimension;
-    int crossPoint2 = rand() % info.dimension;
+    int crossPoint1 = rng.Int(info.dimension);
+    int crossPoint2 = rng.Int(info.dimension);
 
     int tempPoint;
     if(crossPoint1 > crossPoint2)
@@ -788,25 +1791,181 @@ void TSPEvolution::CrossoverPMX(tIndividual &parent1, tIndividual &parent2, tInd
 void TSPEvolution::Survive(vector<tIndividual> &population, vector<tIndividual> &selectedPopulation)
 {
     int championIndex;
-    while((int)population.size() < Config::GetInstance()->sPopulation)
+    int sPopulation = Config::GetInstance()->sPopulation;
+    int attempts = noDuplicates ? surviveAttempts * sPopulation : 0;
+    if(attempts > 0 && (int)selectedPopulation.size() <= sPopulation)
+    {   // ruznych cest neni vic nez mist v populaci: prevezmou se vsechny a zbytek se doplni turnajem
+        population = selectedPopulation;
+        attempts = 0;
+    }
+
+    // Cesty jiz prevzate do populace (elitni jedinci)
+    if(attempts > 0)
+    {
+        survivorTours.Reset(sPopulation);
+        for(int i = 0; i < (int)population.size(); i++)
+            survivorTours.Insert(TourHashOf(population[i]));
+    }
+
+    while((int)population.size() < sPopulation)
     {
         championIndex = TournamentSelection(selectedPopulation);
+        if(attempts > 0 && !survivorTours.Insert(TourHashOf(selectedPopulation[championIndex])))
+        {   // cesta uz v populaci je
+            attempts--;
+            continue;
+        }
         population.push_back(selectedPopulation[championIndex]);
         //selectedPopulation.erase(selectedPopulation.begin() + championIndex);
     }
 }
 
+void TSPEvolution::CheckRestart()
+{
+    // Populace je zkonvergovana, lisi-li se prumerna cena od nejlepsi jen nepatrne; citac se nuluje
+    // jen zlepsenim nejlepsi ceny (ojedinely zmutovany jedinec konvergenci neprerusi)
+    Config *config = Config::GetInstance();
+    if(result.minCurrentPathPrice < convergedBestPrice)
+    {
+        convergedBestPrice = result.minCurrentPathPrice;
+        convergedGenerations = 0;
+    }
+    else if((result.avgCurrentPathPrice - result.minCurrentPathPrice) <= config->restartThreshold * result.minCurrentPathPrice)
+    {
+        convergedGenerations++;
+    }
+
+    if(convergedGenerations >= config->restartGenerations)
+    {
+        RestartPopulation();
+        convergedGenerations = 0;
+        convergedBestPrice = DBL_MAX;
+    }
+}
+
+void TSPEvolution::RestartPopulation()
+{
+    int sPopulation = Config::GetInstance()->sPopulation;
+
+    // Nejlepsi jedinec zkonvergovane populace se ulozi do archivu
+    int bestIndex = 0;
+    for(int i = 1; i < (int)parentPop.size(); i++)
+    {
+        if(parentPop[i].price < parentPop[bestIndex].price)
+            bestIndex = i;
+    }
+    if(!parentPop.empty())
+        UpdateArchive(parentPop[bestIndex]);
+
+    // Nova populace: clenove archivu, polovina zbytku jejich porusene kopie, zbytek nahodni jedinci
+    int archiveCount = min((int)eliteArchive.size(), sPopulation);
+    int perturbedCount = (eliteArchive.empty()) ? 0 : (sPopulation - archiveCount) / 2;
+    parentPop.resize(sPopulation);
+    childPop.clear();
+    for(int i = 0; i < sPopulation; i++)
+    {
+        if(i < archiveCount)
+        {
+            parentPop[i] = eliteArchive[i];
+            continue;
+        }
+
+        if(i < archiveCount + perturbedCount)
+        {
+            parentPop[i] = eliteArchive[rng.Int(eliteArchive.size())];
+            PerturbDoubleBridge(parentPop[i]);
+        }
+        else
+        {
+            RandomGenome(parentPop[i]);
+        }
+        childPop.push_back(parentPop[i]);
+    }
+
+    // Ohodnoti se jen nove jedinci (ceny clenu archivu jsou zname)
+    EvaluatePopulation(childPop);
+    for(int i = archiveCount; i < sPopulation; i++)
+        parentPop[i].price = childPop[i - archiveCount].price;
+    childPop.clear();
+
+    result.restartCount++;
+    cout << "Restart populace v generaci " << actGeneration << " (archiv " << eliteArchive.size()
+         << " cest, nejlepsi " << eliteArchive.front().price << ")." << endl;
+}
+
+void TSPEvolution::UpdateArchive(tIndividual &individual)
+{
+    // Stejnou cenu mohou mit i ruzne cesty, shoda se proto overi hashem
+    for(int i = 0; i < (int)eliteArchive.size(); i++)
+    {
+        if(eliteArchive[i].price == individual.price && TourHashOf(eliteArchive[i]) == TourHashOf(individual))
+            return;
+    }
+
+    int archiveSize = Config::GetInstance()->archiveSize;
+    if((int)eliteArchive.size() >= archiveSize && individual.price >= eliteArchive.back().price)
+        return;
+
+    vector<tIndividual>::iterator it = upper_bound(eliteArchive.begin(), eliteArchive.end(), individual, FitnessSort);
+    eliteArchive.insert(it, individual);
+    if((int)eliteArchive.size() > archiveSize)
+        eliteArchive.resize(archiveSize);
+}
+
+void TSPEvolution::RandomGenome(tIndividual &individual)
+{
+    individual.genome.resize(info.dimension);
+    for(int i = 0; i < info.dimension; i++)
+        individual.genome[i] = i;
+    for(int i = info.dimension - 1; i > 0; i--)
+        swap(individual.genome[i], individual.genome[rng.Int(i + 1)]);
+    individual.price = 0;
+    individual.hash = 0;
+}
+
+void TSPEvolution::PerturbDoubleBridge(tIndividual &individual)
+{
+    int dimension = info.dimension;
+    if(dimension < 8)
+    {
+        MutationSwap(individual);
+        return;
+    }
+
+    // Tri ruzne body rezu 0 < cut1 < cut2 < cut3 < dimension
+    int cut[3];
+    do
+    {
+        cut[0] = 1 + rng.Int(dimension - 1);
+        cut[1] = 1 + rng.Int(dimension - 1);
+        cut[2] = 1 + rng.Int(dimension - 1);
+        sort(cut, cut + 3);
+    } while(cut[0] == cut[1] || cut[1] == cut[2]);
+
+    // Prohozeni useku B = <cut1, cut2) a C = <cut2, cut3); zmeni se jen hrany na hranicich useku
+    int removed[] = {cut[0] - 1, cut[1] - 1, cut[2] - 1};
+    int added[] = {cut[0] - 1, cut[0] + cut[2] - cut[1] - 1, cut[2] - 1};
+    if(individual.hash != 0)
+        individual.hash ^= tourHash.EdgesAt(individual.genome, removed, 3);
+    rotate(individual.genome.begin() + cut[0], individual.genome.begin() + cut[1], individual.genome.begin() + cut[2]);
+    if(individual.hash != 0)
+        individual.hash ^= tourHash.EdgesAt(individual.genome, added, 3);
+    individual.price = 0;
+
+    result.mutationCount++;
+}
+
 int TSPEvolution::TournamentSelection(vector<tIndividual> &population)
 {
     tIndividual champion;
 
     // Nahodny vyber jednotlivcu z populace (ucastniku "turnaje")
     int randIndex, minIndex = 0;
-    float minPrice = FLT_MAX;
+    double minPrice = DBL_MAX;
 
-    for(int i = 0; i < Config::GetInstance()->sTournament; i++)
+    for(int i = 0; i < tournamentSize; i++)
     {
-        randIndex = rand() % population.size();
+        randIndex = rng.Int(population.size());
         if(population[randIndex].price < minPrice)
         {
             minPrice = population[randIndex].price;
@@ -825,21 +1984,28 @@ bool TSPEvolution::SaveResults(string outputFile)
     if(!file.good())
         return false;
 
-    // Vypocet prumerne ceny za vsechny generace
-    float multConstant = (float)1 / ((float)actGeneration / Config::GetInstance()->logInterval);
-    for(int i = 0; i < (int)tempAvgPathPrice.size(); i++)
-        result.avgPathPrice += tempAvgPathPrice[i] * multConstant;
-
+    file << setprecision(15);
     file << "***** NALEZENA CESTA *****\n";
     for(int i = 0; i < (int)resultPath.genome.size(); i++)
-        file << resultPath.genome[i]  << " ";
+        file << OriginalCityId(info, resultPath.genome[i])  << " ";
 
     file << "\n\n***** PARAMETRY BEHU GA *****\n";
     file << Config::GetInstance()->problemFile   << "\t # cesta k vstupnimu datovemu souboru\n";
     file << actGeneration                << "\t # aktualni generace behu vypoctu\n";
+    file << TerminationName(result.termination) << "\t # duvod ukonceni vypoctu\n";
     file << result.crossoverCount        << "\t # pocet aplikaci operatoru krizeni od inicializace\n";
     file << result.mutationCount         << "\t # pocet aplikaci operatoru mutace od inicializace\n";
-    file << result.genomeEvaluationCount << "\t # pocet ohodnoceni genomu od inicializace\n\n";
+    file << result.genomeEvaluationCount << "\t # pocet ohodnoceni genomu od inicializace\n";
+    file << result.restartCount          << "\t # pocet restartu populace od inicializace\n";
+    file << mutationRate                 << "\t # efektivni pravdepodobnost mutace\n";
+    file << tournamentSize               << "\t # efektivni pocet ucastniku turnaje\n";
+    file << fitnessCache.GetHits()       << "\t # pocet ohodnoceni usporenych vyrovnavaci pameti cen cest\n";
+    file << result.duplicateCount        << "\t # pocet duplicitnich jedincu vyrazenych pri obnove populace\n";
+    file << result.localSearchCount      << "\t # pocet potomku zlepsenych lokalnim prohledavanim\n";
+    file << result.localSearchMoves      << "\t # pocet tahu lokalniho prohledavani\n";
+    file << result.localSearchGain       << "\t # celkove zkraceni cest potomku lokalnim prohledavanim\n";
+    file << result.polishTime            << "\t # doba zaverecneho doladeni nejlepsi cesty [s]\n";
+    file << result.polishGain            << "\t # zkraceni nejlepsi cesty zaverecnym doladenim\n\n";
 
     file << "***** CELKOVE STATISTIKY *****\n";
     file << result.runningTime.tv_sec << "." << result.runningTime.tv_usec << "s\t # doba behu vypoctu\n";
@@ -857,10 +2023,32 @@ bool TSPEvolution::SaveResults(string outputFile)
     file << result.maxCurrentPathPrice   << "\t # nejhorsi cena cesty v aktualni populaci\n";
     file << result.avgCurrentPathPrice   << "\t # prumerna cena cesty v aktualni populaci\n\n";
 
+    if(adaptiveOperators)
+    {
+        file << "***** ADAPTIVNI VYBER OPERATORU (pouziti, relativni zlepseni za us) *****\n";
+        if(Config::GetInstance()->tCrossover == ADAPTIVE_CROSSOVER)
+        {
+            for(int i = 0; i < crossoverBandit.GetArmCount(); i++)
+                file << crossoverNames[i] << "\t" << crossoverBandit.GetUses(i) << "\t" << crossoverBandit.GetRate(i) << "\t # operator krizeni\n";
+        }
+        if(Config::GetInstance()->tMutation == ADAPTIVE_MUTATION)
+        {
+            for(int i = 0; i < mutationBandit.GetArmCount(); i++)
+                file << mutationNames[i] << "\t" << mutationBandit.GetUses(i) << "\t" << mutationBandit.GetRate(i) << "\t # operator mutace\n";
+        }
+        file << "\n";
+    }
+
+    if(profiler.IsEnabled())
+    {
+        file << "***** DOBA BEHU FAZI (celkem, podil, prumer / posledni / maximum na generaci) *****\n";
+        file << profiler.Report() << "\n";
+    }
+
     file << "***** MEZIVYSLEDKY *****\n";
     for(int i = 0; i < (int)tempMinPathPrice.size(); i++)
     {
-        file << (i * Config::GetInstance()->logInterval) << " \t";
+        file << ((long long)i * historyStride * Config::GetInstance()->logInterval) << " \t";
         file << tempMinPathPrice[i] << " \t";
         file << tempAvgPathPrice[i] << " \t";
         file << tempMaxPathPrice[i] << "\n";
@@ -871,6 +2059,11 @@ bool TSPEvolution::SaveResults(string outputFile)
     return true;
 }
 
+string TSPEvolution::GetPhaseReport()
+{
+    return profiler.Report();
+}
+
 bool FitnessSort(tIndividual inv1, tIndividual inv2)
 {
     return (inv1.price < inv2.price);
@@ -24,35 +24,108 @@
 #include <time.h>
 #include <sys/time.h>
 #include <sstream>
+#include <iomanip>
 #include "config.h"
+#include "profiler.h"
+#include "randomGenerator.h"
+#include "checkpoint.h"
+#include "statisticsLog.h"
+#include "snapshotChannel.h"
+#include "cancellationToken.h"
+#include "operatorBandit.h"
+#include "tourHash.h"
+#include "indexedHeap.h"
+#include "cityMatrix.h"
 
 using namespace std;
 
+/// Zpusob vypoctu vzdalenosti mest (EDGE_WEIGHT_TYPE ve formatu TSPLIB).
+enum E_EDGE_WEIGHT
+{
+    EUC_2D = 0,    ///< Eukleidovska vzdalenost.
+    CEIL_2D = 1,   ///< Eukleidovska vzdalenost zaokrouhlena nahoru.
+    ATT = 2,       ///< Pseudo-eukleidovska vzdalenost (ulohy att48, att532).
+    GEO = 3,       ///< Geograficka vzdalenost (souradnice ve stupnich a minutach).
+    EXPLICIT = 4   ///< Vzdalenosti zadane primo matici (EDGE_WEIGHT_SECTION).
+};
+
+/// Duvody ukonceni evolucniho vypoctu.
+enum E_TERMINATION
+{
+    TERMINATION_NONE = 0,          ///< Vypocet dosud nebyl ukoncen.
+    TERMINATION_GENERATIONS = 1,   ///< Dosazen pozadovany pocet generaci.
+    TERMINATION_TIME_LIMIT = 2,    ///< Vycerpan casovy limit (TIME_LIMIT).
+    TERMINATION_TARGET_PRICE = 3,  ///< Nalezena cesta s cenou nejvyse TARGET_PRICE.
+    TERMINATION_STAGNATION = 4,    ///< Nejlepsi cena se nezlepsila po STAGNATION_GENERATIONS generaci.
+    TERMINATION_DIVERSITY = 5,     ///< Diverzita populace klesla pod MIN_DIVERSITY.
+    TERMINATION_ABORT = 6          ///< Vypocet prerusil uzivatel.
+};
+
 /// Informace o resenem problemu.
 typedef struct
 {
     string name;      ///< Pojmenovani (identifikace) problemu.
     string comment;   ///< Komentar k problemu.
     int dimension;    ///< Dimenze (pocet mest)
+    E_EDGE_WEIGHT edgeWeightType;  ///< Zpusob vypoctu vzdalenosti mest.
+    vector<int> cityId;            ///< Puvodni cislo (poradi v souboru) mest; prazdne, nejsou-li mesta precislovana.
+    bool symmetric;                ///< Udava, zda-li je vzdalenost mest symetricka (nesymetricka muze byt jen matice EXPLICIT).
 } tProblemInfo;
 
+/**
+ * Prevede index mesta na jeho puvodni cislo (poradi v souboru).
+ * @param info Informace o problemu.
+ * @param city Index mesta.
+ * @return Puvodni cislo mesta.
+ */
+inline int OriginalCityId(const tProblemInfo &info, int city)
+{
+    return info.cityId.empty() ? city : info.cityId[city];
+}
+
 /// Pozice mesta na mape.
 typedef struct
 {
-    int x;  ///< Pozice X
-    int y;  ///< Pozice Y
+    double x;  ///< Pozice X
+    double y;  ///< Pozice Y
 } CityPosition;
 
-/// Radek hodnot v matici propojeni mest.
-typedef vector<float> CityMatrixRow;
-
 /// Genom jednotlivce v populaci.
 typedef struct
 {
     vector<int> genome;  ///< Genom (permutace indexu mest).
-    float price;         ///< Cena cesty mezi mesty.
+    double price;        ///< Cena cesty mezi mesty.
+    unsigned long long hash;   ///< Hash cesty (TourHash; 0 = neni spocitan).
 } tIndividual;
 
+/// Prubezne metriky vypoctu (pro export do monitorovacich nastroju).
+typedef struct
+{
+    bool running;                        ///< Udava, zda-li vypocet prave probiha.
+    int generation;                      ///< Cislo aktualni generace.
+    int nGenerations;                    ///< Pozadovany pocet generaci.
+    double minPrice;                     ///< Nejlepsi cena cesty v aktualni populaci.
+    double avgPrice;                     ///< Prumerna cena cesty v aktualni populaci.
+    double maxPrice;                     ///< Nejhorsi cena cesty v aktualni populaci.
+    double bestPrice;                    ///< Nejlepsi cena cesty od inicializace.
+    long long evaluationCount;           ///< Pocet ohodnoceni genomu.
+    long long crossoverCount;            ///< Pocet aplikaci operatoru krizeni.
+    long long mutationCount;             ///< Pocet aplikaci operatoru mutace.
+    double evaluationsPerSecond;         ///< Pocet ohodnoceni za sekundu od posledni aktualizace.
+    double generationsPerSecond;         ///< Pocet generaci za sekundu od posledni aktualizace.
+    double elapsedSeconds;               ///< Doba behu vypoctu.
+    long long phaseTime[PHASE_COUNT];    ///< Celkova doba behu fazi evolucniho kroku [ns].
+    bool distanceCache;                  ///< Udava, zda-li se vzdalenosti ctou z vyrovnavaci pameti radku.
+    long long distanceCacheHits;         ///< Pocet zasahu vyrovnavaci pameti radku.
+    long long distanceCacheMisses;       ///< Pocet chyb vyrovnavaci pameti radku.
+    bool fitnessCache;                   ///< Udava, zda-li se ceny cest ctou z vyrovnavaci pameti.
+    long long fitnessCacheHits;          ///< Pocet ohodnoceni usporenych vyrovnavaci pameti cen cest.
+    long long fitnessCacheMisses;        ///< Pocet chyb vyrovnavaci pameti cen cest.
+    long long localSearchMoves;          ///< Pocet tahu lokalniho prohledavani.
+    double mutationRate;                 ///< Efektivni pravdepodobnost mutace.
+    int tournamentSize;                  ///< Efektivni pocet ucastniku turnaje.
+} tMetrics;
+
 /// Trida pro optimalizaci trasy obchodniho cestujiciho.
 class TSPEvolution : public QThread
 {
@@ -77,42 +150,103 @@ class TSPEvolution : public QThread
         vector<int> neighbourCity;  ///< Index sousedniho mesta.
     } tEdgeTable;
 
+    /// Operatory pouzite pro vytvoreni potomka (pro adaptivni vyber operatoru a samoadaptaci).
+    typedef struct
+    {
+        int crossover;          ///< Operator krizeni (-1 = nebyl vybran adaptivne).
+        int mutation;           ///< Operator mutace (-1 = mutace neprobehla nebo nebyla vybrana adaptivne).
+        double crossoverTime;   ///< Doba krizeni pripadajici na potomka [us].
+        double mutationTime;    ///< Doba mutace [us].
+        double parentPrice;     ///< Cena lepsiho z rodicu.
+        double mutationChange;  ///< Zmena ceny potomka mutaci (jen pri adaptivnim vyberu operatoru; zaporna = zkraceni).
+        double localSearchGain; ///< Zkraceni potomka lokalnim prohledavanim (operatorum se nepripisuje).
+    } tOperatorRecord;
+
     /// Vysledky vypoctu.
     typedef struct
     {
         int crossoverCount;          ///< Pocet aplikaci operatoru krizeni od inicializace.
         int mutationCount;           ///< Pocet aplikaci operatoru mutace od inicializace.
         int genomeEvaluationCount;   ///< Pocet ohodnoceni genomu od inicializace.
-        float avgPathPrice;          ///< Prumerna cena cesty od inicializace.
-        float maxPathPrice;          ///< Maximalni cena cesty od inicializace.
-        float minPathPrice;          ///< Minimalni cene cesty od inicializace.
-        float avgInitialPathPrice;   ///< Prumerna cena cesty v pocatecni populaci.
-        float minInitialPathPrice;   ///< Nejlepsi cena cesty v pocatecni populaci.
-        float maxInitialPathPrice;   ///< Nejhorsi cena cesty v pocatecni populaci.
-        float avgCurrentPathPrice;   ///< Prumerna cena cesty v aktualni populaci.
-        float minCurrentPathPrice;   ///< Nejlepsi cena cesty v aktualni populaci.
-        float maxCurrentPathPrice;   ///< Nejhorsi cena cesty v aktualni populaci.
+        int restartCount;            ///< Pocet restartu populace od inicializace.
+        long long duplicateCount;    ///< Pocet duplicitnich jedincu vyrazenych pri obnove populace.
+        long long localSearchCount;  ///< Pocet potomku zlepsenych lokalnim prohledavanim.
+        long long localSearchMoves;  ///< Pocet tahu lokalniho prohledavani.
+        double localSearchGain;      ///< Celkove zkraceni cest potomku lokalnim prohledavanim.
+        double polishTime;           ///< Doba zaverecneho doladeni nejlepsi cesty [s].
+        double polishGain;           ///< Zkraceni nejlepsi cesty zaverecnym doladenim.
+        double avgPathPrice;         ///< Prumerna cena cesty od inicializace.
+        double maxPathPrice;         ///< Maximalni cena cesty od inicializace.
+        double minPathPrice;         ///< Minimalni cene cesty od inicializace.
+        double avgInitialPathPrice;  ///< Prumerna cena cesty v pocatecni populaci.
+        double minInitialPathPrice;  ///< Nejlepsi cena cesty v pocatecni populaci.
+        double maxInitialPathPrice;  ///< Nejhorsi cena cesty v pocatecni populaci.
+        double avgCurrentPathPrice;  ///< Prumerna cena cesty v aktualni populaci.
+        double minCurrentPathPrice;  ///< Nejlepsi cena cesty v aktualni populaci.
+        double maxCurrentPathPrice;  ///< Nejhorsi cena cesty v aktualni populaci.
         struct timeval runningTime;  ///< Cas behu vypoctu.
+        E_TERMINATION termination;   ///< Duvod ukonceni vypoctu.
     } tResult;
 
     tProblemInfo info;           ///< Informace o resenem problemu.
     tResult result;              ///< Vysledky vypoctu.
+    PhaseProfiler profiler;      ///< Mereni doby behu fazi evolucniho kroku.
+    RandomGenerator rng;         ///< Generator pseudonahodnych cisel vlakna vypoctu.
+    CheckpointWriter checkpointWriter;  ///< Zapisovac kontrolnich bodu.
+    tCheckpoint checkpointState;        ///< Buffer pro sestaveni kontrolniho bodu.
+    double checkpointFingerprint;       ///< Otisk vzdalenosti pro kontrolni body (zaporny = dosud nespocitan).
     int actGeneration;           ///< Cislo aktualni generace behu evoluce.
     vector<tIndividual> parentPop;     ///< Genomy jednotlivcu populace rodicu (permutace mest).
     vector<tIndividual> childPop;      ///< Genomy jednotlivcu populace deti (permutace mest).
     vector<tIndividual> tempPop;       ///< Genomy rodicu a deti vybrane do dalsiho cyklu behu GA.
-    vector<CityMatrixRow> cityMatrix;  ///< Matice spojeni mest.
-    struct timeval startTime;    ///< Cas zacatku spusteni vypoctu.
+    CityMatrix cityMatrix;             ///< Matice spojeni mest.
+    vector<CityPosition> cityPosition; ///< Pozice mest (pro tvorbu pocatecni populace).
+    CityNeighbours cityNeighbours;     ///< Seznamy nejblizsich sousedu (pro tvorbu pocatecni populace).
+    long long startTime;         ///< Cas zacatku spusteni vypoctu (monotonni, PhaseProfiler::Now() [ns]).
     tIndividual resultPath;      ///< Vysledna cesta obchodniho cestujiciho.
-    vector<float> tempAvgPathPrice;
-    vector<float> tempMinPathPrice;
-    vector<float> tempMaxPathPrice;
-
-    bool abortFlag;                       //< Priznak ukonceni evolucnich vypoctu
-    bool sleepFlag;                       //< Priznak pozastaveni evolucnich vypoctu
-
-    QMutex mutex;
-    QWaitCondition condition;
+    SnapshotChannel<tIndividual> bestPathChannel;   ///< Posledni zverejnena nejlepsi cesta (pro zobrazeni).
+    vector<double> tempAvgPathPrice;   ///< Historie prumernych cen (omezena, po historyStride intervalech logovani).
+    vector<double> tempMinPathPrice;   ///< Historie nejlepsich cen.
+    vector<double> tempMaxPathPrice;   ///< Historie nejhorsich cen.
+    int historyStride;                 ///< Pocet intervalu logovani mezi body historie.
+    int historyCount;                  ///< Pocet vsech zaznamenanych intervalu logovani (vcetne vynechanych).
+    double bestSeenPrice;              ///< Nejlepsi cena cesty od inicializace (aktualizuje se kazdou generaci).
+    int lastImprovementGeneration;     ///< Generace posledniho zlepseni nejlepsi ceny.
+    vector<double> diversityPrices;    ///< Pomocne pole pro vypocet diverzity populace.
+    vector<tIndividual> eliteArchive;  ///< Archiv nejlepsich navzajem ruznych cest (serazeny podle ceny).
+    bool adaptiveOperators;            ///< Udava, zda-li se nektery operator vybira adaptivne.
+    OperatorBandit crossoverBandit;    ///< Adaptivni vyber operatoru krizeni.
+    OperatorBandit mutationBandit;     ///< Adaptivni vyber operatoru mutace.
+    vector<tOperatorRecord> childOperators;   ///< Operatory pouzite pro potomky v childPop (pri adaptivnim vyberu).
+    double mutationRate;               ///< Efektivni pravdepodobnost mutace (pri samoadaptaci se meni).
+    double tournamentLevel;            ///< Spojita hodnota velikosti turnaje (pri samoadaptaci se meni).
+    int tournamentSize;                ///< Efektivni pocet ucastniku turnaje (zaokrouhleny tournamentLevel).
+    int adaptationChildren;            ///< Pocet potomku od posledni upravy parametru.
+    int adaptationSuccesses;           ///< Pocet uspesnych potomku (lepsich nez oba rodice) od posledni upravy.
+    TourHash tourHash;                 ///< Klice pro hashovani cest.
+    bool tourHashing;                  ///< Udava, zda-li se pouziva hash cest (vyrovnavaci pamet cen nebo zakaz duplicit).
+    bool noDuplicates;                 ///< Udava, zda-li se uplatnuje zakaz duplicit (NO_DUPLICATES u symetricke ulohy).
+    bool useLocalSearch;               ///< Udava, zda-li se potomci zlepsuji lokalnim prohledavanim (LOCAL_SEARCH u symetricke ulohy).
+    FitnessCache fitnessCache;         ///< Vyrovnavaci pamet cen cest.
+    TourSet survivorTours;             ///< Hashe cest prevzatych do nove populace (pri zakazu duplicit).
+    IndexedHeap worstHeap;             ///< Halda jedincu populace podle ceny (v ustalenem rezimu; na vrcholu nejhorsi).
+    vector<double> heapPrices;         ///< Pomocne pole cen pro sestaveni haldy.
+    int convergedGenerations;          ///< Pocet generaci se zkonvergovanou populaci od posledniho zlepseni.
+    double convergedBestPrice;         ///< Nejlepsi cena v populaci od posledniho restartu (zlepseni nuluje convergedGenerations).
+    StatisticsLog statisticsLog;       ///< Prubezny zapis statistik generaci do souboru.
+
+    CancellationToken cancelToken;        ///< Priznak ukonceni evolucnich vypoctu (overuje se i uvnitr operatoru).
+    QAtomicInt sleepFlag;                 ///< Priznak pozastaveni evolucnich vypoctu.
+
+    QMutex mutex;                         ///< Zamek pro cekani pozastaveneho vypoctu (pouziva se jen pri pozastaveni).
+    QWaitCondition condition;             ///< Podminka pro probuzeni pozastaveneho vypoctu.
+
+    tMetrics metrics;                     ///< Posledni zverejnene metriky vypoctu.
+    QMutex metricsMutex;                  ///< Zamek pro pristup k metrikam.
+    long long metricsStartTime;           ///< Cas zacatku vypoctu (monotonni hodiny) [ns].
+    long long metricsLastTime;            ///< Cas posledni aktualizace metrik [ns].
+    int metricsLastGeneration;            ///< Generace pri posledni aktualizaci metrik.
+    int metricsLastEvaluationCount;       ///< Pocet ohodnoceni pri posledni aktualizaci metrik.
 
     /**
     * Smycka evolucniho vypoctu.
@@ -126,11 +260,33 @@ class TSPEvolution : public QThread
     void EvaluatePopulation(vector<tIndividual> &population);
 
     /**
-     * Ohodnoti jedince v populaci.
+     * Ohodnoti jedince v populaci. Je-li zapnuta vyrovnavaci pamet cen, cena znamych cest se
+     * prevezme z ni a ohodnoceni se neprovede.
      * @param individual Ohodnocovany jedinec v populaci.
      */
     void EvaluateGenome(tIndividual &individual);
 
+    /**
+     * Vrati hash cesty jedince (neni-li spocitan, spocita jej).
+     * @param individual Jedinec.
+     * @return Hash cesty.
+     */
+    unsigned long long TourHashOf(tIndividual &individual);
+
+    /**
+     * Overi, zda-li populace obsahuje cestu jedince (porovnava cenu a pri shode hash).
+     * @param population Prohledavana populace.
+     * @param individual Hledany jedinec.
+     * @return True, obsahuje-li populace stejnou cestu.
+     */
+    bool ContainsTour(vector<tIndividual> &population, tIndividual &individual);
+
+    /**
+     * Odstrani z populace serazene podle ceny jedince se stejnou cestou (ponecha se prvni z nich).
+     * @param population Populace serazena podle ceny.
+     */
+    void RemoveDuplicates(vector<tIndividual> &population);
+
     /**
      * Vytvori populaci jedincu (mnozinu permutaci mest).
      */
@@ -143,35 +299,100 @@ class TSPEvolution : public QThread
      */
     void CreateNewIndividuals(tIndividual &parent1, tIndividual &parent2);
 
+    /**
+     * Zmutuje potomka a zaradi jej do populace potomku.
+     * @param child Potomek.
+     * @param record Operatory pouzite pro vytvoreni potomka (doplni se operator mutace).
+     */
+    void AddChild(tIndividual &child, tOperatorRecord record);
+
+    /**
+     * Pripravi seznamy nejblizsich sousedu pro lokalni prohledavani (pri prvnim pouziti se vypocitaji).
+     * @return Pocet zkousenych sousedu kazdeho mesta.
+     */
+    int PrepareNeighbours();
+
+    /**
+     * Zlepsi lokalnim prohledavanim (LOCAL_SEARCH) nahodne vybrany podil potomku v childPop.
+     * Potomci jeste nejsou ohodnoceni.
+     */
+    void ImproveChildren();
+
+    /**
+     * Doladi nejlepsi nalezenou cestu tahy LK s casovym limitem POLISH_TIME (pred ohlasenim vysledku).
+     */
+    void PolishResult();
+
+    /**
+     * Upravi pravdepodobnost mutace a velikost turnaje podle pravidla 1/5 uspechu (potomek je uspesny,
+     * je-li lepsi nez oba rodice). Je-li uspesna mene nez petina potomku, krizeni populaci uz nezlepsuje:
+     * zvysi se pravdepodobnost mutace (novy genovy material) i selekcni tlak (prezivaji jen zlepsujici
+     * mutanti). Pri vyssi uspesnosti se oba parametry snizi ve prospech diverzity. Parametry se upravuji
+     * vzdy po nekolika generacich, tj. po nekolikanasobku velikosti populace potomku (zapocitavaji se
+     * potomci z childOperators).
+     */
+    void AdaptParameters();
+
+    /**
+     * Preda banditum odmeny za operatory pouzite pro ohodnocene potomky (childOperators).
+     * @param evaluationTime Prumerna doba ohodnoceni jednoho potomka [us].
+     */
+    void RewardOperators(double evaluationTime);
+
     /**
      * Mutuje genom vybraneho jedince populace.
      * @param individual Vybrany jedinec populace urceny k mutaci.
+     * @param record Zaznam pouzitych operatoru, do ktereho se doplni operator a doba mutace.
      */
-    void Mutation(tIndividual &individual);
+    void Mutation(tIndividual &individual, tOperatorRecord &record);
 
     /**
      * Mutace typu jednoduchy swap (zamena dvou nahodne vybranych mest).
      * @param individual Vybrany jedinec populace urceny k mutaci.
+     * @param priceChange Zmena ceny cesty spocitana ze zmenenych hran (NULL = nepocita se).
      */
-    void MutationSwap(tIndividual &individual);
+    void MutationSwap(tIndividual &individual, double *priceChange = NULL);
 
     /**
      * Mutace typu inverze (zamena dvou nahodne vybranych mest).
      * @param individual Vybrany jedinec populace urceny k mutaci.
+     * @param priceChange Zmena ceny cesty spocitana ze zmenenych hran (NULL = nepocita se; plati jen
+     * pro symetrickou vzdalenost, obracenim useku se meni smer jeho vnitrnich hran).
      */
-    void MutationInversion(tIndividual &individual);
+    void MutationInversion(tIndividual &individual, double *priceChange = NULL);
 
     /**
      * Mutace typu 2-OPT.
      * @param individual Vybrany jedinec populace urceny k mutaci.
+     * @param priceChange Zmena ceny cesty spocitana ze zmenenych hran (NULL = nepocita se; plati jen
+     * pro symetrickou vzdalenost, obracenim useku se meni smer jeho vnitrnich hran).
      */
-    void MutationOpt2(tIndividual &individual);
+    void MutationOpt2(tIndividual &individual, double *priceChange = NULL);
 
     /**
      * Mutace typu 3-OPT.
      * @param individual Vybrany jedinec populace urceny k mutaci.
+     * @param priceChange Zmena ceny cesty spocitana ze zmenenych hran (NULL = nepocita se; plati jen
+     * pro symetrickou vzdalenost, obracenim useku se meni smer jeho vnitrnich hran).
      */
-    void MutationOpt3(tIndividual &individual);
+    void MutationOpt3(tIndividual &individual, double *priceChange = NULL);
+
+    /**
+     * Secte delky hran vychazejicich z danych pozic genomu (k naslednikum, cyklicky).
+     * Kazda pozice se zapocita jednou, stejne jako pri prubezne aktualizaci hashe.
+     * @param genome Permutace mest.
+     * @param positions Pozice v genomu.
+     * @param count Pocet pozic.
+     * @return Soucet delek hran.
+     */
+    double EdgesLength(const vector<int> &genome, const int *positions, int count);
+
+    /**
+     * Secte delky vsech hran cesty (bez zapocteni do poctu ohodnoceni a bez vyrovnavaci pameti cen).
+     * @param genome Permutace mest.
+     * @return Delka cesty.
+     */
+    double GenomeLength(const vector<int> &genome);
 
     /**
      * Krizeni typu PMX (partially matched crossover).
@@ -215,45 +436,157 @@ class TSPEvolution : public QThread
     int TournamentSelection(vector<tIndividual> &population);
 
     /**
-     * Zajisti obnovu populace.
+     * Zajisti obnovu populace. Pri zakazu duplicit (NO_DUPLICATES) obsahuje selectedPopulation
+     * jen navzajem ruzne cesty a vitez turnaje, jehoz cesta uz v populaci je, se odmitne; neni-li
+     * ruznych cest dost, populace se doplni duplicitami. Prevzate cesty se eviduji v mnozine hashu.
      * @param population Populace, nad kterou selekce probiha.
      * @param selectedPopulation
      * @return Vitez turnaje (permutace cest s nejnizsi cenou).
      */
     void Survive(vector<tIndividual> &population, vector<tIndividual> &selectedPopulation);
 
+    /**
+     * Overi konvergenci populace podle statistik aktualni generace (SetGenerationStatistics)
+     * a po RESTART_GENERATIONS zkonvergovanych generacich bez zlepseni provede restart populace.
+     */
+    void CheckRestart();
+
+    /**
+     * Restartuje populaci. Nejlepsi jedinec se vlozi do archivu; nova populace se slozi
+     * z clenu archivu, z jejich porusenych kopii (double bridge) a z nahodnych jedincu.
+     */
+    void RestartPopulation();
+
+    /**
+     * Vlozi jedince do archivu nejlepsich cest (jen neni-li v nem stejna cesta; cesty se
+     * porovnavaji cenou a hashem).
+     * @param individual Vkladany jedinec (dopocita se mu hash).
+     */
+    void UpdateArchive(tIndividual &individual);
+
+    /**
+     * Vygeneruje nahodnou permutaci mest.
+     * @param individual Jedinec, jehoz genom se vygeneruje.
+     */
+    void RandomGenome(tIndividual &individual);
+
+    /**
+     * Narusi cestu prohozenim dvou useku (double bridge; A B C D -> A C B D). Zmeni tri
+     * hrany a 2-zamenou ji nelze vratit; pri malem poctu mest se prohodi dve mesta.
+     * @param individual Poruseny jedinec.
+     */
+    void PerturbDoubleBridge(tIndividual &individual);
+
     /**
      * Ulozi vysledky k dane generaci behu vypoctu
      */
     void SetGenerationStatistics();
 
     /**
-     * Ziska cislo aktualni generace behu vypoctu.
-     * @return Urcuje, zda-li jiz bylo dosazeno pozadovaneho poctu generaci.
+     * Prida bod do historie cen. Historie ma omezenou velikost; pri jejim zaplneni se kazdy
+     * druhy bod vynecha a interval mezi body se zdvojnasobi.
+     * @param minPrice Nejlepsi cena cesty v populaci.
+     * @param avgPrice Prumerna cena cesty v populaci.
+     * @param maxPrice Nejhorsi cena cesty v populaci.
+     */
+    void AppendHistory(double minPrice, double avgPrice, double maxPrice);
+
+    /**
+     * Zverejni cestu pro zobrazeni (bez cekani; ctenar uvidi jen nejnovejsi zverejnenou cestu).
+     * @param path Zverejnovana cesta.
+     */
+    void PublishPath(const tIndividual &path);
+
+    /**
+     * Preda statistiky aktualni generace zapisovaci statistik.
+     * @param minPrice Nejlepsi cena cesty v populaci.
+     * @param avgPrice Prumerna cena cesty v populaci.
+     * @param maxPrice Nejhorsi cena cesty v populaci.
+     */
+    void LogStatistics(double minPrice, double avgPrice, double maxPrice);
+
+    /**
+     * Aktualizuje metriky vypoctu (nejvyse ctyrikrat za sekundu, neni-li aktualizace vynucena).
+     * @param running Udava, zda-li vypocet stale probiha.
+     * @param force Vynuti aktualizaci bez ohledu na dobu od posledni aktualizace.
+     */
+    void PublishMetrics(bool running, bool force);
+
+    /**
+     * Vrati dobu behu vypoctu od jeho spusteni.
+     * @return Doba behu [s].
+     */
+    double ElapsedTime();
+
+    /**
+     * Vypocita a ulozi dobu behu vypoctu do vysledku.
+     */
+    void StoreRunningTime();
+
+    /**
+     * Vypocita otisk vzdalenosti reseneho problemu (delku cesty pres mesta v poradi souboru);
+     * lisi se u jine ulohy se stejnym poctem mest i u jineho zaokrouhleni vzdalenosti.
+     * @return Otisk vzdalenosti.
+     */
+    double DistanceFingerprint();
+
+    /**
+     * Sestavi kontrolni bod z aktualniho stavu a preda jej k zapisu na pozadi.
+     */
+    void SaveCheckpoint();
+
+    /**
+     * Obnovi stav vypoctu z kontrolniho bodu (soubor CHECKPOINT_FILE).
+     * @return Urcuje, zda-li se obnoveni podarilo.
+     */
+    bool RestoreCheckpoint();
+
+    /**
+     * Overi podminky ukonceni vypoctu (pocet generaci, casovy limit, cilova cena, stagnace
+     * a diverzita populace); splnene podminky se kombinuji jako "nebo".
+     * @return Urcuje, zda-li je splnena nektera z podminek ukonceni.
      */
     bool Done();
 
+    /**
+     * Vypocita diverzitu populace rodicu jako podil ruznych cen cest.
+     * @return Diverzita populace (0 az 1).
+     */
+    double PopulationDiversity();
+
     /**
      * Provede jeden evolucni krok.
      */
     void Step();
 
+    /**
+     * Provede jeden evolucni krok v ustalenem rezimu (STEADY_STATE): po davkach se vytvori tolik
+     * potomku, kolik je jedincu v populaci, a kazdy potomek lepsi nez nejhorsi jedinec jej hned
+     * nahradi. Nejhorsi jedinec se hleda v indexovane halde cen (O(log P) na potomka), populace
+     * se tedy nekopiruje ani neradi. Pri zakazu duplicit se potomek, jehoz cesta uz v populaci je,
+     * zahodi.
+     */
+    void StepSteadyState();
+
     public:
 
     /**
     * Hleda trasu obchodniho cestujiciho pro zadanou mnozinu mest.
     * @param cityMatrix Mnozina mest.
+    * @param cityPosition Pozice mest (prazdne = nejsou k dispozici).
+    * @param cityNeighbours Seznamy nejblizsich sousedu (prazdne = nejsou k dispozici).
     * @param info Informace o problemu.
     */
-    void FindSolution(vector<CityMatrixRow> &cityMatrix, tProblemInfo info);
+    void FindSolution(CityMatrix &cityMatrix, const vector<CityPosition> &cityPosition, const CityNeighbours &cityNeighbours, tProblemInfo info);
 
     /**
-    * Pozastavi evoluci pravidel.
+    * Pozastavi evoluci pravidel, resp. obnovi pozastavenou evoluci.
     */
     void StopEvolution();
 
     /**
-    * Zrusi evoluci pravidel.
+    * Zrusi evoluci pravidel. Neceka na dobehnuti vlakna; rozpracovany krok se prerusi
+    * a po ukonceni vypoctu se zasle signal EvolutionAborted.
     */
     void AbortEvolution();
 
@@ -264,6 +597,43 @@ class TSPEvolution : public QThread
      */
     bool SaveResults(string outputFile);
 
+    /**
+     * Sestavi prehled doby behu jednotlivych fazi evolucniho kroku.
+     * @return Textovy prehled (jeden radek na fazi).
+     */
+    string GetPhaseReport();
+
+    /**
+     * Vrati duvod ukonceni posledniho vypoctu.
+     * @return Duvod ukonceni.
+     */
+    E_TERMINATION GetTermination() const { return result.termination; }
+
+    /**
+     * Vrati textovy popis duvodu ukonceni.
+     * @param termination Duvod ukonceni.
+     * @return Popis duvodu ukonceni.
+     */
+    static const char *TerminationName(E_TERMINATION termination);
+
+    /**
+     * Vrati kanal s posledni nalezenou nejlepsi cestou (cist jej smi jen jedno vlakno).
+     * @return Kanal s nejlepsi cestou.
+     */
+    SnapshotChannel<tIndividual> *GetBestPathChannel() { return &bestPathChannel; }
+
+    /**
+     * Vrati nejlepsi nalezenou cestu (jen ve chvili, kdy vypocet nebezi).
+     * @return Nejlepsi nalezena cesta.
+     */
+    const tIndividual &GetResultPath() const { return resultPath; }
+
+    /**
+     * Vrati posledni zverejnene metriky vypoctu (lze volat z libovolneho vlakna).
+     * @return Metriky vypoctu.
+     */
+    tMetrics GetMetrics();
+
     /**
     * Konstruktor.
     * @param parent Rodicovsky objekt.
@@ -277,20 +647,25 @@ class TSPEvolution : public QThread
 
     signals:
     /**
-    * Signal zaslany po provedeni urceneho poctu evolucnich kroku.
-    * @param resultPath Nejlepsi reseni nalezene v aktualnim evolucnim kroku.
+    * Signal zaslany po provedeni urceneho poctu evolucnich kroku (nejlepsi cestu predava GetBestPathChannel).
     * @param actGeneration Cislo aktualni generace.
     * @param minCurrentPathPrice Nejlepsi cena reseni v aktualnim evolucnim kroku.
     * @param avgCurrentPathPrice Prumerna cena reseni v aktualnim evolucnim kroku.
     * @param maxCurrentPathPrice Nejhorsi cena reseni v aktualnim evolucnim kroku.
     */
-    void CurrentPathGenerated(tIndividual resultPath, int actGeneration, float minCurrentPathPrice, float avgCurrentPathPrice, float axCurrentPathPrice);
+    void CurrentPathGenerated(int actGeneration, double minCurrentPathPrice, double avgCurrentPathPrice, double maxCurrentPathPrice);
 
     /**
     * Signal zaslany po dokonceni behu evoluce.
     * @param resultPath Nejlepsi reseni nalezene v aktualnim evolucnim kroku.
     */
     void PathGenerated(tIndividual resultPath);
+
+    /**
+    * Signal zaslany po ukonceni vypoctu prerusenem volanim AbortEvolution.
+    * @param resultPath Nejlepsi reseni nalezene do preruseni vypoctu.
+    */
+    void EvolutionAborted(tIndividual resultPath);
 };
 
 /**
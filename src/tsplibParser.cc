@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "tsplibParser.h"
+
+/// Mocniny deseti presne reprezentovatelne v typu double.
+static const double powersOf10[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+TSPLIBParser::TSPLIBParser()
+{
+    pos = end = NULL;
+}
+
+bool TSPLIBParser::Open(string fileName)
+{
+    pos = end = NULL;
+    storage = QSharedPointer<MatrixStorage>(new MatrixStorage);
+
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat fileInfo;
+    if(fstat(fd, &fileInfo) == 0 && S_ISREG(fileInfo.st_mode) && fileInfo.st_size > 0)
+    {   // bezny soubor se namapuje do pameti
+        void *address = mmap(NULL, fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(address != MAP_FAILED)
+        {
+            madvise(address, fileInfo.st_size, MADV_SEQUENTIAL);
+            storage->mapAddress = address;
+            storage->mapLength = fileInfo.st_size;
+            pos = (const char *)address;
+            end = pos + fileInfo.st_size;
+            close(fd);
+            return true;
+        }
+    }
+
+    // Soubor nelze namapovat (roura, prazdny soubor...) - cteni po velkych blocich
+    const size_t blockSize = 1 << 20;
+    ssize_t length;
+    size_t used = 0;
+    do
+    {
+        storage->buffer.resize(used + blockSize);
+        length = read(fd, &storage->buffer[used], blockSize);
+        if(length > 0)
+            used += length;
+    }
+    while(length > 0);
+    close(fd);
+
+    if(length < 0)
+        return false;
+
+    storage->buffer.resize(used);
+    pos = used ? &storage->buffer[0] : NULL;
+    end = pos + used;
+    return true;
+}
+
+bool TSPLIBParser::AtEnd()
+{
+    while(pos < end && IsSpace(*pos))
+        pos++;
+
+    return pos >= end;
+}
+
+bool TSPLIBParser::ReadKeyword(string &keyword, string &value)
+{
+    if(AtEnd())
+        return false;
+
+    // Hranice radku a pozice dvojtecky
+    const char *lineStart = pos;
+    const char *colon = NULL;
+    while(pos < end && *pos != '\n')
+    {
+        if(*pos == ':' && colon == NULL)
+            colon = pos;
+        pos++;
+    }
+    const char *lineEnd = pos;
+
+    const char *keyEnd = (colon != NULL) ? colon : lineEnd;
+    while(keyEnd > lineStart && IsSpace(keyEnd[-1]))
+        keyEnd--;
+    keyword.assign(lineStart, keyEnd);
+
+    value.clear();
+    if(colon != NULL)
+    {
+        const char *valueStart = colon + 1;
+        while(valueStart < lineEnd && IsSpace(*valueStart))
+            valueStart++;
+        const char *valueEnd = lineEnd;
+        while(valueEnd > valueStart && IsSpace(valueEnd[-1]))
+            valueEnd--;
+        value.assign(valueStart, valueEnd);
+    }
+
+    return true;
+}
+
+bool TSPLIBParser::ReadInt(long long &value)
+{
+    if(AtEnd())
+        return false;
+
+    const char *p = pos;
+    bool negative = false;
+    if(*p == '-' || *p == '+')
+        negative = (*p++ == '-');
+    if(p >= end || !IsDigit(*p))
+        return false;
+
+    long long number = 0;
+    while(p < end && IsDigit(*p))
+        number = number * 10 + (*p++ - '0');
+    if(p < end && !IsSpace(*p))
+        return false;   // nejde o samostatne cele cislo (napr. realne cislo)
+
+    value = negative ? -number : number;
+    pos = p;
+    return true;
+}
+
+bool TSPLIBParser::ReadDouble(double &value)
+{
+    if(AtEnd())
+        return false;
+
+    const char *p = pos;
+    bool negative = false;
+    if(*p == '-' || *p == '+')
+        negative = (*p++ == '-');
+
+    // Mantisa se sklada jako cele cislo (nejvyse 19 platnych cislic), desetinna tecka posouva exponent
+    unsigned long long mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool anyDigit = false;
+    while(p < end && IsDigit(*p))
+    {
+        if(digits < 19)
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+            if(mantissa != 0)
+                digits++;
+        }
+        else
+        {
+            exponent++;
+        }
+        anyDigit = true;
+        p++;
+    }
+    if(p < end && *p == '.')
+    {
+        p++;
+        while(p < end && IsDigit(*p))
+        {
+            if(digits < 19)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                if(mantissa != 0)
+                    digits++;
+                exponent--;
+            }
+            anyDigit = true;
+            p++;
+        }
+    }
+    if(!anyDigit)
+        return false;
+
+    if(p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char *e = p + 1;
+        bool negativeExponent = false;
+        if(e < end && (*e == '-' || *e == '+'))
+            negativeExponent = (*e++ == '-');
+        if(e < end && IsDigit(*e))
+        {
+            int explicitExponent = 0;
+            while(e < end && IsDigit(*e))
+            {
+                if(explicitExponent < 10000)
+                    explicitExponent = explicitExponent * 10 + (*e - '0');
+                e++;
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+            p = e;
+        }
+    }
+    if(p < end && !IsSpace(*p))
+        return false;
+
+    // Pro bezne zapisy (mantisa < 2^53, |exponent| <= 22) je vysledek spravne zaokrouhlen
+    double number = (double)mantissa;
+    if(exponent < 0)
+        number = (exponent >= -22) ? number / powersOf10[-exponent] : number * pow(10.0, exponent);
+    else if(exponent > 0)
+        number = (exponent <= 22) ? number * powersOf10[exponent] : number * pow(10.0, exponent);
+
+    value = negative ? -number : number;
+    pos = p;
+    return true;
+}
+
+void TSPLIBParser::SkipLine()
+{
+    while(pos < end && *pos != '\n')
+        pos++;
+    if(pos < end)
+        pos++;
+}
@@ -0,0 +1,90 @@
+/**
+* \file tsplibParser.h
+* Rychle cteni textovych souboru ve formatu TSPLIB.
+* \author Bendl Jaroslav (xbendl00)
+*/
+
+#ifndef TSPLIBPARSER_H_INCLUDED
+#define TSPLIBPARSER_H_INCLUDED
+
+#include <string>
+#include "cityMatrix.h"
+
+using namespace std;
+
+/**
+ * Proudove cteni souboru TSPLIB.
+ * Soubor je namapovan do pameti (nebo nacten po velkych blocich, nelze-li jej namapovat)
+ * a cisla se ctou primo z pameti bez vytvareni pomocnych retezcu. Mezi cisly muze byt
+ * libovolny pocet libovolnych bilych znaku.
+ */
+class TSPLIBParser
+{
+    private:
+    const char *pos;                          ///< Aktualni pozice ve ctenem souboru.
+    const char *end;                          ///< Konec souboru.
+    QSharedPointer<MatrixStorage> storage;    ///< Pamet s obsahem souboru.
+
+    /**
+     * Zjisti, zda-li je znak bilym znakem.
+     * @param c Znak.
+     * @return True, jde-li o bily znak.
+     */
+    static bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v'; }
+
+    /**
+     * Zjisti, zda-li je znak cislici.
+     * @param c Znak.
+     * @return True, jde-li o cislici.
+     */
+    static bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+    public:
+    /**
+    * Konstruktor.
+    */
+    TSPLIBParser();
+
+    /**
+     * Otevre soubor pro cteni.
+     * @param fileName Cesta k souboru.
+     * @return Urcuje, zda-li se soubor podarilo otevrit.
+     */
+    bool Open(string fileName);
+
+    /**
+     * Zjisti, zda-li bylo dosazeno konce souboru (bile znaky se preskoci).
+     * @return True na konci souboru.
+     */
+    bool AtEnd();
+
+    /**
+     * Precte dalsi neprazdny radek hlavicky a rozdeli jej na klicove slovo a hodnotu.
+     * Radky bez dvojtecky (nazvy sekci, EOF) maji prazdnou hodnotu.
+     * @param keyword Klicove slovo (bez bilych znaku na okrajich).
+     * @param value Hodnota (bez bilych znaku na okrajich).
+     * @return Urcuje, zda-li byl nejaky radek precten.
+     */
+    bool ReadKeyword(string &keyword, string &value);
+
+    /**
+     * Precte cele cislo.
+     * @param value Prectena hodnota.
+     * @return Urcuje, zda-li na aktualni pozici bylo cele cislo (jinak se pozice nemeni).
+     */
+    bool ReadInt(long long &value);
+
+    /**
+     * Precte realne cislo (vcetne zapisu s exponentem).
+     * @param value Prectena hodnota.
+     * @return Urcuje, zda-li na aktualni pozici bylo cislo (jinak se pozice nemeni).
+     */
+    bool ReadDouble(double &value);
+
+    /**
+     * Preskoci zbytek aktualniho radku.
+     */
+    void SkipLine();
+};
+
+#endif // TSPLIBPARSER_H_INCLUDED
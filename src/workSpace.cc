@@ -1,7 +1,13 @@
 #include "workSpace.h"
 #include "tsp_evolution.h"
 
-WorkSpace::WorkSpace(QWidget *parent) : QDialog(parent)
+/// Maximalni pocet radku v textovem poli pro vysledky (starsi radky se zahazuji).
+static const int maxLogRows = 2000;
+
+/// Interval davkoveho vypisu mezivysledku [ms].
+static const int logFlushInterval = 500;
+
+WorkSpace::WorkSpace(QWidget *parent) : QDialog(parent), metricsServer(&tspEvolution)
 {
     // Ziskani zadanych parametru z prikazoveho radku
     QStringList arguments = QCoreApplication::arguments();
@@ -9,7 +15,7 @@ WorkSpace::WorkSpace(QWidget *parent) : QDialog(parent)
     qRegisterMetaType<tIndividual>("tIndividual");
 
     // Globalni nastaveni aplikace
-    setFixedSize(818, 435);
+    setFixedSize(818, 570);
     setFont(QFont("Helvetica", 9, QFont::Normal));
     setWindowTitle(tr("TSP a analyza kvality optimalizace"));
 
@@ -59,12 +65,15 @@ WorkSpace::WorkSpace(QWidget *parent) : QDialog(parent)
     tMutationTypeComboBox->addItem("SWAP");
     tMutationTypeComboBox->addItem("2-OPT");
     tMutationTypeComboBox->addItem("3-OPT");
+    tMutationTypeComboBox->addItem("INVERSION");
+    tMutationTypeComboBox->addItem("ADAPTIVNI");
     tMutationTypeComboBox->setGeometry(215, 160, 110, 25);
     tCrossoverTypeComboBox = new QComboBox(this);
     tCrossoverTypeComboBox->addItem("PMX");
     tCrossoverTypeComboBox->addItem("ERX");
     tCrossoverTypeComboBox->addItem("OX");
     tCrossoverTypeComboBox->addItem("CX");
+    tCrossoverTypeComboBox->addItem("ADAPTIVNI");
     tCrossoverTypeComboBox->setGeometry(215, 190, 110, 25);
     sTournamentStepLine = new QSpinBox(this);
     sTournamentStepLine->setRange(1, (INT_MAX - 1));
@@ -104,8 +113,12 @@ WorkSpace::WorkSpace(QWidget *parent) : QDialog(parent)
     resultTextBox->setGeometry(10, 345, 796, 80);
     resultTextBox->setFont(QFont("Courier New", 8, QFont::Normal));
     resultTextBox->setReadOnly(true);
+    resultTextBox->setMaximumBlockCount(maxLogRows);
+    chartWidget = new ChartWidget(this);
+    chartWidget->setGeometry(10, 432, 796, 130);
     mapWidget = new MapWidget(this);
     mapWidget->setGeometry(355, 40, 449, 264);
+    mapWidget->SetPathChannel(tspEvolution.GetBestPathChannel());
 
     // Nastaveni slotu a signalu
     connect(loadTaskButton, SIGNAL(clicked()), this, SLOT(SetOpenFileName()));
@@ -121,8 +134,12 @@ WorkSpace::WorkSpace(QWidget *parent) : QDialog(parent)
     connect(sElitismStepLine, SIGNAL(valueChanged(int)), this, SLOT(ChangeSElitism(int)));
     connect(sTournamentStepLine, SIGNAL(valueChanged(int)), this, SLOT(ChangeSTournament(int)));
     connect(logIntervalStepLine, SIGNAL(valueChanged(int)), this, SLOT(ChangeLogInterval(int)));
-    connect(&tspEvolution, SIGNAL(CurrentPathGenerated(tIndividual, int, float, float, float)), this, SLOT(ReceiveCurrentPathGenerated(tIndividual, int, float, float, float)));
+    connect(&tspEvolution, SIGNAL(CurrentPathGenerated(int, double, double, double)), this, SLOT(ReceiveCurrentPathGenerated(int, double, double, double)));
     connect(&tspEvolution, SIGNAL(PathGenerated(tIndividual)), this, SLOT(ReceivePathGenerated(tIndividual)));
+    connect(&tspEvolution, SIGNAL(EvolutionAborted(tIndividual)), this, SLOT(ReceiveEvolutionAborted(tIndividual)));
+    connect(&problemLoader, SIGNAL(LoadProgress(int)), this, SLOT(ReceiveLoadProgress(int)));
+    connect(&problemLoader, SIGNAL(ProblemLoaded(bool)), this, SLOT(ReceiveProblemLoaded(bool)));
+    logTimerId = startTimer(logFlushInterval);
 
     // Zpracovani parametru prikazove radky
     if(arguments.size() == 2)
@@ -132,22 +149,13 @@ WorkSpace::WorkSpace(QWidget *parent) : QDialog(parent)
         Config::GetInstance()->LoadConfiguration(configFile);
 
         // Nacteni konkretni ulohy
-        if(LoadData())
-        {
-            mapWidget->SetNewMap(cityPosition);
-            evolutionProgressBar->setValue(evolutionProgressBar->minimum());
-            evoluteStartButton->setEnabled(true);
-            evoluteStopButton->setText("Pozastavit");
-            update();
-        }
-        else
-        {
-            evoluteStartButton->setEnabled(false);
-            QMessageBox *error = new QMessageBox(QMessageBox::Critical, tr("Chyba"), tr("Vstupni soubor nelze nalezt nebo neobsahuje pozadovane udaje."), QMessageBox::Ok, this, Qt::Widget);
-            error->show();
-        }
+        LoadData();
     }
 
+    // Spusteni exportu prubeznych metrik
+    if(Config::GetInstance()->metricsPort > 0 || !Config::GetInstance()->metricsSocket.empty())
+        metricsServer.Listen(Config::GetInstance()->metricsPort, Config::GetInstance()->metricsSocket);
+
     // Nastaveni hodnot ovladacich prvku
     sPopulationStepLine->setValue(Config::GetInstance()->sPopulation);
     nGenerationsStepLine->setValue(Config::GetInstance()->nGenerations);
@@ -159,86 +167,42 @@ WorkSpace::WorkSpace(QWidget *parent) : QDialog(parent)
     tMutationTypeComboBox->setCurrentIndex(Config::GetInstance()->tMutation);
 }
 
-bool WorkSpace::LoadData()
+void WorkSpace::LoadData()
 {
-    cityPosition.clear();
-    cityMatrix.clear();
-
-    unsigned cutAt, actCityIndex;
-    bool nodeCoordSection = false;
-    string line, paramName, paramValue;
-    ifstream file(Config::GetInstance()->problemFile.c_str());
-
-    if(!file.good())
-    {
-        cerr << "Chyba! Vstupni soubor s daty nelze otevrit." << endl;
-        exit(1);
-    }
+    // Behem nacitani nelze spustit evoluci ani nacitat jinou ulohu
+    loadTaskButton->setEnabled(false);
+    evoluteStartButton->setEnabled(false);
+    evolutionProgressBar->setMaximum(100);
+    evolutionProgressBar->setValue(evolutionProgressBar->minimum());
 
-    // Ziskani parametru evoluce a ziskani souradnic mest
-    while(getline(file, line))
-    {
-        if(line.find("EOF") != line.npos)
-        {   // ukonceni nacitani, je-li na radku "EOF" (nektere soubory formatu TSPLib tak cini)
-            break;
-        }
-        else if(line.find("NODE_COORD_SECTION") != line.npos)
-        {   // zacatek sekce s vyznacenim souradnic mest
-            nodeCoordSection = true;
-            continue;
-        }
-        else if(nodeCoordSection)
-        {   // parsovani souradnic mest
-            actCityIndex = atoi(line.substr(0, line.find_first_of(" ")).c_str());
-            line.erase(0, line.find_first_of(" ") + 1);
-            cityPosition[actCityIndex - 1].x = atoi(line.substr(0, line.find_first_of(" ")).c_str());
-            line.erase(0, line.find_first_of(" ") + 1);
-            cityPosition[actCityIndex - 1].y = atoi(line.substr(0, line.find_first_of(" ")).c_str());
-            continue;
-        }
-        else if((cutAt = line.find_first_of(":")) == line.npos)
-        {   // neplatny radek konfiguracniho souboru
-            continue;
-        }
+    // Nacteni ulohy (textovy format TSPLIB nebo binarni format namapovany do pameti) na pozadi
+    problemLoader.Load(Config::GetInstance()->problemFile);
+}
 
-        paramName = line.substr(0, cutAt);
-        paramValue = line.substr(cutAt + 1);
-        StringTrim(paramName);
-        StringTrim(paramValue);
+void WorkSpace::ReceiveLoadProgress(int percent)
+{
+    evolutionProgressBar->setValue(percent);
+}
 
-        if(paramName.find("NAME") != paramName.npos)
-            info.name = paramValue;
-        else if(paramName.find("COMMENT") != paramName.npos)
-            info.comment = paramValue;
-        else if(paramName.find("DIMENSION") != paramName.npos)
-        {
-            info.dimension = atoi(paramValue.c_str());
-
-            // Vytvoreni pole souradnic pozice mest na mape
-            cityPosition.resize(info.dimension);
-
-            // Vytvoreni matice propojeni mest
-            for(int i = 0; i < info.dimension; i++)
-            {
-                CityMatrixRow row;
-                row.resize(info.dimension);
-                cityMatrix.push_back(row);
-            }
-        }
-    }
+void WorkSpace::ReceiveProblemLoaded(bool success)
+{
+    problemLoader.wait();
+    loadTaskButton->setEnabled(true);
+    evolutionProgressBar->setValue(evolutionProgressBar->minimum());
 
-    // Vypocet vzajemnych vzdalenosti mest
-    float dX, dY;
-    for(int i = 0; i < info.dimension; i++)
+    if(!success)
     {
-        for(int j = 0; j < info.dimension; j++)
-        {
-            dX = cityPosition[i].x - cityPosition[j].x;
-            dY = cityPosition[i].y - cityPosition[j].y;
-            cityMatrix[i][j] = sqrt(dX * dX + dY * dY);
-        }
+        evoluteStartButton->setEnabled(false);
+        QMessageBox *error = new QMessageBox(QMessageBox::Critical, tr("Chyba"), tr("Vstupni soubor nelze nalezt nebo neobsahuje pozadovane udaje."), QMessageBox::Ok, this, Qt::Widget);
+        error->show();
+        return;
     }
-    file.close();
+
+    // Prevzeti nactenych dat (matice se nekopiruje, kopie sdileji pamet)
+    info = problemLoader.info;
+    cityPosition = problemLoader.cityPosition;
+    cityMatrix = problemLoader.cityMatrix;
+    cityNeighbours = problemLoader.cityNeighbours;
 
     // Vlozeni informaci ziskanych ze souboru do resultBoxu
 
@@ -252,7 +216,10 @@ bool WorkSpace::LoadData()
     QString qHeader(header.c_str());
     resultTextBox->appendHtml(qHeader);
 
-    return true;
+    mapWidget->SetNewMap(cityPosition);
+    evoluteStartButton->setEnabled(true);
+    evoluteStopButton->setText("Pozastavit");
+    update();
 }
 
 void WorkSpace::paintEvent(QPaintEvent *)
@@ -276,19 +243,7 @@ void WorkSpace::SetOpenFileName()
 
         Config::GetInstance()->problemFile = fileName.toStdString();
         resultTextBox->clear();
-        if(LoadData())
-        {
-            mapWidget->SetNewMap(cityPosition);
-            evolutionProgressBar->setValue(evolutionProgressBar->minimum());
-            evoluteStartButton->setEnabled(true);
-            evoluteStopButton->setText("Pozastavit");
-            update();
-        }
-        else
-        {
-            QMessageBox *error = new QMessageBox(QMessageBox::Critical, tr("Chyba"), tr("Vstupni soubor nelze nalezt nebo neobsahuje pozadovane udaje."), QMessageBox::Ok, this, Qt::Widget);
-            error->show();
-        }
+        LoadData();
     }
 }
 
@@ -328,10 +283,12 @@ void WorkSpace::StartEvolution()
     evolutionProgressBar->setMaximum(Config::GetInstance()->nGenerations);
 
     // Spusteni evoluce
-    tspEvolution.FindSolution(cityMatrix, info);
+    tspEvolution.FindSolution(cityMatrix, cityPosition, cityNeighbours, info);
 
     resultTextBox->appendHtml(QString("<strong>_______________________________________________</strong>"));
     resultTextBox->appendHtml(QString("<strong>Mezivysledky (actGeneration, Min, Avg, Max</strong>)"));
+    pendingRows.clear();
+    chartWidget->Clear();
 
     mapWidget->StartTimer();
 }
@@ -354,44 +311,16 @@ void WorkSpace::StopEvolution()
 
 void WorkSpace::AbortEvolution()
 {
-    tspEvolution.AbortEvolution();    // Pokyn k zastaveni evoluce
-
-    // Vypis nalezene trasy a jeji ceny do textoveho pole pro vysledky
-    resultTextBox->appendHtml(QString("<strong>_______________________________________________</strong>"));
-    string path = "<strong>Vysledna trasa: </strong>";
-    for(int i = 0; i < (int)resultPath.genome.size(); i++)
-    {
-        stringstream out;
-        out << resultPath.genome[i];
-        path += out.str() + " ";
-    }
-    QString qPath(path.c_str());
-    resultTextBox->appendHtml(qPath);
-
-    string price = "<strong>Cena vysledne trasy: </strong>";
-    stringstream out;
-    out << resultPath.price;
-    price += out.str();
-    QString qPrice(price.c_str());
-    resultTextBox->appendHtml(qPrice);
-
-    // Odemknuti ovladacich prvku
-    loadTaskButton->setEnabled(true);
-    evoluteStartButton->setEnabled(true);
+    // Do dokonceni preruseni (ReceiveEvolutionAborted) nelze vypocet ovladat
     evoluteStopButton->setEnabled(false);
     evoluteAbortButton->setEnabled(false);
-    saveResultButton->setEnabled(true);
-    evoluteStopButton->setText(QString("Pozastavit"));
-    tCrossoverTypeComboBox->setEnabled(true);
-    tMutationTypeComboBox->setEnabled(true);
-    sPopulationStepLine->setEnabled(true);
-    nGenerationsStepLine->setEnabled(true);
-    sTournamentStepLine->setEnabled(true);
-    sElitismStepLine->setEnabled(true);
-    logIntervalStepLine->setEnabled(true);
-    pMutationDoubleSpinBox->setEnabled(true);
 
-    mapWidget->KillTimer(true);
+    tspEvolution.AbortEvolution();    // Pokyn k zastaveni evoluce (neceka na dobehnuti vypoctu)
+}
+
+void WorkSpace::ReceiveEvolutionAborted(tIndividual resultPath)
+{
+    ShowResult(resultPath, false);
 }
 
 void WorkSpace::ChangeSPopulation(int newValue)
@@ -434,30 +363,57 @@ void WorkSpace::ChangeLogInterval(int newValue)
     Config::GetInstance()->logInterval = newValue;
 }
 
-void WorkSpace::ReceiveCurrentPathGenerated(tIndividual resultPath, int actGeneration, float minCurrentPathPrice, float avgCurrentPathPrice, float maxCurrentPathPrice)
+void WorkSpace::ReceiveCurrentPathGenerated(int actGeneration, double minCurrentPathPrice, double avgCurrentPathPrice, double maxCurrentPathPrice)
 {
-    mapWidget->SetBestIndividual(resultPath);
-
-    this->resultPath = resultPath;
+    // Mezivysledek (minimalni, prumerna a maximalni cena v ramci dane generace) se zaradi k davkovemu vypisu
+    QString row = QString("%1    %2    %3    %4").arg(actGeneration).arg(minCurrentPathPrice, 0, 'f', 4)
+                      .arg(avgCurrentPathPrice, 0, 'f', 4).arg(maxCurrentPathPrice, 0, 'f', 4);
+    if(pendingRows.size() >= maxLogRows)
+        pendingRows.removeFirst();
+    pendingRows.append(row);
+
+    // Pri samoadaptaci se v (zamcenych) ovladacich prvcich zobrazuji efektivni hodnoty parametru
+    if(Config::GetInstance()->selfAdaptive)
+    {
+        tMetrics metrics = tspEvolution.GetMetrics();
+        pMutationDoubleSpinBox->blockSignals(true);
+        pMutationDoubleSpinBox->setValue(metrics.mutationRate);
+        pMutationDoubleSpinBox->blockSignals(false);
+        sTournamentStepLine->blockSignals(true);
+        sTournamentStepLine->setValue(metrics.tournamentSize);
+        sTournamentStepLine->blockSignals(false);
+    }
 
-    // Vypis mezivysledku (minimalni, prumerna a maximalni cena v ramci dane generace) do textoveho pole pro vysledky
-    stringstream out1, out2, out3, out4;
-    out1 << std::fixed << std::setprecision(4) << actGeneration;
-    out2 << std::fixed << std::setprecision(4) << minCurrentPathPrice;
-    out3 << std::fixed << std::setprecision(4) << avgCurrentPathPrice;
-    out4 << std::fixed << std::setprecision(4) << maxCurrentPathPrice;
-    string row = out1.str() + "&nbsp;&nbsp;&nbsp;&nbsp;" + out2.str() + "&nbsp;&nbsp;&nbsp;&nbsp;" + out3.str() + "&nbsp;&nbsp;&nbsp;&nbsp;" + out4.str();
-    QString qRow(row.c_str());
-    resultTextBox->appendHtml(qRow);
+    chartWidget->AddPoint(actGeneration, minCurrentPathPrice, avgCurrentPathPrice, maxCurrentPathPrice);
 
     evolutionProgressBar->setValue(actGeneration);
 }
 
+void WorkSpace::timerEvent(QTimerEvent *)
+{
+    FlushLog();
+}
+
+void WorkSpace::FlushLog()
+{
+    if(!pendingRows.isEmpty())
+    {
+        resultTextBox->appendPlainText(pendingRows.join("\n"));
+        pendingRows.clear();
+    }
+    chartWidget->Refresh();
+}
+
 void WorkSpace::ReceivePathGenerated(tIndividual resultPath)
 {
-    this->resultPath = resultPath;
+    ShowResult(resultPath, true);
+}
 
+void WorkSpace::ShowResult(const tIndividual &resultPath, bool finished)
+{
+    this->resultPath = resultPath;
     mapWidget->SetBestIndividual(resultPath);
+    FlushLog();
 
     // Vypis nalezene trasy a jeji ceny do textoveho pole pro vysledky
     resultTextBox->appendHtml(QString("<strong>_______________________________________________</strong>"));
@@ -465,7 +421,7 @@ void WorkSpace::ReceivePathGenerated(tIndividual resultPath)
     for(int i = 0; i < (int)resultPath.genome.size(); i++)
     {
         stringstream out;
-        out << resultPath.genome[i];
+        out << OriginalCityId(info, resultPath.genome[i]);
         path += out.str() + " ";
     }
     QString qPath(path.c_str());
@@ -473,18 +429,37 @@ void WorkSpace::ReceivePathGenerated(tIndividual resultPath)
 
     string price = "<strong>Cena vysledne trasy: </strong>";
     stringstream out;
-    out << resultPath.price;
+    out << std::setprecision(15) << resultPath.price;
     price += out.str();
     QString qPrice(price.c_str());
     resultTextBox->appendHtml(qPrice);
+    if(finished)
+        resultTextBox->appendHtml(QString("<strong>Duvod ukonceni: </strong>") + QString(TSPEvolution::TerminationName(tspEvolution.GetTermination())));
 
-    // Odemknuti / zamknuti ovladacich prvku
+    // Vypis doby behu jednotlivych fazi evolucniho kroku
+    if(Config::GetInstance()->profiling || Config::GetInstance()->perfCounters)
+    {
+        resultTextBox->appendHtml(QString("<strong>Doba behu fazi (celkem, podil, prumer / posledni / maximum na generaci):</strong>"));
+        resultTextBox->appendPlainText(QString(tspEvolution.GetPhaseReport().c_str()));
+    }
+
+    // Odemknuti ovladacich prvku
     loadTaskButton->setEnabled(true);
     evoluteStartButton->setEnabled(true);
     evoluteStopButton->setEnabled(false);
     evoluteAbortButton->setEnabled(false);
     saveResultButton->setEnabled(true);
     evoluteStopButton->setText(QString("Pozastavit"));
+    tCrossoverTypeComboBox->setEnabled(true);
+    tMutationTypeComboBox->setEnabled(true);
+    sPopulationStepLine->setEnabled(true);
+    nGenerationsStepLine->setEnabled(true);
+    sTournamentStepLine->setEnabled(true);
+    sElitismStepLine->setEnabled(true);
+    logIntervalStepLine->setEnabled(true);
+    pMutationDoubleSpinBox->setEnabled(true);
+    pMutationDoubleSpinBox->setValue(Config::GetInstance()->pMutation);
+    sTournamentStepLine->setValue(Config::GetInstance()->sTournament);
 
     mapWidget->KillTimer(true);
 }
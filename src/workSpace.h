@@ -20,6 +20,10 @@
 #include "tsp_evolution.h"
 #include "config.h"
 #include "mapWidget.h"
+#include "chartWidget.h"
+#include "metricsServer.h"
+#include "tspLoader.h"
+#include "problemLoader.h"
 
 /// Spravce hlavniho okna.
 class WorkSpace : public QDialog
@@ -28,12 +32,18 @@ class WorkSpace : public QDialog
 
     private:
     tProblemInfo info;                   ///< Informace o resenem problemu.
-    vector<CityMatrixRow> cityMatrix;    ///< Matice spojeni mest.
+    CityMatrix cityMatrix;               ///< Matice spojeni mest.
+    CityNeighbours cityNeighbours;       ///< Seznamy nejblizsich sousedu (jsou-li ulozeny v binarnim souboru ulohy).
     vector<CityPosition> cityPosition;   ///< Pozice mest na mape.
     TSPEvolution tspEvolution;           ///< Spravce procesu evoluce trasy obchodniho cestujiciho.
+    MetricsServer metricsServer;         ///< Export prubeznych metrik vypoctu.
+    ProblemLoader problemLoader;         ///< Nacitani ulohy na pozadi.
     tIndividual resultPath;              ///< Vysledny jedinec reprezentujici nejlepsi nalezene reseni.
 
     MapWidget *mapWidget;                ///< Mrizka pro zobrazeni zygoty
+    ChartWidget *chartWidget;            ///< Graf konvergence vypoctu.
+    QStringList pendingRows;             ///< Radky mezivysledku cekajici na vypis (nejvyse maxLogRows nejnovejsich).
+    int logTimerId;                      ///< ID casovace davkoveho vypisu mezivysledku.
 
     QLabel *taskNameLabel;
     QLabel *projectStatus;
@@ -60,12 +70,26 @@ class WorkSpace : public QDialog
 
     protected:
     void paintEvent(QPaintEvent *);
+    void timerEvent(QTimerEvent *);
 
     /**
-     * Nacte ze souboru udaje o poloze jednotlivych mest.
-     * @return Urcuje, zda-li  se podarilo data nacist.
+     * Vypise cekajici radky mezivysledku (jednim volanim) a prekresli graf.
      */
-    bool LoadData();
+    void FlushLog();
+
+    /**
+     * Vypise nejlepsi nalezenou trasu a doby behu fazi a odemkne ovladaci prvky (po dokonceni
+     * i po preruseni vypoctu).
+     * @param resultPath Nejlepsi nalezene reseni.
+     * @param finished Udava, zda-li vypocet skoncil splnenim podminky ukonceni (vypise se jeji duvod).
+     */
+    void ShowResult(const tIndividual &resultPath, bool finished);
+
+    /**
+     * Spusti nacitani udaju o poloze jednotlivych mest ze souboru (na pozadi, vysledek
+     * prijme ReceiveProblemLoaded).
+     */
+    void LoadData();
 
     private slots:
     /**
@@ -143,13 +167,12 @@ class WorkSpace : public QDialog
 
     /**
     * Prijme informaci o aktualnim stavu evolucniho vypoctu.
-    * @param resultPath Nejlepsi reseni nalezene v aktualnim evolucnim kroku.
     * @param actGeneration Cislo aktualni generace.
     * @param minCurrentPathPrice Nejlepsi cena reseni v aktualnim evolucnim kroku.
     * @param avgCurrentPathPrice Prumerna cena reseni v aktualnim evolucnim kroku.
     * @param maxCurrentPathPrice Nejhorsi cena reseni v aktualnim evolucnim kroku.
     */
-    void ReceiveCurrentPathGenerated(tIndividual resultPath, int actGeneration, float minCurrentPathPrice, float avgCurrentPathPrice, float maxCurrentPathPrice);
+    void ReceiveCurrentPathGenerated(int actGeneration, double minCurrentPathPrice, double avgCurrentPathPrice, double maxCurrentPathPrice);
 
     /**
     * Prijme informaci o stavu dokonceneho evolucniho vypoctu.
@@ -159,6 +182,24 @@ class WorkSpace : public QDialog
     */
     void ReceivePathGenerated(tIndividual resultPath);
 
+    /**
+    * Prijme informaci o dokonceni preruseneho evolucniho vypoctu.
+    * @param resultPath Nejlepsi reseni nalezene do preruseni vypoctu.
+    */
+    void ReceiveEvolutionAborted(tIndividual resultPath);
+
+    /**
+    * Prijme informaci o postupu nacitani ulohy.
+    * @param percent Postup v procentech.
+    */
+    void ReceiveLoadProgress(int percent);
+
+    /**
+    * Prevezme nactenou ulohu a zobrazi ji.
+    * @param success Urcuje, zda-li se ulohu podarilo nacist.
+    */
+    void ReceiveProblemLoaded(bool success);
+
     public:
     /**
     * Konstruktor.